@@ -0,0 +1,46 @@
+/*
+ * Measures building AdjacencyArrayEdges from an edge file with different thread counts.
+ *
+ * usage: CsrBuildBenchmark [edgesFile]
+ */
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AdjacencyArrayEdges.hpp"
+#include "Parallel.hpp"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    string edgesFile = argc > 1 ? argv[1] : "../input/twitch/twitch_edges.txt";
+
+    vector<pair<int, int>> edgeList;
+    ifstream edgesStream(edgesFile);
+    int source, destination;
+    while (edgesStream >> source >> destination)
+    {
+        edgeList.emplace_back(source, destination);
+    }
+    if (edgeList.empty())
+    {
+        cerr << "No edges read from " << edgesFile << endl;
+        return 1;
+    }
+    cout << "Read " << edgeList.size() << " edges from " << edgesFile << endl;
+
+    for (unsigned threads = 1; threads <= defaultThreadCount(); threads *= 2)
+    {
+        AdjacencyArrayEdges edges(edgeList, CsrBuildOptions{threads, false});
+        const CsrBuildStats &stats = edges.getBuildStats();
+
+        cout << "threads: " << threads
+             << "\tbuild: " << stats.buildSeconds * 1000 << " ms"
+             << "\tpeak: " << stats.peakBytes / (1024.0 * 1024.0) << " MiB"
+             << "\tduplicates removed: " << stats.removedDuplicates << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Compares memory and access throughput of the edge backends on an edge file.
+ * BasicEdges scans its whole edge list per query and is skipped for large inputs.
+ *
+ * usage: EdgeBackendBenchmark [edgesFile ...]
+ */
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AdjacencyArrayEdges.hpp"
+#include "BasicEdges.hpp"
+#include "CompressedAdjacencyEdges.hpp"
+
+using namespace std;
+
+const size_t BASIC_EDGES_LIMIT = 100000;
+const size_t EDGE_QUERIES = 1000000;
+
+template <typename Edges>
+void measure(const string &name, Edges &edges, int maxNodeId, const vector<pair<int, int>> &queries)
+{
+    auto start = chrono::steady_clock::now();
+    long checksum = 0;
+    size_t visited = 0;
+    for (int node = 0; node <= maxNodeId; node++)
+    {
+        for (int neighbor : edges.neighbors(node))
+        {
+            checksum += neighbor;
+            visited++;
+        }
+    }
+    double scanSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    size_t hits = 0;
+    for (auto [source, destination] : queries)
+    {
+        hits += edges.isEdge(source, destination);
+    }
+    double querySeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << name
+         << "\tmemory: " << edges.memoryUsage() / (1024.0 * 1024.0) << " MiB"
+         << "\tscan: " << visited / scanSeconds / 1e6 << " M neighbors/s"
+         << "\tisEdge: " << queries.size() / querySeconds / 1e6 << " M queries/s"
+         << "\t(checksum " << checksum << ", hits " << hits << ")" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    vector<string> edgeFiles;
+    for (int i = 1; i < argc; i++)
+    {
+        edgeFiles.push_back(argv[i]);
+    }
+    if (edgeFiles.empty())
+    {
+        edgeFiles = {"../input/cornell/cornell_edges.txt", "../input/twitch/twitch_edges.txt"};
+    }
+
+    for (const string &edgesFile : edgeFiles)
+    {
+        vector<pair<int, int>> edgeList;
+        ifstream edgesStream(edgesFile);
+        int source, destination, maxNodeId = 0;
+        while (edgesStream >> source >> destination)
+        {
+            edgeList.emplace_back(source, destination);
+            maxNodeId = max(maxNodeId, max(source, destination));
+        }
+        if (edgeList.empty())
+        {
+            cerr << "No edges read from " << edgesFile << endl;
+            continue;
+        }
+        cout << edgesFile << ": " << edgeList.size() << " edges, " << maxNodeId + 1 << " node IDs" << endl;
+
+        // half of the queries are existing edges, half are random pairs
+        mt19937 generator(42);
+        uniform_int_distribution<size_t> edgeDistribution(0, edgeList.size() - 1);
+        uniform_int_distribution<int> nodeDistribution(0, maxNodeId);
+        vector<pair<int, int>> queries(EDGE_QUERIES);
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            queries[i] = i % 2 ? edgeList[edgeDistribution(generator)] : make_pair(nodeDistribution(generator), nodeDistribution(generator));
+        }
+
+        if (edgeList.size() <= BASIC_EDGES_LIMIT)
+        {
+            BasicEdges basic(edgeList);
+            vector<pair<int, int>> basicQueries(queries.begin(), queries.begin() + min<size_t>(queries.size(), 10000));
+            measure("BasicEdges\t", basic, maxNodeId, basicQueries);
+        }
+
+        AdjacencyArrayEdges adjacencyArray(edgeList);
+        measure("AdjacencyArrayEdges", adjacencyArray, maxNodeId, queries);
+
+        CompressedAdjacencyEdges compressed(adjacencyArray);
+        measure("CompressedAdjacencyEdges", compressed, maxNodeId, queries);
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Converts an edge file into a CSR file with ExternalCsrBuilder and compares a few memory budgets.
+ * The file of the last run is kept and can be passed to Graph in place of the edge file.
+ *
+ * usage: ExternalCsrBenchmark [edgesFile [csrFile [budgetMiB]]]
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ExternalCsrBuilder.hpp"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    string edgesFile = argc > 1 ? argv[1] : "../input/twitch/twitch_edges.txt";
+    string csrFile = argc > 2 ? argv[2] : "twitch_edges.graph";
+
+    vector<size_t> budgets = {1, 4, 16, 64};
+    if (argc > 3)
+    {
+        budgets = {stoul(argv[3])};
+    }
+
+    for (size_t budget : budgets)
+    {
+        ExternalCsrOptions options;
+        options.memoryBudget = budget << 20;
+
+        ExternalCsrStats stats;
+        try
+        {
+            stats = ExternalCsrBuilder(options).build(edgesFile, csrFile);
+        }
+        catch (const exception &error)
+        {
+            cerr << error.what() << endl;
+            return 1;
+        }
+
+        cout << "budget: " << budget << " MiB"
+             << "\tbuild: " << stats.buildSeconds * 1000 << " ms"
+             << "\tpeak: " << stats.peakBytes / (1024.0 * 1024.0) << " MiB"
+             << "\truns: " << stats.runs
+             << "\tedges: " << stats.edgesRead
+             << "\tentries: " << stats.adjacencyEntries << endl;
+    }
+    cout << "Wrote " << csrFile << endl;
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Compares random walk and BFS throughput through the virtual edge interface of Graph,
+ * through CsrGraph and through Graph::visitEdges, which both call AdjacencyArrayEdges without virtual calls.
+ * The traversals only touch the adjacency lists, so the difference is the cost of the calls.
+ *
+ * usage: GraphTraversalBenchmark [nodesFile edgesFile]
+ */
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Graph.hpp"
+
+using namespace std;
+
+const int WALK_LENGTH = 40;
+const int WALKS_PER_NODE = 5;
+const int BFS_SOURCES = 50;
+
+template <typename Edges>
+double walkFromEveryNode(const Edges &edges, const vector<int> &nodes, long &checksum)
+{
+    mt19937 generator(42);
+    size_t steps = 0;
+    auto start = chrono::steady_clock::now();
+
+    for (int walk = 0; walk < WALKS_PER_NODE; walk++)
+    {
+        for (int startNode : nodes)
+        {
+            int current = startNode;
+            for (int step = 0; step < WALK_LENGTH; step++)
+            {
+                Span<const int> adjacents = edges.neighbors(current);
+                if (adjacents.empty())
+                {
+                    break;
+                }
+                current = adjacents[generator() % adjacents.size()];
+                checksum += current;
+                steps++;
+            }
+        }
+    }
+
+    return steps / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Edges>
+double bfsFromSources(const Edges &edges, const vector<int> &sources, long &checksum)
+{
+    size_t visitedCount = 0;
+    vector<int> queue;
+    vector<char> visited;
+    auto start = chrono::steady_clock::now();
+
+    for (int source : sources)
+    {
+        queue.assign(1, source);
+        visited.assign(0, false);
+
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            for (int neighbor : edges.neighbors(queue[head]))
+            {
+                if (static_cast<size_t>(neighbor) >= visited.size())
+                {
+                    visited.resize(neighbor + 1, false);
+                }
+                if (!visited[neighbor])
+                {
+                    visited[neighbor] = true;
+                    queue.push_back(neighbor);
+                    checksum += neighbor;
+                }
+            }
+        }
+        visitedCount += queue.size();
+    }
+
+    return visitedCount / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Edges>
+void measure(const string &name, const Edges &edges, const vector<int> &nodes, const vector<int> &sources)
+{
+    long checksum = 0;
+    double walkSteps = walkFromEveryNode(edges, nodes, checksum);
+    double bfsNodes = bfsFromSources(edges, sources, checksum);
+
+    cout << name
+         << "\twalk: " << walkSteps / 1e6 << " M steps/s"
+         << "\tBFS: " << bfsNodes / 1e6 << " M nodes/s"
+         << "\t(checksum " << checksum << ")" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    string nodesFile = argc > 2 ? argv[1] : "../input/twitch/twitch_features.txt";
+    string edgesFile = argc > 2 ? argv[2] : "../input/twitch/twitch_edges.txt";
+
+    Graph graph(nodesFile, edgesFile);
+    CsrGraph csrGraph(nodesFile, edgesFile);
+    if (graph.getNodeCount() == 0)
+    {
+        cerr << "No nodes read from " << nodesFile << endl;
+        return 1;
+    }
+    cout << edgesFile << ": " << graph.getEdgeCount() << " edges, " << graph.getNodeCount() << " nodes" << endl;
+
+    vector<int> nodes = graph.getNodes();
+    vector<int> sources;
+    mt19937 generator(7);
+    for (int i = 0; i < BFS_SOURCES; i++)
+    {
+        sources.push_back(nodes[uniform_int_distribution<size_t>(0, nodes.size() - 1)(generator)]);
+    }
+
+    measure("Graph (virtual)", graph, nodes, sources);
+    measure("CsrGraph\t", csrGraph, nodes, sources);
+    graph.visitEdges([&](const auto &edges) { measure("Graph::visitEdges", edges, nodes, sources); });
+
+    return 0;
+}
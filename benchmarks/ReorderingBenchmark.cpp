@@ -0,0 +1,126 @@
+/*
+ * Measures random walk and BFS throughput of a graph loaded in each node order.
+ * Both traversals read the feature row of every node they visit, like the strategies do.
+ *
+ * usage: ReorderingBenchmark [nodesFile edgesFile]
+ */
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Graph.hpp"
+
+using namespace std;
+
+const int WALK_LENGTH = 40;
+const int BFS_SOURCES = 50;
+
+double walkFromEveryNode(const Graph &graph, double &checksum)
+{
+    mt19937 generator(42);
+    size_t steps = 0;
+    auto start = chrono::steady_clock::now();
+
+    for (int startNode : graph.getNodes())
+    {
+        int current = startNode;
+        for (int step = 0; step < WALK_LENGTH; step++)
+        {
+            Span<const int> adjacents = graph.neighbors(current);
+            if (adjacents.empty())
+            {
+                break;
+            }
+            current = adjacents[uniform_int_distribution<size_t>(0, adjacents.size() - 1)(generator)];
+            Span<const double> features = graph.featureRowById(current);
+            checksum += features.empty() || isnan(features[0]) ? 0.0 : features[0];
+            steps++;
+        }
+    }
+
+    return steps / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+double bfsFromSources(const Graph &graph, const vector<int> &originalSources, double &checksum)
+{
+    size_t visitedCount = 0;
+    vector<int> queue;
+    vector<char> visited;
+    auto start = chrono::steady_clock::now();
+
+    for (int originalSource : originalSources)
+    {
+        int source = graph.getInternalId(originalSource);
+        queue.assign(1, source);
+        visited.assign(0, false);
+
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            for (int neighbor : graph.neighbors(queue[head]))
+            {
+                if (static_cast<size_t>(neighbor) >= visited.size())
+                {
+                    visited.resize(neighbor + 1, false);
+                }
+                if (!visited[neighbor])
+                {
+                    visited[neighbor] = true;
+                    queue.push_back(neighbor);
+                    Span<const double> features = graph.featureRowById(neighbor);
+                    checksum += features.empty() || isnan(features[0]) ? 0.0 : features[0];
+                }
+            }
+        }
+        visitedCount += queue.size();
+    }
+
+    return visitedCount / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    string nodesFile = argc > 2 ? argv[1] : "../input/twitch/twitch_features.txt";
+    string edgesFile = argc > 2 ? argv[2] : "../input/twitch/twitch_edges.txt";
+
+    vector<int> originalSources;
+    const pair<NodeOrder, string> orders[] = {
+        {NodeOrder::Input, "input"}, {NodeOrder::Degree, "degree"}, {NodeOrder::RCM, "rcm"}, {NodeOrder::BFS, "bfs"}};
+
+    for (const auto &[order, name] : orders)
+    {
+        auto start = chrono::steady_clock::now();
+        Graph graph(nodesFile, edgesFile, order);
+        double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (graph.getNodeCount() == 0)
+        {
+            cerr << "No nodes read from " << nodesFile << endl;
+            return 1;
+        }
+
+        // the same sources in every order
+        if (originalSources.empty())
+        {
+            vector<int> nodes = graph.getNodes();
+            mt19937 generator(7);
+            for (int i = 0; i < BFS_SOURCES; i++)
+            {
+                originalSources.push_back(nodes[uniform_int_distribution<size_t>(0, nodes.size() - 1)(generator)]);
+            }
+        }
+
+        double checksum = 0.0;
+        double walkSteps = walkFromEveryNode(graph, checksum);
+        double bfsNodes = bfsFromSources(graph, originalSources, checksum);
+
+        cout << name
+             << "\tload: " << loadSeconds * 1000 << " ms"
+             << "\twalk: " << walkSteps / 1e6 << " M steps/s"
+             << "\tBFS: " << bfsNodes / 1e6 << " M nodes/s"
+             << "\t(checksum " << checksum << ")" << endl;
+    }
+
+    return 0;
+}
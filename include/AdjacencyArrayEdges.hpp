@@ -3,19 +3,31 @@
 
 #include "interfaces/IEdges.hpp"
 
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
 
-// custom defined hash for pairs as they are not naturally supported
-struct pair_hash
+/**
+ * Options for building the adjacency array from an edge list
+ */
+struct CsrBuildOptions
 {
-    template <class T1, class T2>
-    std::size_t operator()(const std::pair<T1, T2> &p) const
-    {
-        return std::hash<T1>()(p.first) ^ (std::hash<T2>()(p.second) << 1);
-    }
+    unsigned threads = 0;       ///< worker threads for counting, scattering and sorting. 0 uses all hardware threads
+    bool dropSelfLoops = false; ///< whether edges (v, v) are left out. Otherwise they are stored once in the list of v
+};
+
+/**
+ * Measurements of the last adjacency array build
+ */
+struct CsrBuildStats
+{
+    double buildSeconds = 0.0;     ///< wall clock time of the whole build
+    size_t peakBytes = 0;          ///< peak size of the buffers allocated by the build, excluding the input edge list
+    size_t droppedSelfLoops = 0;   ///< self-loops left out because of CsrBuildOptions::dropSelfLoops
+    size_t removedDuplicates = 0;  ///< adjacency entries removed because the edge was listed more than once
+    size_t skippedInvalidEdges = 0; ///< edges with negative node IDs
 };
 
-class AdjacencyArrayEdges : public IEdges
+class AdjacencyArrayEdges final : public IEdges
 {
 public:
     /**
@@ -26,9 +38,27 @@ public:
     /**
      * Constructor from a List of Edges
      *
+     * The adjacency array is built in place by counting degrees, a prefix sum over them and
+     * scattering the edges into their lists, followed by sorting and deduplicating each list.
+     * All passes except the prefix sum run on multiple threads.
+     *
+     * An edge listed more than once, in either direction, is stored once. A self-loop (v, v)
+     * is a single entry v in the list of v, unless options drops it.
+     *
      * @param initialEdges Pointer to the List of Edges
+     * @param options how to build the adjacency array
+     */
+    AdjacencyArrayEdges(const std::vector<std::pair<int, int>> &initialEdges, const CsrBuildOptions &options = CsrBuildOptions());
+
+    /**
+     * Constructor from an already built adjacency array, e.g. a merged or deserialized one.
+     *
+     * @param offsets start of the list of each node in adjacency, with the total size as end marker
+     * @param adjacency concatenated adjacency lists, each one sorted ascending
+     * @param weights weights aligned with adjacency. If empty, all weights are NaN
+     * @throws invalid_argument if the end marker doesn't match the size of adjacency
      */
-    AdjacencyArrayEdges(const std::vector<std::pair<int, int>> &initialEdges);
+    AdjacencyArrayEdges(std::vector<EdgeOffset> offsets, std::vector<int> adjacency, std::vector<double> weights);
 
     /**
      * Adds a new edge to the edge list.
@@ -47,18 +77,53 @@ public:
      */
     std::vector<int> getNeighbors(int nodeID) override;
 
+    /**
+     * @brief Views the neighbors of a given node directly in the adjacency array.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> The sorted slice of adjacencyArray belonging to the node.
+     */
+    Span<const int> neighbors(int nodeID) const override;
+
     /**
      * @brief Checks if an edge exists between two nodes.
      *
+     * Binary searches the sorted list of source, or tests a single bit if source is a hub with a bitmap.
+     *
      * @param source The ID of the source node.
      * @param destination The ID of the destination node.
      * @return bool True if the edge exists, otherwise false.
      */
     bool isEdge(int source, int destination) override;
 
+    /**
+     * @brief Checks many node pairs for edges at once.
+     *
+     * Queries are grouped by source and walk its list with a galloping search,
+     * so sorted destinations of one source cost little more than a single lookup.
+     *
+     * @param queries pairs of source and destination node IDs
+     * @return std::vector<bool> Entry i is true if there is an edge between the nodes of queries[i].
+     */
+    std::vector<bool> areEdges(Span<const std::pair<int, int>> queries) override;
+
+    /**
+     * @brief Keeps a bitmap over all nodes for every node with at least minDegree neighbors.
+     *
+     * isEdge on such a hub tests one bit instead of searching its list. Each bitmap takes
+     * getNodeCount() / 8 bytes, so minDegree should be well above the average degree.
+     * The bitmaps are rebuilt when an edge is added. A minDegree of 0 removes all bitmaps.
+     *
+     * @param minDegree smallest degree of a node that gets a bitmap
+     */
+    void enableHubBitmaps(size_t minDegree);
+
     /**
      * @brief Retrieves all edges in the graph.
      *
+     * Each edge is listed once as (smaller ID, larger ID). Self-loops are left out,
+     * they are only seen in neighbors().
+     *
      * @return std::vector<std::pair<int, int>> A list of all edges as node ID pairs.
      */
     std::vector<std::pair<int, int>> getEdges() const override;
@@ -80,21 +145,121 @@ public:
      */
     double getWeight(int source, int destination) const override;
 
+    /**
+     * @brief Views the weights of a node's edges directly in the weight array.
+     *
+     * @param nodeID The ID of the node whose edge weights are to be retrieved.
+     * @return Span<const double> The slice of edgeWeights aligned with neighbors(nodeID).
+     */
+    Span<const double> weights(int nodeID) const override;
+
     /**
      * @brief Returns number of stored edges
      *
-     * @return int Number of stored edges
+     * Counts each distinct edge once, self-loops included, so it exceeds getEdges().size() by the number of self-loops.
+     *
+     * @return size_t Number of stored edges
+     */
+    size_t size() const override;
+
+    /**
+     * @brief Returns the number of adjacency lists, i.e. the highest node ID with an edge + 1
+     *
+     * @return size_t Number of adjacency lists
      */
-    int size() override;
+    size_t getNodeCount() const;
+
+    /**
+     * @brief Returns time and memory measured while building from the edge list.
+     *
+     * @return CsrBuildStats Measurements of the constructor, all zero for default constructed edges
+     */
+    const CsrBuildStats &getBuildStats() const;
+
+    /**
+     * @brief Views the raw offsets, one per adjacency list plus an end marker.
+     */
+    Span<const EdgeOffset> csrOffsets() const;
+
+    /**
+     * @brief Views all adjacency lists back to back.
+     */
+    Span<const int> csrAdjacency() const;
+
+    /**
+     * @brief Views all weights, aligned with csrAdjacency().
+     */
+    Span<const double> csrWeights() const;
+
+    /**
+     * @brief Returns the bytes held by offsets, adjacency lists and weights.
+     *
+     * @return size_t Heap memory used by this object
+     */
+    size_t memoryUsage() const;
 
     virtual ~AdjacencyArrayEdges();
 
 protected:
-    std::vector<int> adjacencyOffsets;                                         ///< tracks beginning of adjacency list of node in adjacencyArray
-    std::vector<int> adjacencyArray;                                           ///< concatenated adjacency lists
-    std::unordered_map<std::pair<int, int>, double, struct pair_hash> weights; ///< keeps track of edge weights
+    std::vector<EdgeOffset> adjacencyOffsets; ///< tracks beginning of adjacency list of node in adjacencyArray
+    std::vector<int> adjacencyArray;          ///< concatenated adjacency lists
+    std::vector<double> edgeWeights;   ///< weight of the edge stored at the same position in adjacencyArray, NaN if unset
+    CsrBuildStats buildStats;          ///< measurements of building from the edge list
+    size_t selfLoopCount = 0;          ///< lists holding their own node, these entries have no mirrored one
+
+    size_t hubMinDegree = 0;           ///< smallest degree with a bitmap, 0 if hub bitmaps are disabled
+    std::vector<int> hubBitmapSlot;    ///< index of the bitmap of each node, -1 for nodes without. Empty if disabled
+    std::vector<uint64_t> hubBitmaps;  ///< bitmaps of all hubs, back to back with hubBitmapWords words each
+    size_t hubBitmapWords = 0;         ///< words per bitmap
 
-    void fillAdjacencyArrayFromList(const std::unordered_map<int, std::vector<int>> &adjacencyList);
+    /**
+     * @brief Fills adjacencyOffsets and adjacencyArray from an edge list by a parallel counting sort.
+     *
+     * @param initialEdges undirected edges, each is stored in the lists of both of its nodes
+     * @param options number of threads and self-loop handling
+     */
+    void buildFromEdgeList(const std::vector<std::pair<int, int>> &initialEdges, const CsrBuildOptions &options);
+
+    /**
+     * @brief Finds the position of an edge in adjacencyArray by binary search in the sorted adjacency list of source.
+     *
+     * @return the position of destination in the list of source, or -1 if there is no such edge
+     */
+    long findEdge(int source, int destination) const;
+
+    /**
+     * @brief Counts the nodes whose list holds the node itself.
+     */
+    size_t countSelfLoops() const;
+
+    /**
+     * @brief Tests the bitmap of a hub, the caller has to make sure that source has one.
+     */
+    bool testHubBit(int source, int destination) const;
 };
 
+// neighbors and weights are defined here so that CsrGraph can inline them into traversal loops
+
+inline Span<const int> AdjacencyArrayEdges::neighbors(int nodeID) const
+{
+    if (nodeID < 0 || static_cast<size_t>(nodeID) + 1 >= adjacencyOffsets.size())
+    {
+        return {}; // Return empty span if nodeID is invalid
+    }
+
+    const int *adjacents = adjacencyArray.data();
+    return Span<const int>(adjacents + adjacencyOffsets[nodeID], adjacents + adjacencyOffsets[nodeID + 1]);
+}
+
+inline Span<const double> AdjacencyArrayEdges::weights(int nodeID) const
+{
+    if (nodeID < 0 || static_cast<size_t>(nodeID) + 1 >= adjacencyOffsets.size())
+    {
+        return {};
+    }
+
+    const double *weightsOfEdges = edgeWeights.data();
+    return Span<const double>(weightsOfEdges + adjacencyOffsets[nodeID], weightsOfEdges + adjacencyOffsets[nodeID + 1]);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef ALIGNED_ALLOCATOR_HPP
+#define ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+
+/**
+ * @class AlignedAllocator
+ * @brief std::allocator replacement that aligns every allocation to a given boundary.
+ *
+ * Used for the dense feature matrix of the graph, so the matrix starts on a cache line
+ * boundary. Only the start is aligned: the rows follow without padding, so a row only
+ * starts on a boundary if the row length is a multiple of it. FeatureKNN pads its rows
+ * to whole vector registers to load them with aligned instructions.
+ *
+ * @tparam T the allocated type
+ * @tparam Alignment alignment in bytes, 64 matches the cache line size on x86
+ */
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T *p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+};
+
+template <typename T, typename U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) { return true; }
+
+template <typename T, typename U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) { return false; }
+
+#endif // ALIGNED_ALLOCATOR_HPP
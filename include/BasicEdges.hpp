@@ -48,6 +48,14 @@ public:
      */
     vector<int> getNeighbors(int nodeID) override;
 
+    /**
+     * @brief Collects the sorted neighbors of a given node into a thread-local buffer.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> View of the buffer, valid until the next call on the same thread.
+     */
+    Span<const int> neighbors(int nodeID) const override;
+
     /**
      * @brief Checks if an edge exists between two nodes.
      *
@@ -81,12 +89,27 @@ public:
      */
     double getWeight(int source, int destination) const override;
 
+    /**
+     * @brief Collects the weights of a node's edges into a thread-local buffer.
+     *
+     * @param nodeID The ID of the node whose edge weights are to be retrieved.
+     * @return Span<const double> Weights aligned with neighbors(nodeID), valid until the next call on the same thread.
+     */
+    Span<const double> weights(int nodeID) const override;
+
     /**
      * @brief Returns number of stored edges
      *
-     * @return int Number of stored edges
+     * @return size_t Number of stored edges
+     */
+    size_t size() const override;
+
+    /**
+     * @brief Returns the bytes held by the edge list.
+     *
+     * @return size_t Heap memory used by this object
      */
-    int size() override;
+    size_t memoryUsage() const;
 
 private:
     vector<tuple<int, int, double>> edges; ///< Stores all edges as pairs of node IDs.
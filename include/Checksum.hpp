@@ -0,0 +1,19 @@
+#ifndef CHECKSUM_HPP
+#define CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Computes or continues a CRC-32 (IEEE 802.3, as used by zip and gzip).
+ *
+ * Pass the result of a previous call as crc to checksum data that arrives in pieces.
+ *
+ * @param data start of the bytes to checksum
+ * @param size number of bytes
+ * @param crc checksum of the preceding bytes, 0 to start a new checksum
+ * @return uint32_t The checksum of all bytes so far.
+ */
+uint32_t crc32(const void *data, size_t size, uint32_t crc = 0);
+
+#endif
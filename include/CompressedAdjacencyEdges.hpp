@@ -0,0 +1,172 @@
+#ifndef COMPRESSED_ADJACENCY_EDGES_HPP
+#define COMPRESSED_ADJACENCY_EDGES_HPP
+
+#include "interfaces/IEdges.hpp"
+#include "AdjacencyArrayEdges.hpp"
+
+#include <cstdint>
+
+/**
+ * @class CompressedAdjacencyEdges
+ * @brief Edge storage that keeps every sorted adjacency list gap-encoded as varints.
+ *
+ * Layout of the list of a node in the byte stream:
+ *  - the degree as varint
+ *  - if the list spans more than one block: a skip table with one fixed-size entry
+ *    (first neighbor, byte offset of the block) per block after the first
+ *  - the blocks of up to BLOCK_SIZE neighbors: the first neighbor as varint, then the gaps to the previous neighbor
+ *
+ * Lists are decoded sequentially for getNeighbors() and neighbors(), isEdge() binary searches the
+ * skip table and decodes a single block. Weights are kept uncompressed and only allocated once a weight is set.
+ */
+class CompressedAdjacencyEdges : public IEdges
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 64; ///< neighbors per block, every block can be decoded on its own
+
+    /**
+     * Default Constructor for CompressedAdjacencyEdges
+     */
+    CompressedAdjacencyEdges();
+
+    /**
+     * Constructor from a List of Edges
+     *
+     * @param initialEdges the undirected edges
+     */
+    CompressedAdjacencyEdges(const std::vector<std::pair<int, int>> &initialEdges);
+
+    /**
+     * Compresses an existing adjacency array, including its weights
+     *
+     * @param uncompressed the edges to compress
+     */
+    explicit CompressedAdjacencyEdges(const AdjacencyArrayEdges &uncompressed);
+
+    /**
+     * Adds a new edge by re-encoding the lists of both nodes.
+     * Takes time linear in the size of the compressed data, prefer building from a complete edge set.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     */
+    void addEdge(int source, int destination) override;
+
+    /**
+     * @brief Decodes the neighbors of a given node.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return std::vector<int> A sorted list of neighboring node IDs.
+     */
+    std::vector<int> getNeighbors(int nodeID) override;
+
+    /**
+     * @brief Decodes the neighbors of a given node into a thread-local buffer.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> View of the buffer, valid until the next call on the same thread.
+     */
+    Span<const int> neighbors(int nodeID) const override;
+
+    /**
+     * @brief Checks if an edge exists by searching the skip table and decoding one block.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @return bool True if the edge exists, otherwise false.
+     */
+    bool isEdge(int source, int destination) override;
+
+    /**
+     * @brief Retrieves all edges in the graph.
+     *
+     * Self-loops are left out like in AdjacencyArrayEdges::getEdges().
+     *
+     * @return std::vector<std::pair<int, int>> A list of all edges as node ID pairs with first < second.
+     */
+    std::vector<std::pair<int, int>> getEdges() const override;
+
+    /**
+     * Sets the weight of an existing edge for both directions.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @param weight The new weight.
+     */
+    void setWeight(int source, int destination, double weight) override;
+
+    /**
+     * Gets the weight of a specified edge.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @return the Weight of the specified edge, NaN if it isn't set or the edge doesn't exist
+     */
+    double getWeight(int source, int destination) const override;
+
+    /**
+     * @brief Views the weights of a node's edges, aligned with neighbors(nodeID).
+     *
+     * @param nodeID The ID of the node whose edge weights are to be retrieved.
+     * @return Span<const double> The weights, NaN where unset.
+     */
+    Span<const double> weights(int nodeID) const override;
+
+    /**
+     * @brief Returns number of stored edges
+     *
+     * Self-loops are included, like in AdjacencyArrayEdges::size().
+     *
+     * @return size_t Number of stored edges
+     */
+    size_t size() const override;
+
+    /**
+     * @brief Returns the bytes held by the compressed lists, offsets and weights.
+     *
+     * @return size_t Heap memory used by this object
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * @brief Returns the number of adjacency lists, i.e. the highest node ID with an edge + 1
+     */
+    size_t getNodeCount() const;
+
+    virtual ~CompressedAdjacencyEdges();
+
+protected:
+    std::vector<uint8_t> encodedLists;   ///< all encoded adjacency lists, back to back
+    std::vector<uint64_t> listOffsets;   ///< start of the list of each node in encodedLists, with the total size as end marker
+    std::vector<uint64_t> entryOffsets;  ///< position of the first weight of each node in edgeWeights. Empty until a weight is set
+    std::vector<double> edgeWeights;     ///< weights in the order of the decoded lists. Empty until a weight is set
+    size_t adjacencyEntries = 0;         ///< total number of neighbors over all lists
+    size_t selfLoopCount = 0;            ///< lists holding their own node, these entries have no mirrored one
+
+    /**
+     * @brief Encodes all lists of an adjacency array into encodedLists and listOffsets.
+     */
+    void encodeFrom(const AdjacencyArrayEdges &uncompressed);
+
+    /**
+     * @brief Decodes the complete list of a node.
+     */
+    void decodeList(int nodeID, std::vector<int> &out) const;
+
+    /**
+     * @brief Finds the index of destination within the list of source, -1 if it isn't there.
+     */
+    long findInList(int source, int destination) const;
+
+    /**
+     * @brief Allocates the weight array and computes entryOffsets on the first setWeight().
+     */
+    void allocateWeights();
+
+    /**
+     * @brief Appends the encoding of one sorted list to out.
+     */
+    static void encodeList(Span<const int> list, std::vector<uint8_t> &out);
+};
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef DELTA_ADJACENCY_EDGES_HPP
+#define DELTA_ADJACENCY_EDGES_HPP
+
+#include "interfaces/IEdges.hpp"
+#include "AdjacencyArrayEdges.hpp"
+
+#include <future>
+#include <memory>
+
+/**
+ * @class DeltaAdjacencyEdges
+ * @brief Edge storage for graphs that grow edge by edge.
+ *
+ * Edges live in an immutable adjacency array (the base) plus a small append buffer per node (the delta).
+ * addEdge only appends to the delta, so it takes amortized O(1) apart from the duplicate check.
+ * Once the delta holds mergeThreshold adjacency entries, a background thread merges base and delta
+ * into a fresh adjacency array. A finished merge replaces the base on the next call of a non-const
+ * method (addEdge, setWeight, isEdge, getNeighbors or compact). The const views don't install it,
+ * so they stay safe to call from several threads, but they keep merging the delta of every node on
+ * access until then: call compact() before a read-heavy phase.
+ *
+ * The neighbors of nodes without appended edges are viewed directly in the base.
+ * Nodes with appended edges are merged into a thread-local buffer on access,
+ * baseNeighbors() and appendedNeighbors() view both parts without merging.
+ */
+class DeltaAdjacencyEdges : public IEdges
+{
+public:
+    /**
+     * Constructor from a list of initial edges, which form the first base
+     *
+     * @param initialEdges the edges known up front, may be empty
+     * @param mergeThreshold number of appended adjacency entries (two per edge) that triggers a merge
+     */
+    DeltaAdjacencyEdges(const std::vector<std::pair<int, int>> &initialEdges = {}, size_t mergeThreshold = 1 << 16);
+
+    /**
+     * @brief Appends a new edge to the delta, ignoring edges that already exist.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     */
+    void addEdge(int source, int destination) override;
+
+    /**
+     * @brief Retrieves the neighbors of a given node. Installs a finished merge first.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return std::vector<int> A sorted list of neighboring node IDs.
+     */
+    std::vector<int> getNeighbors(int nodeID) override;
+
+    /**
+     * @brief Views the sorted neighbors of a node.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> The slice of the base if nothing was appended to the node,
+     *         otherwise a thread-local buffer valid until the next call on the same thread.
+     */
+    Span<const int> neighbors(int nodeID) const override;
+
+    /**
+     * @brief Views the neighbors of a node that are stored in the base.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> The sorted slice of the base, valid until the base is replaced by a merge.
+     */
+    Span<const int> baseNeighbors(int nodeID) const;
+
+    /**
+     * @brief Views the neighbors of a node that were appended since the last merge.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> The append buffer of the node in insertion order, valid until the edges are modified.
+     */
+    Span<const int> appendedNeighbors(int nodeID) const;
+
+    /**
+     * @brief Checks if an edge exists, by binary search in the base and a scan of the append buffer.
+     * Installs a finished merge first.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @return bool True if the edge exists, otherwise false.
+     */
+    bool isEdge(int source, int destination) override;
+
+    /**
+     * @brief Retrieves all edges in the graph.
+     *
+     * @return std::vector<std::pair<int, int>> A list of all edges as node ID pairs with first < second.
+     */
+    std::vector<std::pair<int, int>> getEdges() const override;
+
+    /**
+     * Sets the weight of an existing edge for both directions.
+     * Waits for a running merge first, as the merge reads the weights of the base.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @param weight The new weight.
+     */
+    void setWeight(int source, int destination, double weight) override;
+
+    /**
+     * Gets the weight of a specified edge.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @return the Weight of the specified edge, NaN if it isn't set or the edge doesn't exist
+     */
+    double getWeight(int source, int destination) const override;
+
+    /**
+     * @brief Views the weights of a node's edges, aligned with neighbors(nodeID).
+     *
+     * @param nodeID The ID of the node whose edge weights are to be retrieved.
+     * @return Span<const double> The weights, with the same lifetime as the span returned by neighbors().
+     */
+    Span<const double> weights(int nodeID) const override;
+
+    /**
+     * @brief Returns number of stored edges
+     *
+     * @return size_t Number of stored edges in base and delta
+     */
+    size_t size() const override;
+
+    /**
+     * @brief Merges the whole delta into the base and waits for it, e.g. before a read-heavy phase.
+     */
+    void compact();
+
+    /**
+     * @brief Whether a background merge is currently running.
+     */
+    bool isMerging() const;
+
+    /**
+     * @brief Number of adjacency entries currently held in the append buffers.
+     */
+    size_t getDeltaSize() const;
+
+    /**
+     * @brief Returns the number of adjacency lists, i.e. the highest node ID with an edge + 1
+     */
+    size_t getNodeCount() const;
+
+    virtual ~DeltaAdjacencyEdges();
+
+protected:
+    /**
+     * @brief Result of a background merge.
+     */
+    struct MergeResult
+    {
+        std::shared_ptr<AdjacencyArrayEdges> mergedBase; ///< base and the merged part of the delta
+        std::vector<size_t> mergedPrefixLengths;         ///< how many entries of each append buffer went into mergedBase
+    };
+
+    std::shared_ptr<AdjacencyArrayEdges> base;       ///< immutable structure, only its weights change outside of merges
+    std::vector<std::vector<int>> appendedAdjacency; ///< per node: neighbors appended since the last merge, in insertion order
+    std::vector<std::vector<double>> appendedWeights; ///< weights aligned with appendedAdjacency
+    size_t deltaSize = 0;                            ///< total number of entries in appendedAdjacency
+    size_t deltaSelfLoops = 0;                       ///< self-loops in appendedAdjacency, stored as a single entry
+    size_t mergeThreshold;                           ///< deltaSize at which a background merge is started
+    std::future<MergeResult> pendingMerge;           ///< the running merge, if any
+
+    /**
+     * @brief Starts merging a snapshot of the current delta into the base on a background thread.
+     */
+    void startMerge();
+
+    /**
+     * @brief Replaces the base by the result of the running merge if it is done, or waits for it if wait is set.
+     */
+    void installMerge(bool wait);
+
+    /**
+     * @brief Builds an adjacency array from a base and a snapshot of the append buffers.
+     */
+    static MergeResult merge(std::shared_ptr<const AdjacencyArrayEdges> base,
+                             std::vector<std::vector<int>> appendedAdjacency,
+                             std::vector<std::vector<double>> appendedWeights);
+};
+
+#endif
@@ -21,7 +21,19 @@ public:
     // They can remain abstract here if not common to all or can be partially implemented.
     virtual ~EmbeddingStrategy() = default;
 
+    /**
+     * @brief Retrieves the embeddings learned by the last run.
+     *
+     * @return the embeddings <nodeID, embeddingVector>, empty before run()
+     */
+    const unordered_map<int, vector<double>> &getEmbeddings() const
+    {
+        return learnedEmbeddings;
+    }
+
 protected:
+    unordered_map<int, vector<double>> learnedEmbeddings; ///< embeddings of the last run, kept for export
+
     // Common parameters for embedding-based strategies:
 
     int embeddingDimensions = 128; ///< size of the embedding vector of each node. Default taken from node2vec
@@ -158,10 +170,9 @@ protected:
      * @param embeddings the embeddings <nodeID, embeddingVector> of a set of nodes.
      * @param queryVector the feature vector (or embedding) against which the similarities are computed.
      * @param kSimilarNodes the number of similar nodes to retrieve.
-     * @return a vector of feature vectors corresponding to the actual features of the top-k most similar nodes,
-     *         as obtained from the graph.
+     * @return views of the feature rows of the top-k most similar nodes, as stored in the graph.
      */
-    vector<vector<double>> getFeaturesOfSimilarNodes(
+    vector<Span<const double>> getFeaturesOfSimilarNodes(
         const unordered_map<int, vector<double>> &embeddings,
         const vector<double> &queryVector,
         int kSimilarNodes)
@@ -200,12 +211,12 @@ protected:
                 minHeap.emplace(cosineSimilarity, nodeID);
             }
         }
-        vector<vector<double>> topKSimilar;
+        vector<Span<const double>> topKSimilar;
         while (!minHeap.empty())
         {
             int nodeID = minHeap.top().second;
             minHeap.pop();
-            topKSimilar.push_back(graph->getFeatureById(nodeID)); // returns the node's actual features
+            topKSimilar.push_back(graph->featureRowById(nodeID)); // views the node's actual features
         }
         reverse(topKSimilar.begin(), topKSimilar.end());
         return topKSimilar;
@@ -0,0 +1,96 @@
+#ifndef EXTERNAL_CSR_BUILDER_HPP
+#define EXTERNAL_CSR_BUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Options for building a CSR file from an edge file with bounded memory
+ */
+struct ExternalCsrOptions
+{
+    size_t memoryBudget = size_t(256) << 20; ///< bytes of buffers the build may allocate, the input file not counted
+    string temporaryDirectory;               ///< where sorted runs are spilled, empty for the directory of the output file
+    bool dropSelfLoops = false;              ///< whether edges (v, v) are left out. Otherwise they are stored once in the list of v
+};
+
+/**
+ * Measurements of an external CSR build
+ */
+struct ExternalCsrStats
+{
+    double buildSeconds = 0.0;       ///< wall clock time of the whole build
+    size_t peakBytes = 0;            ///< peak size of the buffers allocated by the build
+    size_t edgesRead = 0;            ///< valid edge lines in the input
+    size_t runs = 0;                 ///< sorted runs spilled to temporary files
+    size_t mergePasses = 0;          ///< passes merging groups of runs, needed if there are too many runs to open at once
+    size_t adjacencyEntries = 0;     ///< entries of the written adjacency lists
+    size_t listCount = 0;            ///< adjacency lists written, i.e. the highest node ID + 1
+    size_t removedDuplicates = 0;    ///< adjacency entries removed because the edge was listed more than once
+    size_t droppedSelfLoops = 0;     ///< self-loops left out because of ExternalCsrOptions::dropSelfLoops
+    size_t skippedInvalidEdges = 0;  ///< edges with negative node IDs
+    size_t malformedLines = 0;       ///< lines that couldn't be parsed
+};
+
+/**
+ * @class ExternalCsrBuilder
+ * @brief Builds the adjacency array of an edge file that doesn't fit into memory.
+ *
+ * The edge file is parsed in segments. Both directions of every edge are collected in a run
+ * buffer that is sorted, deduplicated and spilled to a temporary file whenever it is full.
+ * The runs are then k-way merged straight into a snapshot file with the CSR offsets and
+ * adjacency sections, which Graph accepts in place of a text edge file. If there are more runs
+ * than the budget has read buffers for, or than files may reasonably be open at once, groups of
+ * runs are merged into longer runs first.
+ * Apart from the input, which is memory-mapped or, if compressed, decompressed into memory,
+ * all buffers stay within ExternalCsrOptions::memoryBudget.
+ */
+class ExternalCsrBuilder
+{
+public:
+    explicit ExternalCsrBuilder(const ExternalCsrOptions &options = ExternalCsrOptions());
+
+    /**
+     * @brief Converts a text edge file into a CSR snapshot.
+     *
+     * @param edgesFile edge file in the format read by Graph
+     * @param csrFile the snapshot to write
+     * @return ExternalCsrStats what was read, written and dropped
+     * @throws runtime_error if a file can't be read or written
+     */
+    ExternalCsrStats build(const string &edgesFile, const string &csrFile);
+
+private:
+    ExternalCsrOptions options;
+
+    /**
+     * @brief Parses the edge file and spills it as sorted runs of (source, destination) keys.
+     *
+     * @param runFiles receives the path of each run as soon as it is created
+     */
+    void writeRuns(const string &edgesFile, const string &runPrefix, vector<string> &runFiles, ExternalCsrStats &stats, int &maxNodeId);
+
+    /**
+     * @brief Number of runs merged at once.
+     */
+    size_t mergeFanIn() const;
+
+    /**
+     * @brief Merges groups of runs into longer runs until at most mergeFanIn() are left.
+     *
+     * @param runFiles the runs, replaced by the remaining ones
+     * @param temporaryPaths receives the path of each new run as soon as it is created
+     */
+    void reduceRuns(vector<string> &runFiles, const string &runPrefix, vector<string> &temporaryPaths, ExternalCsrStats &stats);
+
+    /**
+     * @brief Merges the runs into the offsets and adjacency sections of the CSR snapshot.
+     */
+    void mergeRuns(const vector<string> &runFiles, const string &csrFile, const string &offsetsFile, int maxNodeId, ExternalCsrStats &stats);
+};
+
+#endif
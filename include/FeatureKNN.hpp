@@ -0,0 +1,97 @@
+#ifndef FEATURE_KNN_HPP
+#define FEATURE_KNN_HPP
+
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include "interfaces/IStrategies.hpp"
+#include "AlignedAllocator.hpp"
+#include "Graph.hpp"
+
+using namespace std;
+
+/**
+ * @class FeatureKNN
+ * @brief K-Nearest Neighbors in feature space: fills the missing features of a node from the k nodes
+ * with the most similar observed features, wherever they are in the graph.
+ *
+ * Distances only use the columns observed in both nodes. The Euclidean distance is divided by the number
+ * of these columns, so nodes sharing few columns aren't preferred, the cosine distance is 1 - cos over them.
+ * Nodes without any column in common with a query, or without a value for any of its missing columns, aren't considered.
+ *
+ * The nearest nodes are found by a brute force scan over blocks of nodes, vectorized with AVX2 if the
+ * CPU supports it. With "partitions" set, the nodes are split around that many pivots and each query only
+ * scans the "probes" partitions with the closest pivots, which is faster but may miss some nearest nodes.
+ *
+ * All queries read the features as loaded and are filled at once afterwards, so the result doesn't depend
+ * on the node order or the thread count.
+ */
+class FeatureKNN : public IStrategies
+{
+private:
+    int k = 15;
+    bool cosine = false;  // whether nodes are compared by cosine instead of Euclidean distance
+    unsigned threads = 0; // threads scanning for the nearest nodes, 0 uses all hardware threads
+    int partitions = 0;   // number of partitions of the index, 0 scans all nodes for every query
+    int probes = 4;       // partitions scanned per query
+
+    size_t rowStride = 0;                            ///< featureCount rounded up to whole vector registers
+    vector<double, AlignedAllocator<double>> values; ///< one row per node in partition order, 0 for missing features
+    vector<double, AlignedAllocator<double>> masks;  ///< 1 for observed and 0 for missing features, aligned with values
+    vector<size_t> rowSlots;                         ///< row -> slot of the node in the graph
+    vector<size_t> slotRows;                         ///< slot -> row
+    vector<size_t> partitionOffsets;                 ///< partition p holds the rows [partitionOffsets[p], partitionOffsets[p + 1])
+    vector<size_t> pivotRows;                        ///< row of the pivot of each partition
+
+    /**
+     * @brief Copies the features into the masked rows and splits them into partitions if configured.
+     *
+     * @param graph The graph to process.
+     */
+    void buildIndex(const Graph &graph);
+
+    /**
+     * @brief Masked distance between two rows.
+     *
+     * @return double The distance, or infinity if the rows have no observed column in common.
+     */
+    double distance(size_t queryRow, size_t row) const;
+
+    /**
+     * @brief Keeps the k nearest of the rows [begin, end) to a query in a max-heap of (distance, slot).
+     *
+     * Rows without a value for any of the missing columns of the query are skipped.
+     */
+    void scanRows(size_t queryRow, const vector<size_t> &missingColumns, size_t begin, size_t end, vector<pair<double, size_t>> &nearest) const;
+
+public:
+    /**
+     * @brief Default constructor.
+     */
+    FeatureKNN(shared_ptr<Graph> g) { graph = g; }
+
+    /**
+     * @brief Runs the feature space KNN strategy.
+     */
+    void run() override;
+
+    /**
+     * @brief Extracts the results after running the strategy.
+     * @return A modified graph with missing features filled.
+     */
+    shared_ptr<Graph> extractResults() const override;
+
+    /**
+     * @brief Configures strategy-specific parameters.
+     * @param params A map of parameter names and their values: k, cosine, threads, partitions and probes.
+     */
+    void configure(const map<string, double> &params) override;
+
+    /**
+     * @brief Resets the strategy to its initial state.
+     */
+    void reset() override;
+};
+
+#endif // FEATURE_KNN_HPP
@@ -0,0 +1,61 @@
+#ifndef FEATURE_WRITER_HPP
+#define FEATURE_WRITER_HPP
+
+#include <string>
+
+#include "Graph.hpp"
+
+using namespace std;
+
+/**
+ * Options for writing the features of a graph as text
+ */
+struct FeatureWriterOptions
+{
+    int fixedPrecision = -1; ///< digits after the decimal point, -1 for the 6 significant digits of ostream's default format
+    unsigned threads = 0;    ///< threads formatting rows, 0 uses all hardware threads
+    size_t chunkRows = 4096; ///< rows formatted by one thread before the chunks are written in order
+};
+
+/**
+ * @class FeatureWriter
+ * @brief Writes the features of a graph in the format of the node files.
+ *
+ * Every node becomes a line "id\tf1, f2, ...\tlabel" with the ID of the input files and missing features written as 0.0.
+ * By default numbers look exactly like `ostream << double` prints them.
+ *
+ * Rows are formatted with to_chars into one buffer per thread, which are written to the file in order,
+ * so memory stays bounded by threads * chunkRows rows.
+ */
+class FeatureWriter
+{
+public:
+    /**
+     * @throws invalid_argument if the fixed precision is outside [-1, 100]
+     */
+    explicit FeatureWriter(const FeatureWriterOptions &options = FeatureWriterOptions());
+
+    /**
+     * @brief Writes the features of all nodes in slot order.
+     *
+     * @param graph the graph to write
+     * @param fileName the file to write
+     * @return bool False if the file can't be written.
+     */
+    bool write(const Graph &graph, const string &fileName) const;
+
+    /**
+     * @brief Formats the lines of the nodes in the slots [beginSlot, endSlot).
+     *
+     * @param graph the graph to format
+     * @param beginSlot first slot
+     * @param endSlot one past the last slot
+     * @param out buffer the lines are appended to
+     */
+    void formatRows(const Graph &graph, size_t beginSlot, size_t endSlot, string &out) const;
+
+private:
+    FeatureWriterOptions options;
+};
+
+#endif
@@ -4,35 +4,194 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <unordered_map>
 
 #include "interfaces/IEdges.hpp"
 #include "AdjacencyArrayEdges.hpp"
-#include "Node.hpp"
+#include "AlignedAllocator.hpp"
+#include "IdIndex.hpp"
+#include "MappedFile.hpp"
+#include "NodeOrdering.hpp"
+#include "Span.hpp"
 
 using namespace std;
 
 /**
- * @class Graph
+ * @brief How a graph snapshot is loaded.
+ */
+enum class SnapshotAccess
+{
+    Read, ///< read every section into memory
+    Map   ///< use the sections in place from a copy-on-write memory mapping
+};
+
+/**
+ * @brief A node ID as used in the input files.
+ *
+ * Plain int node IDs are internal IDs. Graph methods taking an ExternalId translate it first,
+ * the explicit type keeps the two from being mixed up.
+ */
+struct ExternalId
+{
+    int value; ///< the ID in the input files
+
+    explicit ExternalId(int value) : value(value) {}
+};
+
+/**
+ * Wall clock times of the phases of loading a graph from text files.
+ *
+ * The edge phases run on their own thread, concurrently with the node phases,
+ * so totalSeconds is close to the larger of edgeSeconds() and nodeSeconds() plus reorderSeconds.
+ */
+struct LoadTimings
+{
+    double edgeReadSeconds = 0.0;  ///< opening and, if compressed, decompressing the edge file
+    double edgeParseSeconds = 0.0; ///< parsing the edge file
+    double csrBuildSeconds = 0.0;  ///< building the adjacency array, or reading it from a CSR snapshot
+    double nodeReadSeconds = 0.0;  ///< opening and, if compressed, decompressing the node file
+    double nodeParseSeconds = 0.0; ///< parsing the node file
+    double reorderSeconds = 0.0;   ///< renumbering the nodes, if the IDs are sparse or a NodeOrder other than Input is used
+    double totalSeconds = 0.0;     ///< the whole constructor
+
+    double edgeSeconds() const { return edgeReadSeconds + edgeParseSeconds + csrBuildSeconds; }
+    double nodeSeconds() const { return nodeReadSeconds + nodeParseSeconds; }
+};
+
+/**
+ * @class BasicGraph
  * @brief Represents an undirected, sparse graph.
  *
  * This class provides an interface for working with a graph structure.
  * It supports adding and querying nodes and edges, as well as parsing
  * graph data from files.
+ *
+ * Node data is stored in one contiguous row-major matrix: the node in slot i
+ * owns the features [i * featureCount, (i + 1) * featureCount) and label i.
+ *
+ * If the graph is loaded with a NodeOrder other than Input, all node IDs used by this class
+ * are internal IDs 0..n-1 in that order, and slots follow the same order.
+ * The same holds for NodeOrder::Input if the edge file uses IDs much larger than the number of edges:
+ * the nodes are then numbered 0..n-1 in the order of the node file, followed by the nodes only found in
+ * the edge file, so the adjacency array scales with the node count instead of the largest ID.
+ * getOriginalId() and getInternalId() translate between internal IDs and the IDs of the input files,
+ * and the node and edge methods also take ExternalId to look nodes up by their ID in the input files.
+ *
+ * The edges are held as EdgeBackend. Graph uses IEdges, so any backend fits, including the memory-mapped one.
+ * CsrGraph holds AdjacencyArrayEdges directly: neighbors(), edgeWeights() and isEdge() then compile
+ * to inline array accesses instead of virtual calls, which pays off in traversal loops.
+ * visitEdges() gets the same for code written against Graph.
+ *
+ * @tparam EdgeBackend IEdges or AdjacencyArrayEdges
  */
-class Graph
+template <typename EdgeBackend>
+class BasicGraph
 {
 private:
-    vector<Node> nodes;           /// the vector of nodes
-    unique_ptr<IEdges> edges;   /// object holding the pool of edges (abstract interface)
+    vector<int> nodeIds;                                    ///< slot -> nodeId, in order of the node file
+    vector<double, AlignedAllocator<double>> featureMatrix; ///< N x featureCount features, row-major. Missing features are NaN
+    vector<int> labels;                                     ///< slot -> label
+    size_t featureCount = 0;                                ///< number of features per node
+    unique_ptr<EdgeBackend> edges; ///< object holding the pool of edges
+
+    IdIndex slotIndex;          ///< nodeId -> slot
+
+    shared_ptr<MappedFile> snapshotMapping; ///< copy-on-write mapping of the snapshot of a memory-mapped graph, null otherwise
+    Span<double> mappedFeatures;            ///< feature matrix inside snapshotMapping, used instead of featureMatrix if set
+
+    NodeOrder nodeOrder = NodeOrder::Input; ///< numbering of the nodes chosen at load
+    vector<int> originalIds;                ///< internal ID -> ID in the input files. Empty if the IDs of the files are used
+    IdIndex internalIndex;                  ///< ID in the input files -> internal ID. Empty if the IDs of the files are used
+
+    LoadTimings loadTimings; ///< phases of the text constructor, all zero for snapshots
+
+    /**
+     * @brief Lists the nodes of both files: the node file in its order, then the nodes only found in the edge file by ID.
+     *
+     * @param edgeList the edges as read from the edge file
+     */
+    vector<int> collectNodeIds(const vector<pair<int, int>> &edgeList) const;
+
+    /**
+     * @brief Renumbers the node data, moving the slots into the new order. The edges are renumbered by the caller.
+     *
+     * @param newIds current node ID -> new node ID
+     */
+    void renumberNodes(const IdIndex &newIds);
+
+    /**
+     * @brief Numbers the nodes 0..n-1 in input order and builds the adjacency array on those IDs.
+     *
+     * Used instead of building on the IDs of the files when these are too sparse.
+     * Nodes that only occur in the edge file are numbered as well, they just have no slot.
+     *
+     * @param edgeList the edges as read from the edge file, renumbered in place
+     */
+    void remapToDenseIds(vector<pair<int, int>> &edgeList);
+
+    /**
+     * @brief Renumbers all nodes in the given order and permutes edges and node data accordingly.
+     *
+     * Nodes that only occur in the edge file are numbered as well, they just have no slot.
+     * The adjacency lists are permuted as they are, so self-loops and weights are kept.
+     *
+     * @param order the new numbering
+     * @param edgeList the edges on the current node IDs, used to find the nodes only in the edge file
+     */
+    void reorder(NodeOrder order, const vector<pair<int, int>> &edgeList);
+
+    /**
+     * @brief Translates an ID of the input files, -1 if there is no such node.
+     */
+    int internalId(ExternalId id) const;
+
 public:
     /**
      * @brief Constructs a graph by parsing from txt files.
      *
+     * The edge file may also be a snapshot holding only the adjacency array, as written by
+     * ExternalCsrBuilder for edge lists too large to parse in memory.
+     *
+     * Text files can be read straight from a zip archive with paths like "input/twitch.zip!/twitch_edges.txt",
+     * and files ending in ".gz" are decompressed. Both are decompressed in memory, nothing is extracted to disk.
+     *
      * @param nodesFile The file containing node information.
-     * @param edgesFile The file containing edge information.
+     * @param edgesFile The file containing edge information, as text or CSR snapshot.
+     * @param order The numbering of the nodes, NodeOrder::Input keeps the IDs of the files.
+     */
+    BasicGraph(const string &nodesFile, const string &edgesFile, NodeOrder order = NodeOrder::Input);
+
+    /**
+     * @brief Loads a graph from a binary snapshot written by save().
+     *
+     * With SnapshotAccess::Read every section is read in one piece and verified against its checksum.
+     *
+     * With SnapshotAccess::Map the feature matrix and the adjacency arrays are used in place from a
+     * copy-on-write mapping of the file instead: startup only reads node IDs and labels, other pages are
+     * loaded when first touched and are shared with every process mapping the same snapshot.
+     * Feature and weight updates copy the touched pages privately and never reach the file.
+     * Edges can't be added, and only the checksums of the small sections are verified, as
+     * verifying the others would read every page.
+     *
+     * @param snapshotFile The snapshot to load.
+     * @param access Whether to read or to map the snapshot.
+     * @throws runtime_error if the file is missing, not a snapshot of a supported version or corrupt.
+     * @throws logic_error for SnapshotAccess::Map if EdgeBackend can't hold the mapped edges.
+     */
+    explicit BasicGraph(const string &snapshotFile, SnapshotAccess access = SnapshotAccess::Read);
+
+    /**
+     * @brief Writes the graph to a binary snapshot.
+     *
+     * The snapshot holds the edges with their weights, the features with a mask of the missing ones,
+     * the labels and the IDs, including the permutation of a reordered graph.
+     *
+     * @param snapshotFile The file to write.
+     * @throws runtime_error if the file can't be written.
      */
-    Graph(const string &nodesFile, const string &edgesFile);
+    void save(const string &snapshotFile) const;
 
     /**
      * @brief Retrieves all nodes in the graph.
@@ -55,6 +214,57 @@ public:
      */
     vector<int> getNeighbors(int nodeId) const;
 
+    /**
+     * @brief Retrieves neighbors of a node given by its ID in the input files.
+     *
+     * @return vector<int> The internal IDs of the neighbors.
+     */
+    vector<int> getNeighbors(ExternalId nodeId) const;
+
+    /**
+     * @brief Views the sorted neighbors of a specified node without copying them.
+     *
+     * @see IEdges::neighbors() for how long the view stays valid.
+     *
+     * @return Span<const int> The neighbor node IDs.
+     */
+    Span<const int> neighbors(int nodeId) const
+    {
+        return edges->neighbors(nodeId);
+    }
+
+    /**
+     * @brief Views the sorted neighbors of a node given by its ID in the input files.
+     *
+     * @return Span<const int> The internal IDs of the neighbors.
+     */
+    Span<const int> neighbors(ExternalId nodeId) const;
+
+    /**
+     * @brief Checks if two nodes are connected by an edge.
+     *
+     * @return bool True if the edge exists, otherwise false.
+     */
+    bool isEdge(int source, int destination) const
+    {
+        return edges->isEdge(source, destination);
+    }
+
+    /**
+     * @brief Checks if two nodes given by their IDs in the input files are connected by an edge.
+     *
+     * @return bool True if the edge exists, otherwise false.
+     */
+    bool isEdge(ExternalId source, ExternalId destination) const;
+
+    /**
+     * @brief Checks many node pairs for edges at once, grouped by source node.
+     *
+     * @param queries pairs of source and destination node IDs
+     * @return vector<bool> Entry i is true if there is an edge between the nodes of queries[i].
+     */
+    vector<bool> areEdges(Span<const pair<int, int>> queries) const;
+
     /**
      * @brief Retrieves node count of graph.
      *
@@ -65,18 +275,143 @@ public:
     /**
      * @brief Retrieves edge count of graph.
      *
-     * @return int Number of all the edges in the graph.
+     * @return size_t Number of all the edges in the graph.
+     */
+    size_t getEdgeCount() const
+    {
+        return edges->size();
+    }
+
+    /**
+     * @brief Looks up the storage slot of a node in O(1).
+     *
+     * @param nodeId The ID of the node.
+     * @return long The slot of the node or -1 if the node is not found.
+     */
+    long getSlotById(int nodeId) const
+    {
+        return slotIndex.find(nodeId);
+    }
+
+    /**
+     * @brief Looks up the storage slot of a node by its ID in the input files.
+     *
+     * @param nodeId The ID of the node in the input files.
+     * @return long The slot of the node or -1 if the node is not found.
      */
-    int getEdgeCount() const;
+    long getSlotById(ExternalId nodeId) const;
 
     /**
-     * @brief Retrieves the feature vector of a node by its ID.
+     * @brief Retrieves the ID of the node stored in a given slot.
+     *
+     * @param slot The slot of the node, in the range [0, getNodeCount()).
+     * @return int The ID of the node.
+     */
+    int getIdBySlot(size_t slot) const;
+
+    /**
+     * @brief Retrieves the numbering the graph was loaded with.
+     *
+     * @return NodeOrder The order of the internal node IDs.
+     */
+    NodeOrder getNodeOrder() const;
+
+    /**
+     * @brief Retrieves how long the phases of loading the text files took.
+     *
+     * @return const LoadTimings& The timings, all zero if the graph was loaded from a snapshot.
+     */
+    const LoadTimings &getLoadTimings() const;
+
+    /**
+     * @brief Checks if the graph works on a memory-mapped snapshot.
+     *
+     * @return bool True if the graph was loaded with SnapshotAccess::Map.
+     */
+    bool isMemoryMapped() const;
+
+    /**
+     * @brief Translates an internal node ID back to the ID used in the input files.
+     *
+     * @param nodeId The internal ID of the node.
+     * @return int The ID in the input files, -1 if there is no such node. Unchanged if the IDs of the files are used.
+     */
+    int getOriginalId(int nodeId) const;
+
+    /**
+     * @brief Translates an ID used in the input files to the internal node ID.
+     *
+     * @param originalId The ID of the node in the input files.
+     * @return int The internal ID, -1 if there is no such node. Unchanged if the IDs of the files are used.
+     */
+    int getInternalId(int originalId) const;
+
+    /**
+     * @brief Retrieves the number of features every node has.
+     *
+     * @return size_t Length of each feature vector.
+     */
+    size_t getFeatureCount() const;
+
+    /**
+     * @brief Views the features of the node in a given slot without copying them.
+     *
+     * The view stays valid as long as the graph is alive. Writing through it updates the graph.
+     *
+     * @param slot The slot of the node, in the range [0, getNodeCount()).
+     * @return Span<double> The row of the node in the feature matrix.
+     */
+    Span<double> featureRow(size_t slot);
+
+    /**
+     * @copydoc featureRow(size_t)
+     */
+    Span<const double> featureRow(size_t slot) const;
+
+    /**
+     * @brief Views the features of a node by its ID without copying them.
+     *
+     * @param nodeId The ID of the node.
+     * @return Span<double> The row of the node or an empty span if the node is not found.
+     */
+    Span<double> featureRowById(int nodeId);
+
+    /**
+     * @copydoc featureRowById(int)
+     */
+    Span<const double> featureRowById(int nodeId) const;
+
+    /**
+     * @brief Views the features of a node by its ID in the input files.
+     *
+     * @param nodeId The ID of the node in the input files.
+     * @return Span<double> The row of the node or an empty span if the node is not found.
+     */
+    Span<double> featureRowById(ExternalId nodeId);
+
+    /**
+     * @copydoc featureRowById(ExternalId)
+     */
+    Span<const double> featureRowById(ExternalId nodeId) const;
+
+    /**
+     * @brief Retrieves a copy of the feature vector of a node by its ID.
+     *
+     * Prefer featureRowById() in hot loops, it doesn't allocate.
      *
      * @param nodeId The ID of the node.
      * @return vector<double> The feature vector of the node or an empty vector if the node is not found.
      */
     vector<double> getFeatureById(int nodeId) const;
 
+    /**
+     * @brief Retrieves a copy of the feature vector of a node by its ID in the input files.
+     *
+     * @param nodeId The ID of the node in the input files.
+     * @return vector<double> The feature vector of the node or an empty vector if the node is not found.
+     */
+    vector<double> getFeatureById(ExternalId nodeId) const;
+
     /**
      * @brief Update the entire feature vector of a node by its ID.
      * @param nodeId The ID of the node whose feature vector is to be updated.
@@ -84,6 +419,13 @@ public:
      */
     void updateFeatureById(int nodeId, const vector<double> &newFeatures);
 
+    /**
+     * @brief Update the entire feature vector of a node by its ID in the input files.
+     * @param nodeId The ID of the node in the input files.
+     * @param newFeatures The new feature vector to set for the node.
+     */
+    void updateFeatureById(ExternalId nodeId, const vector<double> &newFeatures);
+
     /**
      * Allows to set a weight of a specified edge
      *
@@ -92,6 +434,18 @@ public:
      */
     void setEdgeWeight(int source, int destination, double weight);
 
+    /**
+     * Allows to set a weight of an edge given by the IDs of the input files.
+     */
+    void setEdgeWeight(ExternalId source, ExternalId destination, double weight);
+
+    /**
+     * @brief Replaces the edges, e.g. by a DeltaAdjacencyEdges for a graph that keeps growing.
+     *
+     * @param newEdges the new edges, on the internal node IDs of this graph
+     */
+    void setEdges(unique_ptr<EdgeBackend> newEdges);
+
     /**
      * Gets the weight of a specified edge.
      *
@@ -101,6 +455,30 @@ public:
      */
     double getEdgeWeight(int source, int destination) const;
 
+    /**
+     * Gets the weight of an edge given by the IDs of the input files.
+     */
+    double getEdgeWeight(ExternalId source, ExternalId destination) const;
+
+    /**
+     * @brief Views the weights of the edges of a node, aligned with neighbors(nodeId).
+     *
+     * @param nodeId The ID of the node.
+     * @return Span<const double> The edge weights, NaN where no weight has been set.
+     */
+    Span<const double> edgeWeights(int nodeId) const
+    {
+        return edges->weights(nodeId);
+    }
+
+    /**
+     * @brief Views the weights of the edges of a node given by its ID in the input files.
+     *
+     * @param nodeId The ID of the node in the input files.
+     * @return Span<const double> The edge weights, aligned with neighbors(nodeId).
+     */
+    Span<const double> edgeWeights(ExternalId nodeId) const;
+
     /**
      * @brief Retrieves the label associated with a given node ID.
      *
@@ -110,7 +488,51 @@ public:
      * @param nodeId The ID of the node whose label is to be retrieved.
      * @return The label associated with the specified node ID.
      */
-    int getLabelById(int nodeId);
+    int getLabelById(int nodeId) const;
+
+    /**
+     * @brief Retrieves the label of a node by its ID in the input files.
+     *
+     * @param nodeId The ID of the node in the input files.
+     * @return The label associated with the specified node.
+     */
+    int getLabelById(ExternalId nodeId) const;
+
+    /**
+     * @brief Calls a visitor with the edges as their concrete type.
+     *
+     * The visitor is a generic lambda taking the edges as const reference, e.g. [&](const auto &edges) { ... }.
+     * Graph looks the backend up once per call and passes AdjacencyArrayEdges as such, other backends as IEdges,
+     * so loops inside the visitor are compiled without virtual calls where possible.
+     *
+     * @param visitor called once with the edges
+     */
+    template <typename Visitor>
+    void visitEdges(Visitor &&visitor) const
+    {
+        if constexpr (is_same_v<EdgeBackend, IEdges>)
+        {
+            if (auto csr = dynamic_cast<const AdjacencyArrayEdges *>(edges.get()))
+            {
+                visitor(*csr);
+                return;
+            }
+        }
+        visitor(static_cast<const EdgeBackend &>(*edges));
+    }
 };
 
+/**
+ * Graph over any edge backend, the type used by the strategies and the Python bindings
+ */
+using Graph = BasicGraph<IEdges>;
+
+/**
+ * Graph over an in-memory adjacency array, for traversal loops without virtual calls
+ */
+using CsrGraph = BasicGraph<AdjacencyArrayEdges>;
+
+extern template class BasicGraph<IEdges>;
+extern template class BasicGraph<AdjacencyArrayEdges>;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef GRAPH_PARSER_HPP
+#define GRAPH_PARSER_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
+#include "Span.hpp"
+
+using namespace std;
+
+/**
+ * @brief A line that could not be parsed.
+ */
+struct ParseError
+{
+    size_t line;    ///< 1-based line number in the parsed text
+    string message; ///< what is wrong with the line
+};
+
+/**
+ * @brief Edges read from an edge file.
+ */
+struct ParsedEdges
+{
+    vector<pair<int, int>> edges; ///< edges in order of the file
+    vector<ParseError> errors;    ///< skipped lines, by ascending line number
+};
+
+/**
+ * @brief Nodes read from a node file.
+ */
+struct ParsedNodes
+{
+    vector<int> nodeIds;                                    ///< IDs in order of the file
+    vector<double, AlignedAllocator<double>> featureMatrix; ///< nodeIds.size() x featureCount, row-major. Missing features are NaN
+    vector<int> labels;                                     ///< label of each node, 0 if the line has none
+    size_t featureCount = 0;                                ///< features per node, taken from the first node
+    vector<ParseError> errors;                              ///< skipped lines and padded rows, by ascending line number
+};
+
+/**
+ * @class GraphParser
+ * @brief Parses node and edge files in parallel.
+ *
+ * The text is split into line-aligned chunks which are parsed on their own threads
+ * with from_chars, without creating temporary strings. The results are joined in file order.
+ *
+ * Edge lines hold two whitespace-separated node IDs, anything after them is ignored.
+ * Node lines hold the node ID, a tab, comma-separated features and optionally a tab and the label.
+ * A feature of # or '#' is missing and stored as NaN. Blank lines are skipped.
+ * Malformed lines are skipped and collected in the errors of the result instead of being printed.
+ */
+class GraphParser
+{
+public:
+    /**
+     * @param threads number of threads to parse with, 0 means defaultThreadCount()
+     */
+    explicit GraphParser(unsigned threads = 0);
+
+    /**
+     * @brief Parses the contents of an edge file.
+     *
+     * @param text the contents of the file
+     * @return ParsedEdges the edges and the lines that were skipped
+     */
+    ParsedEdges parseEdges(Span<const char> text) const;
+
+    /**
+     * @brief Parses the contents of a node file.
+     *
+     * Rows with another number of features than the first node are padded with NaN or cut
+     * to the width of the first row and reported as errors.
+     *
+     * @param text the contents of the file
+     * @return ParsedNodes the node data and the lines that were skipped or padded
+     */
+    ParsedNodes parseNodes(Span<const char> text) const;
+
+    /**
+     * @brief Prints a short summary of parse errors to cerr, with the first few line numbers.
+     *
+     * @param fileName name of the parsed file, used as prefix
+     * @param errors the errors to report, nothing is printed if empty
+     */
+    static void reportErrors(const string &fileName, const vector<ParseError> &errors);
+
+private:
+    unsigned threads; ///< number of threads to parse with
+
+    /**
+     * @brief Splits the text into up to one line-aligned chunk per thread.
+     *
+     * @return the chunk boundaries, chunk i is [bounds[i], bounds[i + 1])
+     */
+    vector<size_t> splitIntoChunks(Span<const char> text) const;
+};
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef GRAPH_SNAPSHOT_HPP
+#define GRAPH_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Binary snapshot of a Graph.
+ *
+ * The first page holds a SnapshotHeader with a table of sections, every section starts on its own page,
+ * so sections can be memory-mapped and used in place.
+ * Sections are stored in the byte order of the machine that wrote them, which is checked on load.
+ * Each section carries a CRC-32 of its contents.
+ *
+ * Version 1 stored missing features as 0, version 2 stores them as NaN so the feature matrix can be used as mapped.
+ * Version 3 stores the CSR offsets as uint64 in WideOffsets instead of int32 in Offsets, for more than 2^31 adjacency entries.
+ */
+
+const char SNAPSHOT_MAGIC[8] = {'M', 'L', 'G', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t SNAPSHOT_VERSION = 3;
+const uint32_t SNAPSHOT_BYTE_ORDER_MARK = 0x01020304;
+const size_t SNAPSHOT_PAGE_SIZE = 4096;
+const size_t SNAPSHOT_MAX_SECTIONS = 16;
+
+/**
+ * @brief Contents of a section, stored as the raw array named.
+ */
+enum class SnapshotSection : uint32_t
+{
+    NodeIds = 1,     ///< int32 per node, in slot order
+    Labels = 2,      ///< int32 per node, in slot order
+    Features = 3,    ///< double per node and feature, row-major, NaN where missing (0 before version 2)
+    MissingMask = 4, ///< one bit per feature, row-major, packed into uint64 words. A set bit marks a missing feature
+    Offsets = 5,     ///< int32 CSR offsets, one per adjacency list and an end marker. Replaced by WideOffsets in version 3
+    Adjacency = 6,   ///< int32 CSR adjacency lists
+    Weights = 7,     ///< double per adjacency entry. Only present if any weight is set
+    OriginalIds = 8, ///< int32 original ID per internal ID. Only present for reordered graphs
+    WideOffsets = 9  ///< uint64 CSR offsets, one per adjacency list and an end marker
+};
+
+/**
+ * @brief Position and checksum of a section.
+ */
+struct SnapshotSectionEntry
+{
+    uint32_t id;       ///< SnapshotSection of the entry, 0 for unused entries
+    uint32_t checksum; ///< CRC-32 of the section contents
+    uint64_t offset;   ///< start of the section in the file, a multiple of SNAPSHOT_PAGE_SIZE
+    uint64_t size;     ///< length of the section in bytes
+};
+
+/**
+ * @brief First page of a snapshot.
+ */
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint64_t nodeCount;    ///< nodes with a slot
+    uint64_t featureCount; ///< features per node
+    uint32_t nodeOrder;    ///< NodeOrder the node IDs are numbered in
+    uint32_t sectionCount; ///< used entries of sections
+    SnapshotSectionEntry sections[SNAPSHOT_MAX_SECTIONS];
+};
+
+static_assert(sizeof(SnapshotHeader) <= SNAPSHOT_PAGE_SIZE, "the snapshot header has to fit into the first page");
+
+/**
+ * @class SnapshotWriter
+ * @brief Writes a snapshot section by section, sections may be written in pieces.
+ *
+ * Errors are reported as runtime_error.
+ */
+class SnapshotWriter
+{
+public:
+    /**
+     * @brief Creates the file and reserves the header page.
+     *
+     * @param path the file to write
+     * @param nodeCount nodes with a slot
+     * @param featureCount features per node
+     * @param nodeOrder NodeOrder of the node IDs, as number
+     */
+    SnapshotWriter(const string &path, uint64_t nodeCount, uint64_t featureCount, uint32_t nodeOrder);
+
+    /**
+     * @brief Starts a new section on the next page.
+     */
+    void beginSection(SnapshotSection section);
+
+    /**
+     * @brief Appends bytes to the current section.
+     */
+    void write(const void *data, size_t size);
+
+    /**
+     * @brief Writes a complete section from one array.
+     */
+    void writeSection(SnapshotSection section, const void *data, size_t size);
+
+    /**
+     * @brief Writes the header with the section table and closes the file.
+     */
+    void finish();
+
+private:
+    string path;
+    ofstream file;
+    SnapshotHeader header;
+    SnapshotSectionEntry *current = nullptr; ///< entry of the section being written
+    uint64_t position = 0;                   ///< current end of the file
+
+    void endSection();
+};
+
+/**
+ * @class SnapshotReader
+ * @brief Reads the sections of a snapshot, each with one bulk read.
+ *
+ * The header is validated on construction. Errors, including checksum mismatches, are reported as runtime_error.
+ */
+class SnapshotReader
+{
+public:
+    /**
+     * @brief Opens a snapshot and reads its header.
+     *
+     * @param path the file to read
+     */
+    explicit SnapshotReader(const string &path);
+
+    /**
+     * @brief Checks if a file starts with the snapshot magic.
+     *
+     * @param path the file to check
+     * @return bool True if the file exists and is a snapshot.
+     */
+    static bool isSnapshot(const string &path);
+
+    const SnapshotHeader &getHeader() const;
+
+    /**
+     * @brief Looks up a section.
+     *
+     * @return const SnapshotSectionEntry* The entry of the section or nullptr if the snapshot has none.
+     */
+    const SnapshotSectionEntry *findSection(SnapshotSection section) const;
+
+    /**
+     * @brief Verifies the checksum of a section that is already in memory, e.g. mapped.
+     *
+     * @param entry the section
+     * @param contents the bytes of the section
+     * @throws runtime_error if the checksum doesn't match
+     */
+    void verifySection(const SnapshotSectionEntry &entry, const void *contents) const;
+
+    /**
+     * @brief Reads a section into a vector and verifies its checksum.
+     *
+     * @param section the section to read
+     * @param out resized to the number of elements in the section
+     * @return bool False if the snapshot has no such section, out is left empty then.
+     */
+    template <typename T, typename Allocator>
+    bool readSection(SnapshotSection section, vector<T, Allocator> &out)
+    {
+        out.clear();
+        const SnapshotSectionEntry *entry = findSection(section);
+        if (entry == nullptr)
+        {
+            return false;
+        }
+        if (entry->size % sizeof(T) != 0)
+        {
+            throw runtime_error(path + ": section " + to_string(entry->id) + " has an invalid size");
+        }
+
+        out.resize(entry->size / sizeof(T));
+        readBytes(*entry, out.data());
+        return true;
+    }
+
+private:
+    string path;
+    ifstream file;
+    SnapshotHeader header;
+
+    /**
+     * @brief Reads the contents of a section to target and verifies the checksum.
+     */
+    void readBytes(const SnapshotSectionEntry &entry, void *target);
+};
+
+#endif
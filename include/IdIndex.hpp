@@ -0,0 +1,94 @@
+#ifndef ID_INDEX_HPP
+#define ID_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class IdIndex
+ * @brief Maps node IDs to their position in a list of IDs in O(1).
+ *
+ * A plain vector is used if the IDs are non-negative and not much larger than their count,
+ * otherwise a hash map is used so that a few huge IDs don't blow up memory.
+ */
+class IdIndex
+{
+public:
+    IdIndex() = default;
+
+    /**
+     * @brief Indexes a list of distinct IDs.
+     *
+     * @param ids the IDs, position i is returned for ids[i]
+     */
+    explicit IdIndex(const vector<int> &ids)
+    {
+        build(ids);
+    }
+
+    /**
+     * @brief Replaces the index by one over a new list of distinct IDs.
+     *
+     * @param ids the IDs, position i is returned for ids[i]
+     */
+    void build(const vector<int> &ids)
+    {
+        dense.clear();
+        sparse.clear();
+        if (ids.empty())
+        {
+            return;
+        }
+
+        auto [minId, maxId] = minmax_element(ids.begin(), ids.end());
+
+        // dense if the ID range is at most twice the ID count (plus some slack for tiny graphs)
+        if (*minId >= 0 && static_cast<size_t>(*maxId) < 2 * ids.size() + 1024)
+        {
+            dense.assign(static_cast<size_t>(*maxId) + 1, -1);
+            for (size_t position = 0; position < ids.size(); position++)
+            {
+                dense[ids[position]] = static_cast<int>(position);
+            }
+        }
+        else
+        {
+            sparse.reserve(ids.size());
+            for (size_t position = 0; position < ids.size(); position++)
+            {
+                sparse.emplace(ids[position], position);
+            }
+        }
+    }
+
+    /**
+     * @brief Looks up the position of an ID.
+     *
+     * @param id the ID to look up
+     * @return long The position of the ID or -1 if it isn't indexed.
+     */
+    long find(int id) const
+    {
+        if (!dense.empty())
+        {
+            if (id < 0 || static_cast<size_t>(id) >= dense.size())
+            {
+                return -1;
+            }
+            return dense[id];
+        }
+
+        auto it = sparse.find(id);
+        return it != sparse.end() ? static_cast<long>(it->second) : -1;
+    }
+
+private:
+    vector<int> dense;                 ///< ID -> position, -1 if absent. Used if the ID space is dense
+    unordered_map<int, size_t> sparse; ///< ID -> position. Fallback for sparse ID spaces
+};
+
+#endif
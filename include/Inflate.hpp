@@ -0,0 +1,23 @@
+#ifndef INFLATE_HPP
+#define INFLATE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Span.hpp"
+
+using namespace std;
+
+/**
+ * @brief Decompresses a raw DEFLATE stream (RFC 1951), as found in zip and gzip files.
+ *
+ * Decoding uses one lookup table per Huffman code, so each symbol costs a single table access.
+ *
+ * @param compressed the stream, may be followed by other data
+ * @param out receives the decompressed bytes, appended to its current contents
+ * @return size_t Number of bytes of compressed that belonged to the stream.
+ * @throws runtime_error if the stream is corrupt or truncated
+ */
+size_t inflate(Span<const char> compressed, vector<char> &out);
+
+#endif
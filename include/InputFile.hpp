@@ -0,0 +1,125 @@
+#ifndef INPUT_FILE_HPP
+#define INPUT_FILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "Span.hpp"
+
+using namespace std;
+
+/**
+ * @class ZipArchive
+ * @brief Reads entries of a zip archive from a memory mapping, without extracting them to disk.
+ *
+ * Entries may be stored or deflated. Encrypted entries and zip64 archives are not supported.
+ */
+class ZipArchive
+{
+public:
+    /**
+     * @brief Maps the archive and reads its central directory.
+     *
+     * @param path the archive
+     * @throws runtime_error if the file exists but isn't a zip archive
+     */
+    explicit ZipArchive(const string &path);
+
+    /**
+     * @brief Checks if the archive file could be opened.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Retrieves the names of all entries, in order of the central directory.
+     */
+    vector<string> entryNames() const;
+
+    /**
+     * @brief Checks if the archive has an entry with the given name.
+     */
+    bool hasEntry(const string &name) const;
+
+    /**
+     * @brief Decompresses an entry into memory and verifies its checksum.
+     *
+     * @param name the name of the entry, including its directories inside the archive
+     * @return vector<char> The contents of the entry.
+     * @throws runtime_error if the entry is missing, corrupt or uses an unsupported method
+     */
+    vector<char> read(const string &name) const;
+
+private:
+    /**
+     * Central directory record of an entry
+     */
+    struct Entry
+    {
+        string name;
+        uint16_t flags;
+        uint16_t method;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t localHeaderOffset;
+    };
+
+    string path;
+    MappedFile mapping;
+    vector<Entry> entries;
+};
+
+/**
+ * @brief Decompresses gzip data, including files of several concatenated members.
+ *
+ * @param contents the gzip file
+ * @param name name of the file, for error messages
+ * @return vector<char> The decompressed contents.
+ * @throws runtime_error if the data is not gzip or is corrupt
+ */
+vector<char> readGzip(Span<const char> contents, const string &name);
+
+/**
+ * @class InputFile
+ * @brief Contents of an input file, which may be an entry of a zip archive or gzip-compressed.
+ *
+ * - "archive.zip!/entry.txt" reads entry.txt from archive.zip
+ * - "file.gz" is decompressed
+ * - any other path is memory-mapped as is
+ *
+ * Compressed inputs are decompressed into memory once, without a temporary file on disk.
+ */
+class InputFile
+{
+public:
+    static constexpr const char *ARCHIVE_SEPARATOR = "!/"; ///< separates the archive from the entry in paths
+
+    /**
+     * @brief Opens and, if needed, decompresses the input.
+     *
+     * @param path the file, see the class description for the supported forms
+     * @throws runtime_error if a compressed input is corrupt
+     */
+    explicit InputFile(const string &path);
+
+    /**
+     * @brief Checks if the file, or the archive and its entry, exist.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Views the (decompressed) contents of the input.
+     *
+     * @return Span<const char> The contents, valid as long as this object.
+     */
+    Span<const char> contents() const;
+
+private:
+    MappedFile mapping;          ///< mapping of an uncompressed file
+    vector<char> decompressed;   ///< contents of a compressed input
+    bool isDecompressed = false; ///< whether decompressed holds the contents
+};
+
+#endif
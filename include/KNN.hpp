@@ -3,7 +3,7 @@
 
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <utility>
 
 #include "interfaces/IStrategies.hpp"
 #include "Graph.hpp"
@@ -19,33 +19,77 @@ class KNN : public IStrategies
 private:
     int k = 15;
     int maxIterations = 10; // avoid infinite loops, the nax iterations is arbitrary and can be changed
-    // Cache for neighbors and path to avoid repeatedly calculating them
-    unordered_map<int, vector<int>> cachedNeighbors;
-    unordered_map<int, unordered_map<int, int>> precomputedPaths;
+    unsigned threads = 0;   // threads running the BFS of calcPaths, 0 uses all hardware threads
+    bool fused = false;     // whether run() uses estimateFeaturesFused instead of calcPaths and estimateFeatures
+    bool jacobi = false;    // whether run() uses estimateFeaturesJacobi instead of estimateFeatures
+    // Cache for paths to avoid repeatedly calculating them, one row per node in the order of graph.getNodes().
+    // The nodes found from nodes[i] are pathEntries[pathOffsets[i] .. pathOffsets[i + 1]) as (node, distance), closest first
+    vector<size_t> pathOffsets;
+    vector<pair<int, int>> pathEntries;
+    // The k nearest nodes within a distance of k used to fill nodes[i]: similarIds[similarOffsets[i] .. similarOffsets[i + 1])
+    vector<size_t> similarOffsets;
+    vector<int> similarIds;
+    // Reverse of the above, the indices of the nodes that use nodes[i]: dependents[dependentOffsets[i] .. dependentOffsets[i + 1])
+    vector<size_t> dependentOffsets;
+    vector<size_t> dependents;
 
     /**
-     * @brief Cache the neighbors of all nodes in the graph.
+     * @brief Calculate the shortest paths for all nodes up to a distance of k.
+     *
+     * Runs one BFS per node, spread over the configured threads. Each thread reuses a distance array
+     * over all node IDs that is reset by an epoch counter instead of being cleared per source.
      *
      * @param graph The graph to process.
+     * @param k The number of nearest neighbors to consider.
      */
-    void cacheNeighbors(const Graph &graph);
+    void calcPaths(const Graph &graph, int k);
 
     /**
-     * @brief Calculate the shortest paths for all nodes up to a distance of k.
+     * @brief Fills similarOffsets, similarIds and their reverse lists from the paths found by calcPaths.
      *
      * @param graph The graph to process.
-     * @param k The number of nearest neighbors to consider.
+     * @param k The number of neighbors to consider.
      */
-    void calcPaths(const Graph &graph, int k);
+    void buildSimilarLists(const Graph &graph, int k);
 
     /**
      * @brief Estimate missing features for nodes in the graph using k-nearest neighbors.
      *
+     * The first sweep visits every node with a missing feature. Afterwards a node is only visited again
+     * once one of its nearest nodes gained a value in a column the node is missing, so later sweeps cost
+     * time in proportion to the values filled, not to the graph.
+     *
      * @param graph The graph to process.
      * @param k The number of neighbors to consider.
      */
     void estimateFeatures(Graph &graph, int k);
 
+    /**
+     * @brief Estimate missing features like estimateFeatures, but with every sweep reading the values of the previous one.
+     *
+     * The queued nodes of a sweep are filled in parallel into a second buffer while the feature matrix stays frozen,
+     * and are written back once all of them are done. The order of the nodes doesn't matter then,
+     * so the result is bit-identical for any thread count. Nodes are queued again as in estimateFeatures.
+     *
+     * @param graph The graph to process.
+     * @param k The number of neighbors to consider.
+     */
+    void estimateFeaturesJacobi(Graph &graph, int k);
+
+    /**
+     * @brief Estimate missing features without precomputing any paths.
+     *
+     * Only nodes with missing features run the bounded BFS, collect their k nearest nodes and are filled, all in one pass.
+     * Nodes are handled in fixed blocks: the threads fill the nodes of a block into a staging buffer, which is written
+     * back once the block is done. Nodes of the same block therefore don't see each other's new values, unlike in
+     * estimateFeatures, but the result is the same for any thread count. Memory depends on k, the block size and the
+     * thread count, not on the size of the graph.
+     *
+     * @param graph The graph to process.
+     * @param k The number of neighbors to consider.
+     */
+    void estimateFeaturesFused(Graph &graph, int k);
+
 public:
     /**
      * @brief Default constructor.
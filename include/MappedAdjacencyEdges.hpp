@@ -0,0 +1,148 @@
+#ifndef MAPPED_ADJACENCY_EDGES_HPP
+#define MAPPED_ADJACENCY_EDGES_HPP
+
+#include "interfaces/IEdges.hpp"
+#include "MappedFile.hpp"
+
+#include <memory>
+#include <mutex>
+
+/**
+ * @class MappedAdjacencyEdges
+ * @brief Read-only adjacency array that lives in a memory-mapped snapshot.
+ *
+ * Offsets and adjacency lists are used in place, so only the pages of the lists that are
+ * actually visited are ever loaded. Weights can still be set: they are written to the
+ * copy-on-write mapping, or to a heap array if the snapshot has no weights.
+ * Adding edges is not supported.
+ */
+class MappedAdjacencyEdges : public IEdges
+{
+public:
+    /**
+     * Constructor over sections of a mapped snapshot
+     *
+     * @param mapping the copy-on-write mapping the sections are part of, kept alive by this object
+     * @param offsets one offset per adjacency list and an end marker
+     * @param adjacency all adjacency lists back to back, each sorted
+     * @param weights weights aligned with adjacency, or an empty span if the snapshot has none
+     */
+    MappedAdjacencyEdges(shared_ptr<MappedFile> mapping, Span<const EdgeOffset> offsets, Span<const int> adjacency, Span<double> weights);
+
+    /**
+     * Constructor with offsets held on the heap, for snapshots whose offsets are narrower than EdgeOffset
+     *
+     * @param mapping the copy-on-write mapping the sections are part of, kept alive by this object
+     * @param offsets one offset per adjacency list and an end marker, widened from the snapshot
+     * @param adjacency all adjacency lists back to back, each sorted
+     * @param weights weights aligned with adjacency, or an empty span if the snapshot has none
+     */
+    MappedAdjacencyEdges(shared_ptr<MappedFile> mapping, vector<EdgeOffset> offsets, Span<const int> adjacency, Span<double> weights);
+
+    /**
+     * Not supported, the lists are fixed by the snapshot.
+     *
+     * @throws logic_error always
+     */
+    void addEdge(int source, int destination) override;
+
+    /**
+     * @brief Retrieves the neighbors of a given node.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return vector<int> A list of neighboring node IDs.
+     */
+    vector<int> getNeighbors(int nodeID) override;
+
+    /**
+     * @brief Views the sorted neighbors of a given node in the mapping.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> The neighboring node IDs, empty for unknown nodes.
+     */
+    Span<const int> neighbors(int nodeID) const override;
+
+    /**
+     * @brief Checks if an edge exists by binary search in the list of source.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @return bool True if the edge exists, otherwise false.
+     */
+    bool isEdge(int source, int destination) override;
+
+    /**
+     * @brief Retrieves all edges in the graph.
+     *
+     * @return vector<pair<int, int>> A list of all edges as node ID pairs with first <= second.
+     */
+    vector<pair<int, int>> getEdges() const override;
+
+    /**
+     * Sets the weight of an existing edge for both directions.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @param weight The new weight.
+     */
+    void setWeight(int source, int destination, double weight) override;
+
+    /**
+     * Gets the weight of a specified edge.
+     *
+     * @param source The ID of the source node.
+     * @param destination The ID of the destination node.
+     * @return the Weight of the specified edge, NaN if it isn't set or the edge doesn't exist
+     */
+    double getWeight(int source, int destination) const override;
+
+    /**
+     * @brief Views the weights of a node's edges, aligned with neighbors(nodeID).
+     *
+     * @param nodeID The ID of the node whose edge weights are to be retrieved.
+     * @return Span<const double> The weights, NaN where unset.
+     */
+    Span<const double> weights(int nodeID) const override;
+
+    /**
+     * @brief Returns number of stored edges
+     *
+     * Counted like AdjacencyArrayEdges::size(), self-loops included. The self-loops are
+     * counted on the first call, so opening a snapshot doesn't read all lists.
+     *
+     * @return size_t Number of stored edges
+     */
+    size_t size() const override;
+
+    /**
+     * @brief Views the raw offsets, one per adjacency list plus an end marker.
+     */
+    Span<const EdgeOffset> csrOffsets() const;
+
+    /**
+     * @brief Views all adjacency lists back to back.
+     */
+    Span<const int> csrAdjacency() const;
+
+    /**
+     * @brief Views all weights, aligned with csrAdjacency(). Empty if no weight was ever set.
+     */
+    Span<const double> csrWeights() const;
+
+private:
+    shared_ptr<MappedFile> mapping; ///< keeps the mapped sections alive
+    Span<const EdgeOffset> offsets;  ///< mapped or heap CSR offsets
+    Span<const int> adjacency;       ///< mapped CSR adjacency lists
+    Span<double> edgeWeights;        ///< mapped or heap weights, empty until a weight is set if the snapshot has none
+    vector<EdgeOffset> heapOffsets;  ///< backing store of offsets if they had to be widened
+    vector<double> heapWeights;      ///< backing store of edgeWeights if the snapshot has no weights
+    mutable once_flag selfLoopsCounted;
+    mutable size_t selfLoopCount = 0; ///< lists holding their own node, valid once selfLoopsCounted is set
+
+    /**
+     * @brief Finds the position of an edge in adjacency, -1 if there is no such edge.
+     */
+    long findEdge(int source, int destination) const;
+};
+
+#endif
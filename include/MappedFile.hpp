@@ -0,0 +1,78 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "Span.hpp"
+
+using namespace std;
+
+/**
+ * @class MappedFile
+ * @brief Memory mapping of a whole file, unmapped on destruction.
+ *
+ * Lets parsers work on the file contents directly instead of copying them into strings line by line.
+ * A copy-on-write mapping can also be written to: written pages become private to the process,
+ * the file and all other pages stay shared with other processes mapping the same file.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Maps a file into memory.
+     *
+     * @param path the file to map
+     * @param copyOnWrite true to allow writes to the mapping, which never reach the file
+     */
+    explicit MappedFile(const string &path, bool copyOnWrite = false);
+
+    /**
+     * @brief Creates a closed mapping, e.g. to move another one into later.
+     */
+    MappedFile() = default;
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    ~MappedFile();
+
+    /**
+     * @brief Checks if the file could be opened. Empty files count as open.
+     *
+     * @return bool True if the file exists and is readable.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Views the contents of the file.
+     *
+     * @return Span<const char> The mapped bytes, valid as long as this object is alive.
+     */
+    Span<const char> contents() const;
+
+    /**
+     * @brief Views the contents of a copy-on-write mapping for writing.
+     *
+     * @return Span<char> The mapped bytes, empty if the file isn't mapped copy-on-write.
+     */
+    Span<char> writableContents();
+
+    /**
+     * @brief Returns the size of the file in bytes.
+     */
+    size_t size() const;
+
+private:
+    void *mapping = nullptr; ///< start of the mapping, nullptr for closed or empty files
+    size_t length = 0;       ///< length of the mapping
+    bool opened = false;     ///< true if the file could be opened
+    bool writable = false;   ///< true for copy-on-write mappings
+
+    void unmap();
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef NODE_ORDERING_HPP
+#define NODE_ORDERING_HPP
+
+#include <string>
+#include <vector>
+
+#include "interfaces/IEdges.hpp"
+
+using namespace std;
+
+/**
+ * @brief Order in which the nodes of a graph are numbered internally.
+ *
+ * Traversals touch the adjacency lists and feature rows of neighboring nodes one after another.
+ * Giving neighbors close IDs keeps those accesses close in memory.
+ */
+enum class NodeOrder
+{
+    Input,  ///< keep the IDs of the input files
+    Degree, ///< descending degree, so the rows of frequently visited hubs share cache lines
+    RCM,    ///< reverse Cuthill-McKee, minimizes the ID distance between neighbors
+    BFS     ///< breadth-first visiting order, one component after another
+};
+
+/**
+ * @brief Parses the name of a node order, case-insensitive.
+ *
+ * @param name one of "input", "degree", "rcm" or "bfs"
+ * @return NodeOrder the matching order
+ * @throws invalid_argument if the name is unknown
+ */
+NodeOrder parseNodeOrder(const string &name);
+
+/**
+ * @brief Computes a new numbering for a set of nodes.
+ *
+ * @param edges the edges between the nodes, indexed by the current IDs
+ * @param nodes the current IDs of all nodes to number, each exactly once
+ * @param order the order to compute
+ * @return vector<int> The current IDs in their new order, the new ID of a node is its position.
+ */
+vector<int> computeNodeOrder(const IEdges &edges, const vector<int> &nodes, NodeOrder order);
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef NUMPY_WRITER_HPP
+#define NUMPY_WRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Graph.hpp"
+
+using namespace std;
+
+/**
+ * @brief A contiguous C-order array to be written in the NumPy format, referencing data owned elsewhere.
+ */
+struct NumpyArray
+{
+    string name;          ///< name of the array inside an .npz archive or suffix of an .npy file
+    string descr;         ///< NumPy type string, e.g. "<f8"
+    vector<size_t> shape; ///< size of each dimension
+    const void *data;     ///< first element
+    size_t bytes;         ///< size of the data in bytes
+};
+
+/**
+ * @brief Type strings of the element types that can be written.
+ */
+template <typename T>
+struct NumpyType;
+
+template <>
+struct NumpyType<double>
+{
+    static constexpr char kind = 'f';
+};
+
+template <>
+struct NumpyType<float>
+{
+    static constexpr char kind = 'f';
+};
+
+template <>
+struct NumpyType<int32_t>
+{
+    static constexpr char kind = 'i';
+};
+
+template <>
+struct NumpyType<int64_t>
+{
+    static constexpr char kind = 'i';
+};
+
+/**
+ * @brief Byte order character of this machine in NumPy type strings.
+ */
+char numpyByteOrder();
+
+/**
+ * @brief Describes an array of T for writeNpy() or writeNpz().
+ *
+ * @param name name of the array
+ * @param data first element, has to stay alive until the array is written
+ * @param shape size of each dimension
+ */
+template <typename T>
+NumpyArray numpyArray(const string &name, const T *data, const vector<size_t> &shape)
+{
+    size_t count = 1;
+    for (size_t dimension : shape)
+    {
+        count *= dimension;
+    }
+    return NumpyArray{name, string(1, numpyByteOrder()) + NumpyType<T>::kind + to_string(sizeof(T)), shape, data, count * sizeof(T)};
+}
+
+/**
+ * @brief Writes one array as .npy file (format version 1.0).
+ *
+ * The data is written in one piece behind the header, without any conversion.
+ *
+ * @throws runtime_error if the file can't be written
+ */
+void writeNpy(const string &fileName, const NumpyArray &array);
+
+/**
+ * @brief Writes several arrays as uncompressed .npz archive, as numpy.savez does.
+ *
+ * @throws runtime_error if the file can't be written, overflow_error if the archive would need zip64
+ */
+void writeNpz(const string &fileName, const vector<NumpyArray> &arrays);
+
+/**
+ * @class NumpyGraphExport
+ * @brief Collects the results of a strategy as NumPy arrays.
+ *
+ * The arrays are, all in slot order of the graph:
+ * - node_ids: the IDs of the input files
+ * - features: the N x featureCount feature matrix, NaN where a feature is still missing
+ * - labels: the label of each node
+ * - embeddings: if added, the N x dimensions embeddings, NaN for nodes without one
+ *
+ * The feature matrix is written straight from the graph, so the graph has to outlive the export.
+ */
+class NumpyGraphExport
+{
+public:
+    explicit NumpyGraphExport(const Graph &graph);
+
+    /**
+     * @brief Adds the embeddings of a strategy as fourth array.
+     *
+     * @param embeddings <nodeID, embeddingVector> as learned by an EmbeddingStrategy
+     */
+    void addEmbeddings(const unordered_map<int, vector<double>> &embeddings);
+
+    /**
+     * @brief Describes the collected arrays.
+     */
+    vector<NumpyArray> arrays() const;
+
+    /**
+     * @brief Writes every array to its own file <prefix>_<name>.npy.
+     */
+    void saveNpy(const string &prefix) const;
+
+    /**
+     * @brief Writes all arrays into one .npz archive.
+     */
+    void saveNpz(const string &fileName) const;
+
+private:
+    const Graph &graph;
+    vector<int32_t> nodeIds;
+    vector<int32_t> labels;
+    vector<double> embeddingMatrix;
+    size_t embeddingDimensions = 0;
+};
+
+#endif
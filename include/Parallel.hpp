@@ -0,0 +1,94 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Number of threads to use if nothing else is configured.
+ *
+ * @return unsigned The number of hardware threads, at least 1.
+ */
+inline unsigned defaultThreadCount()
+{
+    unsigned hardwareThreads = thread::hardware_concurrency();
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
+
+/**
+ * @brief Splits [begin, end) into one contiguous chunk per thread and processes the chunks concurrently.
+ *
+ * The calling thread works on the first chunk itself. Returns once all chunks are done,
+ * an exception thrown by any chunk is rethrown afterwards.
+ *
+ * @param begin first index
+ * @param end one past the last index
+ * @param threads number of threads, 0 means defaultThreadCount()
+ * @param body callable as body(chunkBegin, chunkEnd, threadIndex)
+ */
+template <typename Body>
+void parallelFor(size_t begin, size_t end, unsigned threads, Body &&body)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+    if (threads == 0)
+    {
+        threads = defaultThreadCount();
+    }
+
+    size_t count = end - begin;
+    threads = static_cast<unsigned>(min<size_t>(threads, count));
+    if (threads <= 1)
+    {
+        body(begin, end, 0u);
+        return;
+    }
+
+    size_t chunkSize = (count + threads - 1) / threads;
+    vector<exception_ptr> errors(threads);
+    vector<thread> workers;
+    workers.reserve(threads - 1);
+
+    auto runChunk = [&](unsigned threadIndex)
+    {
+        size_t chunkBegin = begin + threadIndex * chunkSize;
+        size_t chunkEnd = min(end, chunkBegin + chunkSize);
+        try
+        {
+            if (chunkBegin < chunkEnd)
+            {
+                body(chunkBegin, chunkEnd, threadIndex);
+            }
+        }
+        catch (...)
+        {
+            errors[threadIndex] = current_exception();
+        }
+    };
+
+    for (unsigned threadIndex = 1; threadIndex < threads; threadIndex++)
+    {
+        workers.emplace_back(runChunk, threadIndex);
+    }
+    runChunk(0);
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    for (auto &error : errors)
+    {
+        if (error)
+        {
+            rethrow_exception(error);
+        }
+    }
+}
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,93 @@
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class Span
+ * @brief Non-owning view over a contiguous range of elements.
+ *
+ * Minimal stand-in for C++20's std::span, used to hand out rows of the feature
+ * matrix and slices of adjacency arrays without copying them.
+ * A Span is only valid as long as the storage it points into is alive and not reallocated.
+ *
+ * @tparam T element type, const-qualified for read-only views
+ */
+template <typename T>
+class Span
+{
+public:
+    using element_type = T;
+    using value_type = remove_cv_t<T>;
+    using iterator = T *;
+
+    Span() = default;
+
+    Span(T *data, size_t size) : ptr(data), count(size) {}
+
+    Span(T *first, T *last) : ptr(first), count(static_cast<size_t>(last - first)) {}
+
+    /**
+     * @brief Views the whole content of a vector.
+     */
+    template <typename Allocator>
+    Span(vector<value_type, Allocator> &values) : ptr(values.data()), count(values.size()) {}
+
+    template <typename Allocator, typename U = T, typename = enable_if_t<is_const_v<U>>>
+    Span(const vector<value_type, Allocator> &values) : ptr(values.data()), count(values.size()) {}
+
+    /**
+     * @brief Allows implicit conversion from Span<double> to Span<const double>.
+     */
+    template <typename U, typename = enable_if_t<is_convertible_v<U (*)[], T (*)[]>>>
+    Span(const Span<U> &other) : ptr(other.data()), count(other.size()) {}
+
+    T *data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T &operator[](size_t index) const { return ptr[index]; }
+    T &front() const { return ptr[0]; }
+    T &back() const { return ptr[count - 1]; }
+
+    iterator begin() const { return ptr; }
+    iterator end() const { return ptr + count; }
+
+    /**
+     * @brief Copies the viewed elements, e.g. for APIs that still work with vectors.
+     */
+    vector<value_type> toVector() const { return vector<value_type>(ptr, ptr + count); }
+
+private:
+    T *ptr = nullptr;
+    size_t count = 0;
+};
+
+template <typename T, typename Allocator>
+bool operator==(const Span<T> &span, const vector<remove_cv_t<T>, Allocator> &values)
+{
+    if (span.size() != values.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < span.size(); i++)
+    {
+        if (!(span[i] == values[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Allocator>
+bool operator!=(const Span<T> &span, const vector<remove_cv_t<T>, Allocator> &values)
+{
+    return !(span == values);
+}
+
+#endif // SPAN_HPP
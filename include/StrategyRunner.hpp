@@ -2,11 +2,16 @@
 #define STRATEGIERUNNER_HPP
 
 #include "Graph.hpp"
+#include "FeatureWriter.hpp"
+#include "NumpyWriter.hpp"
+#include "EmbeddingStrategy.hpp"
 
 #include <fstream>
 #include <map>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
 
 using namespace std;
 
@@ -64,44 +69,66 @@ public:
     /**
      * @brief Saves the interpreted features to a .txt file.
      *
-     * This function takes the original node file and processes it to interpret the features.
-     * The interpreted features replace the placeholder '#' in the original file.
+     * Every node becomes a line "id\tf1, f2, ...\tlabel" like in the node files, missing features are written as 0.0.
      *
-     * @param fileName The name of the file where the interpreted features will be saved.
+     * @param graph The graph whose features are saved.
+     * @param filename The name of the file where the interpreted features will be saved.
+     * @param fixedPrecision Digits after the decimal point, -1 for 6 significant digits like ostream prints them.
      */
-    void saveFeatures(const shared_ptr<Graph> graph, const string &filename) const
+    void saveFeatures(const shared_ptr<Graph> graph, const string &filename, int fixedPrecision = -1) const
     {
-        ofstream outFile(filename);
-        if (!outFile.is_open())
+        FeatureWriterOptions options;
+        options.fixedPrecision = fixedPrecision;
+        if (!FeatureWriter(options).write(*graph, filename))
         {
             cerr << "Failed to open file for writing: " << filename << endl;
-            return;
         }
+    }
 
-        // outFile << "node_id\tfeature\tlabel" << endl;
+    /**
+     * @brief Saves node IDs, features and labels as binary .npy files <prefix>_node_ids.npy, <prefix>_features.npy and <prefix>_labels.npy.
+     *
+     * Values are written as they are stored, so nothing is lost and missing features stay NaN.
+     *
+     * @param graph The graph whose features are saved.
+     * @param prefix Path prefix of the files.
+     * @param withEmbeddings Whether to also save the learned embeddings as <prefix>_embeddings.npy.
+     * @throws runtime_error if a file can't be written, logic_error if the strategy learns no embeddings.
+     */
+    void saveNpy(const shared_ptr<Graph> graph, const string &prefix, bool withEmbeddings = false) const
+    {
+        numpyExport(*graph, withEmbeddings).saveNpy(prefix);
+    }
 
-        for (const auto &nodeId : graph->getNodes())
+    /**
+     * @brief Saves the arrays of saveNpy() into one uncompressed .npz archive, as numpy.savez does.
+     *
+     * @param graph The graph whose features are saved.
+     * @param filename The archive to write.
+     * @param withEmbeddings Whether to also save the learned embeddings.
+     * @throws runtime_error if the file can't be written, logic_error if the strategy learns no embeddings.
+     */
+    void saveNpz(const shared_ptr<Graph> graph, const string &filename, bool withEmbeddings = false) const
+    {
+        numpyExport(*graph, withEmbeddings).saveNpz(filename);
+    }
+
+private:
+    NumpyGraphExport numpyExport(const Graph &graph, bool withEmbeddings) const
+    {
+        NumpyGraphExport result(graph);
+        if (withEmbeddings)
         {
-            outFile << nodeId << "\t";
-            const auto &features = graph->getFeatureById(nodeId);
-            for (size_t i = 0; i < features.size(); ++i)
+            if constexpr (is_base_of_v<EmbeddingStrategy, Strategy>)
             {
-                if (isnan(features[i])) {
-                    outFile << "0.0";
-                }
-                else {
-                    outFile << features[i];
-                }
-
-                if (i != features.size() - 1)
-                {
-                    outFile << ", ";
-                }
+                result.addEmbeddings(strategy.getEmbeddings());
+            }
+            else
+            {
+                throw logic_error("this strategy doesn't learn embeddings");
             }
-            outFile << "\t" << graph->getLabelById(nodeId) << endl;
         }
-
-        outFile.close();
+        return result;
     }
 };
 
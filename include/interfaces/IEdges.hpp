@@ -1,11 +1,22 @@
 #ifndef IEDGES_HPP
 #define IEDGES_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
 #include <utility>
 #include <vector>
 
+#include "Span.hpp"
+
 using namespace std;  
 
+/**
+ * Position in a CSR adjacency array. 64 bits wide, so graphs with more than 2^31 adjacency entries fit,
+ * while node IDs stay int: the offsets only cost one word per node, the IDs one per adjacency entry.
+ */
+using EdgeOffset = uint64_t;
+
 /**
  * @class IEdges
  * @brief Abstract interface for managing graph edges.
@@ -27,6 +38,18 @@ public:
      */
     virtual vector<int> getNeighbors(int nodeID) = 0;
 
+    /**
+     * @brief Views the neighbors of a given node without copying them.
+     *
+     * The neighbors are sorted ascending. Implementations storing adjacency lists contiguously
+     * return a view into their storage, which stays valid until the edges are modified.
+     * Other implementations return a thread-local buffer, valid until the next call on the same thread.
+     *
+     * @param nodeID The ID of the node whose neighbors are to be retrieved.
+     * @return Span<const int> The neighboring node IDs.
+     */
+    virtual Span<const int> neighbors(int nodeID) const = 0;
+
     /**
      * @brief Checks if an edge exists between two nodes.
      *
@@ -38,6 +61,39 @@ public:
      */
     virtual bool isEdge(int source, int destination) = 0;
 
+    /**
+     * @brief Checks many node pairs for edges at once.
+     *
+     * The queries are answered in order of their source node, so the list of each source
+     * is only touched once. Implementations may override this with a faster batched search.
+     *
+     * @param queries pairs of source and destination node IDs
+     * @return vector<bool> Entry i is true if there is an edge between the nodes of queries[i].
+     */
+    virtual vector<bool> areEdges(Span<const pair<int, int>> queries)
+    {
+        vector<bool> result(queries.size());
+
+        if (is_sorted(queries.begin(), queries.end()))
+        {
+            for (size_t i = 0; i < queries.size(); i++)
+            {
+                result[i] = isEdge(queries[i].first, queries[i].second);
+            }
+            return result;
+        }
+
+        vector<size_t> order(queries.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](size_t a, size_t b)
+             { return queries[a] < queries[b]; });
+        for (size_t i : order)
+        {
+            result[i] = isEdge(queries[i].first, queries[i].second);
+        }
+        return result;
+    }
+
     /**
      * @brief Retrieves all edges in the graph.
      *
@@ -50,9 +106,9 @@ public:
     /**
      * @brief Returns number of stored edges
      *
-     * @return int Number of stored edges
+     * @return size_t Number of stored edges
      */
-    virtual int size() = 0;
+    virtual size_t size() const = 0;
 
     /**
      * @brief Adds a new edge to the edge list.
@@ -79,6 +135,17 @@ public:
      */
     virtual double getWeight(int source, int destination) const = 0;
 
+    /**
+     * @brief Views the weights of the edges to the neighbors of a given node.
+     *
+     * Entry i is the weight of the edge to neighbors(nodeID)[i], NaN if no weight has been set.
+     * The view has the same lifetime as the one returned by neighbors().
+     *
+     * @param nodeID The ID of the node whose edge weights are to be retrieved.
+     * @return Span<const double> The weights aligned with the neighbors of the node.
+     */
+    virtual Span<const double> weights(int nodeID) const = 0;
+
     // Virtual destructor to ensure proper cleanup of derived classes
     virtual ~IEdges() = default;
 };
@@ -44,12 +44,37 @@ public:
      */
     virtual void reset() = 0;
 
+    /**
+     * @brief Fills the missing features of a node with the mean of the known features of similar nodes.
+     *
+     * @param nodeId The ID of the node whose missing features are guessed.
+     * @param similarNodes The feature vectors of the similar nodes.
+     */
     void guessFeatures(int nodeId, const vector<vector<double>>& similarNodes) {
         if (!graph) return;
 
-        vector<double> nodeFeatures = graph->getFeatureById(nodeId);
-        bool featuresUpdated = false;
+        fillMissingFeatures(graph->featureRowById(nodeId), similarNodes);
+    }
+
+    /**
+     * @copydoc guessFeatures(int, const vector<vector<double>>&)
+     *
+     * Overload for rows viewed directly in the feature matrix of the graph, so no feature vector is copied.
+     */
+    void guessFeatures(int nodeId, const vector<Span<const double>>& similarNodes) {
+        if (!graph) return;
 
+        fillMissingFeatures(graph->featureRowById(nodeId), similarNodes);
+    }
+
+protected:
+    /**
+     * @brief Replaces every NaN in nodeFeatures by the mean over the non-NaN values of the same column in similarNodes.
+     *
+     * Writes directly into the row, columns without any known value among the similar nodes stay NaN.
+     */
+    template <typename Rows>
+    static void fillMissingFeatures(Span<double> nodeFeatures, const Rows& similarNodes) {
         for (size_t i = 0; i < nodeFeatures.size(); ++i) {
             if (isnan(nodeFeatures[i])) {  
                 double sum = 0.0;
@@ -64,17 +89,11 @@ public:
 
                 if (count > 0) {
                     nodeFeatures[i] = sum / count;
-                    featuresUpdated = true;
                 }
             }
         }
-
-        if (featuresUpdated) {
-            graph->updateFeatureById(nodeId, nodeFeatures);
-        }
     }
 
-protected:
     shared_ptr<Graph> graph; ///< The input graph for the strategy.
 };
 
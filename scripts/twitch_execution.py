@@ -6,15 +6,23 @@ import os
 input_dir = os.path.join("input", "twitch")
 edges_file = os.path.join(input_dir, "twitch_edges.txt")  
 nodes_file = os.path.join(input_dir, "twitch_features.txt")  
+snapshot_file = os.path.join("output", "twitch.graph")
 
-# Check if files exist
+# Read the files straight from the archive if they haven't been extracted
 if not (os.path.exists(edges_file) and os.path.exists(nodes_file)):
-    print("Error: Input files not found!")
-    exit(1)
+    archive = os.path.join("input", "twitch.zip")
+    if not os.path.exists(archive):
+        print("Error: Input files not found!")
+        exit(1)
+    edges_file = f"{archive}!/twitch_edges.txt"
+    nodes_file = f"{archive}!/twitch_features.txt"
+
+# Parse the text files once, each strategy loads the binary snapshot
+semProject.Graph(nodes_file, edges_file).save(snapshot_file)
 
 # Test KNN
 print("Testing KNN...")
-graph = semProject.Graph(nodes_file, edges_file)
+graph = semProject.Graph(snapshot_file)
 knn = semProject.KNN(graph)
 # knn.configure()  # Configure if needed
 knn.run()
@@ -26,7 +34,7 @@ print("KNN Results:", results_knn)
 
 # Test Topo2Vec
 print("Testing Topo2Vec...")
-graph = semProject.Graph(nodes_file, edges_file)
+graph = semProject.Graph(snapshot_file)
 topo2vec = semProject.Topo2Vec(graph)
 # topo2vec.configure()  # Configure if needed
 topo2vec.run()
@@ -36,7 +44,7 @@ print("Topo2Vec Results:", results_t2v)
 
 # Test AttributedDeepwalk
 print("Testing AttributedDeepwalk...")
-graph = semProject.Graph(nodes_file, edges_file)
+graph = semProject.Graph(snapshot_file)
 deepwalk = semProject.AttributedDeepwalk(graph)
 # deepwalk.configure()  # Configure if needed
 deepwalk.run()
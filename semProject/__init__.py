@@ -5,6 +5,6 @@ import os
 # Add the root directory of your project to the sys.path
 sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), "..")))
 
-from .semProject import Graph, AttributedDeepwalk, KNN, Topo2Vec
+from .semProject import Graph, LoadTimings, NodeOrder, SnapshotAccess, ExternalCsrStats, build_csr_file, AttributedDeepwalk, KNN, FeatureKNN, Topo2Vec
 
-__all__ = ["Graph", "AttributedDeepwalk", "KNN", "Topo2Vec"]
\ No newline at end of file
+__all__ = ["Graph", "LoadTimings", "NodeOrder", "SnapshotAccess", "ExternalCsrStats", "build_csr_file", "AttributedDeepwalk", "KNN", "FeatureKNN", "Topo2Vec"]
\ No newline at end of file
@@ -1,26 +1,46 @@
 #include "AdjacencyArrayEdges.hpp"
+#include "Parallel.hpp"
 
 #include <limits>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
 
 /*
  * =========== constructors ===============
  */
 AdjacencyArrayEdges::~AdjacencyArrayEdges() = default;
 
-AdjacencyArrayEdges::AdjacencyArrayEdges(const std::vector<std::pair<int, int>> &initialEdges)
+AdjacencyArrayEdges::AdjacencyArrayEdges(const std::vector<std::pair<int, int>> &initialEdges, const CsrBuildOptions &options)
 {
-    // 1: create adjacency list
-    std::unordered_map<int, std::vector<int>> adjacencyList;
-    for (auto [source, dest] : initialEdges)
+    auto startTime = std::chrono::steady_clock::now();
+
+    buildFromEdgeList(initialEdges, options);
+    edgeWeights.assign(adjacencyArray.size(), std::numeric_limits<double>::quiet_NaN());
+
+    size_t finalBytes = adjacencyOffsets.size() * sizeof(EdgeOffset) + adjacencyArray.size() * sizeof(int) + edgeWeights.size() * sizeof(double);
+    buildStats.peakBytes = std::max(buildStats.peakBytes, finalBytes);
+    buildStats.buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+AdjacencyArrayEdges::AdjacencyArrayEdges(std::vector<EdgeOffset> offsets, std::vector<int> adjacency, std::vector<double> weights)
+    : adjacencyOffsets(std::move(offsets)), adjacencyArray(std::move(adjacency)), edgeWeights(std::move(weights))
+{
+    if (adjacencyOffsets.empty())
     {
-        if (dest < source)
-            std::swap(source, dest);
-        adjacencyList[source].push_back(dest);
-        adjacencyList[dest].push_back(source);
+        adjacencyOffsets.push_back(0);
     }
-
-    fillAdjacencyArrayFromList(adjacencyList);
+    if (adjacencyOffsets.back() != adjacencyArray.size())
+    {
+        throw std::invalid_argument("The offsets end at " + std::to_string(adjacencyOffsets.back()) + ", but there are " + std::to_string(adjacencyArray.size()) + " adjacency entries");
+    }
+    if (edgeWeights.size() != adjacencyArray.size())
+    {
+        edgeWeights.assign(adjacencyArray.size(), std::numeric_limits<double>::quiet_NaN());
+    }
+    selfLoopCount = countSelfLoops();
 }
 
 /*
@@ -34,81 +54,174 @@ void AdjacencyArrayEdges::addEdge(int source, int destination)
         return;
     }
 
-    // add source->dest
-    adjacencyArray.insert(adjacencyArray.begin() + adjacencyOffsets[source], destination);
+    // grow offsets for nodes that had no edges so far, offsets has one end marker more than there are nodes
+    size_t requiredOffsets = static_cast<size_t>(std::max(source, destination)) + 2;
+    if (adjacencyOffsets.size() < requiredOffsets)
+    {
+        adjacencyOffsets.resize(requiredOffsets, adjacencyArray.size());
+    }
 
-    if (source + 1 < adjacencyArray.size())
+    // add source->dest and dest->source, keeping each adjacency list sorted
+    for (auto [from, to] : {std::make_pair(source, destination), std::make_pair(destination, source)})
     {
-        for (int i = source + 1; i < adjacencyArray.size(); i++)
+        auto listBegin = adjacencyArray.begin() + adjacencyOffsets[from];
+        auto listEnd = adjacencyArray.begin() + adjacencyOffsets[from + 1];
+        auto insertPosition = std::lower_bound(listBegin, listEnd, to);
+        edgeWeights.insert(edgeWeights.begin() + (insertPosition - adjacencyArray.begin()), std::numeric_limits<double>::quiet_NaN());
+        adjacencyArray.insert(insertPosition, to);
+
+        for (size_t i = from + 1; i < adjacencyOffsets.size(); i++)
         {
             ++adjacencyOffsets[i];
         }
-    }
-
-    // add dest->source
-    adjacencyArray.insert(adjacencyArray.begin() + adjacencyOffsets[destination], source);
 
-    if (destination + 1 < adjacencyArray.size())
-    {
-        for (int i = destination + 1; i < adjacencyArray.size(); i++)
+        if (from == to)
         {
-            ++adjacencyOffsets[i];
+            selfLoopCount++;
+            break; // self-loops are stored once
         }
     }
+
+    if (hubMinDegree > 0)
+    {
+        enableHubBitmaps(hubMinDegree);
+    }
 }
 
 std::vector<int> AdjacencyArrayEdges::getNeighbors(int nodeID)
 {
-    std::vector<int> neighbors;
+    return neighbors(nodeID).toVector();
+}
 
-    if (nodeID >= adjacencyOffsets.size())
+bool AdjacencyArrayEdges::isEdge(int source, int destination)
+{
+    if (source < 0 || destination < 0 || static_cast<size_t>(source) >= getNodeCount())
+    {
+        return false; // Source node is invalid
+    }
+    if (!hubBitmapSlot.empty() && hubBitmapSlot[source] >= 0)
     {
-        return neighbors; // Return empty vector if nodeID is invalid
+        return testHubBit(source, destination);
     }
 
-    int startAdjacents = adjacencyOffsets[nodeID];
-    int endAdjacents = (nodeID + 1 < adjacencyOffsets.size()) ? adjacencyOffsets[nodeID + 1] : adjacencyArray.size();
+    return findEdge(source, destination) >= 0;
+}
+
+std::vector<bool> AdjacencyArrayEdges::areEdges(Span<const std::pair<int, int>> queries)
+{
+    std::vector<bool> result(queries.size());
 
-    for (int offset = startAdjacents; offset < endAdjacents; offset++)
+    std::vector<size_t> order(queries.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (!std::is_sorted(queries.begin(), queries.end()))
     {
-        neighbors.push_back(adjacencyArray[offset]);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                  { return queries[a] < queries[b]; });
     }
 
-    return neighbors;
+    size_t nodeCount = getNodeCount();
+    for (size_t groupBegin = 0; groupBegin < order.size();)
+    {
+        int source = queries[order[groupBegin]].first;
+        size_t groupEnd = groupBegin + 1;
+        while (groupEnd < order.size() && queries[order[groupEnd]].first == source)
+        {
+            groupEnd++;
+        }
+
+        if (source >= 0 && static_cast<size_t>(source) < nodeCount)
+        {
+            bool isHub = !hubBitmapSlot.empty() && hubBitmapSlot[source] >= 0;
+            Span<const int> adjacents = neighbors(source);
+            const int *position = adjacents.begin();
+
+            for (size_t i = groupBegin; i < groupEnd; i++)
+            {
+                int destination = queries[order[i]].second;
+                if (destination < 0)
+                {
+                    continue;
+                }
+                if (isHub)
+                {
+                    result[order[i]] = testHubBit(source, destination);
+                    continue;
+                }
+
+                // destinations are ascending, so gallop forward from the last match position
+                size_t step = 1;
+                const int *bound = position;
+                while (bound < adjacents.end() && *bound < destination)
+                {
+                    position = bound + 1;
+                    bound = (static_cast<size_t>(adjacents.end() - bound) > step) ? bound + step : adjacents.end();
+                    step *= 2;
+                }
+                position = std::lower_bound(position, bound, destination);
+                result[order[i]] = position != adjacents.end() && *position == destination;
+            }
+        }
+        groupBegin = groupEnd;
+    }
+
+    return result;
 }
 
-bool AdjacencyArrayEdges::isEdge(int source, int destination)
+void AdjacencyArrayEdges::enableHubBitmaps(size_t minDegree)
 {
-    if (source >= adjacencyOffsets.size())
+    hubMinDegree = minDegree;
+    hubBitmapSlot.clear();
+    hubBitmaps.clear();
+    hubBitmapWords = 0;
+    if (minDegree == 0)
     {
-        return false; // Source node is invalid
+        return;
     }
 
-    // Define start and end indices correctly
-    int startAdjacents = adjacencyOffsets[source];
-    int endAdjacents = (source + 1 < adjacencyOffsets.size()) ? adjacencyOffsets[source + 1] : adjacencyArray.size();
+    size_t nodeCount = getNodeCount();
+    hubBitmapWords = (nodeCount + 63) / 64;
+    hubBitmapSlot.assign(nodeCount, -1);
 
-    for (int offset = startAdjacents; offset < endAdjacents; offset++)
+    int hubCount = 0;
+    for (size_t node = 0; node < nodeCount; node++)
     {
-        if (adjacencyArray[offset] == destination)
+        if (static_cast<size_t>(adjacencyOffsets[node + 1] - adjacencyOffsets[node]) >= minDegree)
         {
-            return true;
+            hubBitmapSlot[node] = hubCount++;
         }
     }
+    if (hubCount == 0)
+    {
+        hubBitmapSlot.clear();
+        return;
+    }
 
-    return false;
+    hubBitmaps.assign(hubCount * hubBitmapWords, 0);
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        if (hubBitmapSlot[node] < 0)
+        {
+            continue;
+        }
+        uint64_t *bitmap = hubBitmaps.data() + hubBitmapSlot[node] * hubBitmapWords;
+        for (int neighbor : neighbors(static_cast<int>(node)))
+        {
+            bitmap[neighbor / 64] |= uint64_t(1) << (neighbor % 64);
+        }
+    }
 }
 
 std::vector<std::pair<int, int>> AdjacencyArrayEdges::getEdges() const
 {
     std::vector<std::pair<int, int>> edgesVector;
 
-    for (int currentNode = 0; currentNode < adjacencyOffsets.size(); currentNode++)
+    for (size_t node = 0; node < adjacencyOffsets.size(); node++)
     {
-        int startAdjacents = adjacencyOffsets[currentNode];
-        int endAdjacents = (currentNode + 1 < adjacencyOffsets.size()) ? adjacencyOffsets[currentNode + 1] : adjacencyArray.size();
+        int currentNode = static_cast<int>(node);
+        EdgeOffset startAdjacents = adjacencyOffsets[node];
+        EdgeOffset endAdjacents = (node + 1 < adjacencyOffsets.size()) ? adjacencyOffsets[node + 1] : adjacencyArray.size();
 
-        for (int offset = startAdjacents; offset < endAdjacents; offset++)
+        for (EdgeOffset offset = startAdjacents; offset < endAdjacents; offset++)
         {
             int currentNodeNeighbor = adjacencyArray[offset];
 
@@ -125,82 +238,220 @@ std::vector<std::pair<int, int>> AdjacencyArrayEdges::getEdges() const
 
 void AdjacencyArrayEdges::setWeight(int source, int destination, double weight)
 {
-    if (destination < source)
+    long forward = findEdge(source, destination);
+    if (forward < 0)
     {
-        std::swap(source, destination);
+        return; // only existing edges can be weighted
     }
 
-    weights[{source, destination}] = weight;
+    // the edge is undirected, so both stored directions carry the weight
+    edgeWeights[forward] = weight;
+    edgeWeights[findEdge(destination, source)] = weight;
 }
 
 double AdjacencyArrayEdges::getWeight(int source, int destination) const
 {
-    if (destination < source)
+    long position = findEdge(source, destination);
+    if (position >= 0)
     {
-        std::swap(source, destination);
-    }
-    auto it = weights.find({source, destination});
-    if (it != weights.end())
-    {
-        return it->second;
+        return edgeWeights[position];
     }
 
     return std::numeric_limits<double>::quiet_NaN(); // Return NaN if the edge does not exist
 }
 
-int AdjacencyArrayEdges::size()
+size_t AdjacencyArrayEdges::size() const
+{
+    return (adjacencyArray.size() + selfLoopCount) / 2; // every entry but a self-loop has a mirrored one
+}
+
+size_t AdjacencyArrayEdges::getNodeCount() const
+{
+    return adjacencyOffsets.empty() ? 0 : adjacencyOffsets.size() - 1;
+}
+
+const CsrBuildStats &AdjacencyArrayEdges::getBuildStats() const
 {
-    return adjacencyArray.size() / 2;
+    return buildStats;
+}
+
+Span<const EdgeOffset> AdjacencyArrayEdges::csrOffsets() const
+{
+    return Span<const EdgeOffset>(adjacencyOffsets.data(), adjacencyOffsets.size());
+}
+
+Span<const int> AdjacencyArrayEdges::csrAdjacency() const
+{
+    return Span<const int>(adjacencyArray.data(), adjacencyArray.size());
+}
+
+Span<const double> AdjacencyArrayEdges::csrWeights() const
+{
+    return Span<const double>(edgeWeights.data(), edgeWeights.size());
+}
+
+size_t AdjacencyArrayEdges::memoryUsage() const
+{
+    return adjacencyOffsets.capacity() * sizeof(EdgeOffset) + adjacencyArray.capacity() * sizeof(int) + edgeWeights.capacity() * sizeof(double) + hubBitmapSlot.capacity() * sizeof(int) + hubBitmaps.capacity() * sizeof(uint64_t);
 }
 
 /*
  * ========= helper methods ============
  */
- void AdjacencyArrayEdges::fillAdjacencyArrayFromList(const std::unordered_map<int, std::vector<int>> &adjacencyList)
- {
-     // Determine the maximum node id from both keys and neighbor values.
-     int maxNode = 0;
-     for (const auto &entry : adjacencyList)
-     {
-         maxNode = std::max(maxNode, entry.first);
-         for (int neighbor : entry.second)
-         {
-             maxNode = std::max(maxNode, neighbor);
-         }
-     }
- 
-     // Create a vector of vectors (one for each node id from 0 to maxNode)
-     std::vector<std::vector<int>> fullAdjList(maxNode + 1);
-     
-     // Fill fullAdjList using the provided adjacencyList; nodes not in the map remain empty.
-     for (const auto &entry : adjacencyList)
-     {
-         fullAdjList[entry.first] = entry.second;
-     }
- 
-     // Calculate total number of adjacency entries.
-     int totalAdj = 0;
-     for (const auto &neighbors : fullAdjList)
-     {
-         totalAdj += neighbors.size();
-     }
- 
-     // Resize the flat array and offsets vector.
-     adjacencyArray.resize(totalAdj);
-     // Use offsets size = number of nodes + 1 (last element holds the total count)
-     adjacencyOffsets.resize(fullAdjList.size() + 1, 0);
- 
-     int offset = 0;
-     for (size_t i = 0; i < fullAdjList.size(); i++)
-     {
-         adjacencyOffsets[i] = offset;
-         // Optionally sort each node's neighbor list for consistency.
-         std::sort(fullAdjList[i].begin(), fullAdjList[i].end());
-         for (int neighbor : fullAdjList[i])
-         {
-             adjacencyArray[offset++] = neighbor;
-         }
-     }
-     adjacencyOffsets[fullAdjList.size()] = totalAdj; // End marker
- }
- 
\ No newline at end of file
+bool AdjacencyArrayEdges::testHubBit(int source, int destination) const
+{
+    if (static_cast<size_t>(destination) >= hubBitmapWords * 64)
+    {
+        return false;
+    }
+    const uint64_t *bitmap = hubBitmaps.data() + hubBitmapSlot[source] * hubBitmapWords;
+    return (bitmap[destination / 64] >> (destination % 64)) & 1;
+}
+
+size_t AdjacencyArrayEdges::countSelfLoops() const
+{
+    size_t loops = 0;
+    for (size_t node = 0; node < getNodeCount(); node++)
+    {
+        loops += findEdge(static_cast<int>(node), static_cast<int>(node)) >= 0;
+    }
+    return loops;
+}
+
+long AdjacencyArrayEdges::findEdge(int source, int destination) const
+{
+    Span<const int> adjacents = neighbors(source);
+    auto it = std::lower_bound(adjacents.begin(), adjacents.end(), destination);
+    if (it == adjacents.end() || *it != destination)
+    {
+        return -1;
+    }
+
+    return it - adjacencyArray.data();
+}
+
+void AdjacencyArrayEdges::buildFromEdgeList(const std::vector<std::pair<int, int>> &initialEdges, const CsrBuildOptions &options)
+{
+    unsigned threads = options.threads == 0 ? defaultThreadCount() : options.threads;
+    size_t edgeCount = initialEdges.size();
+
+    auto isStored = [&](int source, int destination)
+    {
+        return source >= 0 && destination >= 0 && !(options.dropSelfLoops && source == destination);
+    };
+
+    // 1: the highest node ID determines the number of adjacency lists
+    std::vector<int> maxNodePerThread(threads, -1);
+    std::vector<size_t> invalidPerThread(threads, 0), selfLoopsPerThread(threads, 0);
+    parallelFor(0, edgeCount, threads, [&](size_t begin, size_t end, unsigned threadIndex)
+                {
+        for (size_t i = begin; i < end; i++)
+        {
+            auto [source, destination] = initialEdges[i];
+            if (source < 0 || destination < 0)
+            {
+                invalidPerThread[threadIndex]++;
+                continue;
+            }
+            if (source == destination && options.dropSelfLoops)
+            {
+                selfLoopsPerThread[threadIndex]++;
+                continue;
+            }
+            maxNodePerThread[threadIndex] = std::max({maxNodePerThread[threadIndex], source, destination});
+        } });
+
+    int maxNode = *std::max_element(maxNodePerThread.begin(), maxNodePerThread.end());
+    size_t nodeCount = static_cast<size_t>(maxNode) + 1; // 0 if there is no valid edge
+    for (unsigned threadIndex = 0; threadIndex < threads; threadIndex++)
+    {
+        buildStats.skippedInvalidEdges += invalidPerThread[threadIndex];
+        buildStats.droppedSelfLoops += selfLoopsPerThread[threadIndex];
+    }
+
+    // 2: count the degree of each node. The counters become write cursors after the prefix sum
+    std::vector<std::atomic<EdgeOffset>> cursors(nodeCount);
+    parallelFor(0, edgeCount, threads, [&](size_t begin, size_t end, unsigned)
+                {
+        for (size_t i = begin; i < end; i++)
+        {
+            auto [source, destination] = initialEdges[i];
+            if (!isStored(source, destination))
+            {
+                continue;
+            }
+            cursors[source].fetch_add(1, std::memory_order_relaxed);
+            if (source != destination)
+            {
+                cursors[destination].fetch_add(1, std::memory_order_relaxed);
+            }
+        } });
+
+    // 3: prefix sum over the degrees gives the offsets, offsets has an end marker
+    adjacencyOffsets.assign(nodeCount + 1, 0);
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        EdgeOffset degree = cursors[node].load(std::memory_order_relaxed);
+        adjacencyOffsets[node + 1] = adjacencyOffsets[node] + degree;
+        cursors[node].store(adjacencyOffsets[node], std::memory_order_relaxed);
+    }
+
+    // 4: scatter both directions of every edge into the lists
+    adjacencyArray.assign(adjacencyOffsets[nodeCount], 0);
+    parallelFor(0, edgeCount, threads, [&](size_t begin, size_t end, unsigned)
+                {
+        for (size_t i = begin; i < end; i++)
+        {
+            auto [source, destination] = initialEdges[i];
+            if (!isStored(source, destination))
+            {
+                continue;
+            }
+            adjacencyArray[cursors[source].fetch_add(1, std::memory_order_relaxed)] = destination;
+            if (source != destination)
+            {
+                adjacencyArray[cursors[destination].fetch_add(1, std::memory_order_relaxed)] = source;
+            }
+        } });
+
+    size_t scatterBytes = adjacencyOffsets.size() * sizeof(EdgeOffset) + cursors.size() * sizeof(std::atomic<EdgeOffset>) + adjacencyArray.size() * sizeof(int);
+    std::vector<std::atomic<EdgeOffset>>().swap(cursors);
+
+    // 5: sort each list and drop duplicate edges, remembering the new list lengths
+    std::vector<EdgeOffset> uniqueDegrees(nodeCount);
+    parallelFor(0, nodeCount, threads, [&](size_t begin, size_t end, unsigned)
+                {
+        for (size_t node = begin; node < end; node++)
+        {
+            auto listBegin = adjacencyArray.begin() + adjacencyOffsets[node];
+            auto listEnd = adjacencyArray.begin() + adjacencyOffsets[node + 1];
+            std::sort(listBegin, listEnd);
+            uniqueDegrees[node] = static_cast<EdgeOffset>(std::unique(listBegin, listEnd) - listBegin);
+        } });
+
+    size_t sortBytes = adjacencyOffsets.size() * sizeof(EdgeOffset) + uniqueDegrees.size() * sizeof(EdgeOffset) + adjacencyArray.size() * sizeof(int);
+    buildStats.peakBytes = std::max(scatterBytes, sortBytes);
+
+    // 6: close the gaps left by duplicates. Lists only move to the left, so this works in place
+    EdgeOffset writePosition = 0;
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        EdgeOffset readPosition = adjacencyOffsets[node];
+        adjacencyOffsets[node] = writePosition;
+        if (readPosition != writePosition)
+        {
+            std::copy(adjacencyArray.begin() + readPosition, adjacencyArray.begin() + readPosition + uniqueDegrees[node], adjacencyArray.begin() + writePosition);
+        }
+        writePosition += uniqueDegrees[node];
+    }
+    adjacencyOffsets[nodeCount] = writePosition;
+    selfLoopCount = countSelfLoops();
+
+    buildStats.removedDuplicates = adjacencyArray.size() - writePosition;
+    if (buildStats.removedDuplicates > 0)
+    {
+        adjacencyArray.resize(writePosition);
+        adjacencyArray.shrink_to_fit();
+        buildStats.peakBytes = std::max(buildStats.peakBytes, sortBytes + adjacencyArray.size() * sizeof(int));
+    }
+}
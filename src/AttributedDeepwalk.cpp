@@ -33,11 +33,13 @@ void AttributedDeepwalk::run() {
 
         if (sample.empty()) continue;  // Ensuring there is at least one valid sample
 
-        vector<vector<double>> nodeList = getFeaturesOfSimilarNodes(embeddings, sample.begin()->second, coverDepth); 
+        vector<Span<const double>> nodeList = getFeaturesOfSimilarNodes(embeddings, sample.begin()->second, coverDepth); 
 
 
         guessFeatures(node, nodeList);
     }
+
+    learnedEmbeddings = move(rawEmbeddings);
 }
 
 
@@ -94,6 +96,7 @@ void AttributedDeepwalk::reset() {
     coverDepth = 2;
     walkLength = 80;
     walksPerNode = 10;
+    learnedEmbeddings.clear();
 }
 
 /*
@@ -117,12 +120,8 @@ void AttributedDeepwalk::computeAliasTables()
     // create alias table for each node
     for (int node : graph->getNodes())
     {
-        // 1: get weights of edges to neighbors
-        vector<double> neighborWeights;
-        for (int neighbor : graph->getNeighbors(node))
-        {
-            neighborWeights.push_back(graph->getEdgeWeight(node, neighbor));
-        }
+        // 1: get weights of edges to neighbors, stored aligned with the neighbors
+        Span<const double> neighborWeights = graph->edgeWeights(node);
 
         // 2: normalize to get transition probabilites resembling the edge weight
         double weightSum = 0;
@@ -218,8 +217,8 @@ void AttributedDeepwalk::computeAliasTables()
 
 double AttributedDeepwalk::measuring_attribute_similarity(int node1, int node2) const
 {
-    vector<double> featuresNode1 = graph->getFeatureById(node1);
-    vector<double> featuresNode2 = graph->getFeatureById(node2);
+    Span<const double> featuresNode1 = graph->featureRowById(node1);
+    Span<const double> featuresNode2 = graph->featureRowById(node2);
     double dotProduct = 0;
     double norm1 = 0;
     double norm2 = 0;
@@ -297,24 +296,27 @@ set<int> calculateCover(int node, int coverDepth, shared_ptr<Graph> graph)
     cover.insert(node);
     q.push({node, 0});
 
-    // perform BFS to specified depth
-    while (!q.empty())
+    // perform BFS to specified depth, on the concrete edge backend
+    graph->visitEdges([&](const auto &edges)
     {
-        auto [node, depth] = q.front();
-        q.pop();
+        while (!q.empty())
+        {
+            auto [node, depth] = q.front();
+            q.pop();
 
-        if (depth >= coverDepth)
-            continue;
+            if (depth >= coverDepth)
+                continue;
 
-        for (int neighbor : graph->getNeighbors(node))
-        {
-            if (!cover.count(neighbor))
+            for (int neighbor : edges.neighbors(node))
             {
-                q.push({neighbor, depth + 1});
-                cover.insert(neighbor);
+                if (!cover.count(neighbor))
+                {
+                    q.push({neighbor, depth + 1});
+                    cover.insert(neighbor);
+                }
             }
         }
-    }
+    });
 
     return cover;
 }
@@ -340,26 +342,27 @@ vector<int> AttributedDeepwalk::randomWalk(int startNodeID) {
     random_device rd;
     mt19937 gen(rd());
 
-    for (int i = 0; i < walkLength - 1; ++i) {
-        int current = walk.back();
-        vector<int> neighbors = graph->getNeighbors(current);
+    graph->visitEdges([&](const auto &edges) {
+        for (int i = 0; i < walkLength - 1; ++i) {
+            int current = walk.back();
+            Span<const int> neighbors = edges.neighbors(current);
 
-        // Stop walk if the node has no neighbors
-        if (neighbors.empty()) break;
+            // Stop walk if the node has no neighbors
+            if (neighbors.empty()) break;
 
-        // Ensure alias tables exist for the node
-        if (aliasTables.find(current) == aliasTables.end() || aliasTables[current].empty()) {
-            break;
-        }
-        
+            // Ensure alias tables exist for the node
+            auto aliasTable = aliasTables.find(current);
+            if (aliasTable == aliasTables.end() || aliasTable->second.empty()) {
+                break;
+            }
 
-        // Sample from precomputed alias table
-        const auto& aliasTable = aliasTables.at(current);
-        int neighborIdx = sampleFromAliasTable(aliasTable, gen);
-        int nextNode = neighbors[neighborIdx];
+            // Sample from precomputed alias table
+            int neighborIdx = sampleFromAliasTable(aliasTable->second, gen);
+            int nextNode = neighbors[neighborIdx];
 
-        walk.push_back(nextNode);
-    }
+            walk.push_back(nextNode);
+        }
+    });
 
     return walk;
 }
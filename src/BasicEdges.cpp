@@ -48,6 +48,28 @@ vector<int> BasicEdges::getNeighbors(int nodeID)
     return neighbors;
 }
 
+// Collects the neighbors into a reused buffer, as edges aren't stored per node
+Span<const int> BasicEdges::neighbors(int nodeID) const
+{
+    thread_local vector<int> neighborBuffer;
+    neighborBuffer.clear();
+
+    for (const auto &edge : edges)
+    {
+        if (get<0>(edge) == nodeID)
+        {
+            neighborBuffer.push_back(get<1>(edge));
+        }
+        else if (get<1>(edge) == nodeID)
+        {
+            neighborBuffer.push_back(get<0>(edge));
+        }
+    }
+    sort(neighborBuffer.begin(), neighborBuffer.end());
+
+    return Span<const int>(neighborBuffer);
+}
+
 // Checks if an edge exists between two nodes.
 bool BasicEdges::isEdge(int source, int destination)
 {
@@ -117,8 +139,44 @@ double BasicEdges::getWeight(int source, int destination) const
     return numeric_limits<double>::quiet_NaN(); // return standard value if not found
 }
 
+// Collects the weights in the order of the sorted neighbors
+Span<const double> BasicEdges::weights(int nodeID) const
+{
+    thread_local vector<pair<int, double>> weightedNeighbors;
+    thread_local vector<double> weightBuffer;
+    weightedNeighbors.clear();
+    weightBuffer.clear();
+
+    for (const auto &edge : edges)
+    {
+        if (get<0>(edge) == nodeID)
+        {
+            weightedNeighbors.emplace_back(get<1>(edge), get<2>(edge));
+        }
+        else if (get<1>(edge) == nodeID)
+        {
+            weightedNeighbors.emplace_back(get<0>(edge), get<2>(edge));
+        }
+    }
+    stable_sort(weightedNeighbors.begin(), weightedNeighbors.end(),
+                [](const pair<int, double> &a, const pair<int, double> &b)
+                { return a.first < b.first; });
+
+    for (const auto &[neighbor, weight] : weightedNeighbors)
+    {
+        weightBuffer.push_back(weight);
+    }
+
+    return Span<const double>(weightBuffer);
+}
+
 // Retrieves number of edges
-int BasicEdges::size()
+size_t BasicEdges::size() const
 {
     return edges.size();
 }
+
+size_t BasicEdges::memoryUsage() const
+{
+    return edges.capacity() * sizeof(tuple<int, int, double>);
+}
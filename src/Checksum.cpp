@@ -0,0 +1,59 @@
+#include <array>
+
+#include "Checksum.hpp"
+
+using namespace std;
+
+/**
+ * Lookup tables for slicing-by-8: table[0] is the classic byte-wise table,
+ * table[k] advances the checksum of a byte by k more zero bytes.
+ */
+static const array<array<uint32_t, 256>, 8> &crcTables()
+{
+    static const array<array<uint32_t, 256>, 8> tables = []
+    {
+        array<array<uint32_t, 256>, 8> result{};
+        for (uint32_t byte = 0; byte < 256; byte++)
+        {
+            uint32_t crc = byte;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+            result[0][byte] = crc;
+        }
+        for (uint32_t byte = 0; byte < 256; byte++)
+        {
+            for (size_t k = 1; k < 8; k++)
+            {
+                result[k][byte] = (result[k - 1][byte] >> 8) ^ result[0][result[k - 1][byte] & 0xFF];
+            }
+        }
+        return result;
+    }();
+    return tables;
+}
+
+uint32_t crc32(const void *data, size_t size, uint32_t crc)
+{
+    const auto &table = crcTables();
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    crc = ~crc;
+
+    // eight bytes per step, the bytes are combined little-endian like the reference implementation
+    while (size >= 8)
+    {
+        uint32_t low = crc ^ (uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 | uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24);
+        uint32_t high = uint32_t(bytes[4]) | uint32_t(bytes[5]) << 8 | uint32_t(bytes[6]) << 16 | uint32_t(bytes[7]) << 24;
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+              table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^ table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+        bytes += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+    {
+        crc = (crc >> 8) ^ table[0][(crc ^ *bytes++) & 0xFF];
+    }
+
+    return ~crc;
+}
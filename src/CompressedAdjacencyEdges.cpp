@@ -0,0 +1,414 @@
+#include "CompressedAdjacencyEdges.hpp"
+
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr size_t SKIP_ENTRY_BYTES = 2 * sizeof(uint32_t); ///< first neighbor and block offset of a skip table entry
+
+    inline void writeVarint(uint64_t value, std::vector<uint8_t> &out)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline uint64_t readVarint(const uint8_t *&cursor)
+    {
+        uint64_t value = *cursor & 0x7F;
+        unsigned shift = 7;
+        while (*cursor++ & 0x80)
+        {
+            value |= static_cast<uint64_t>(*cursor & 0x7F) << shift;
+            shift += 7;
+        }
+        return value;
+    }
+
+    inline void writeFixed(uint32_t value, uint8_t *out)
+    {
+        std::memcpy(out, &value, sizeof(value));
+    }
+
+    inline uint32_t readFixed(const uint8_t *in)
+    {
+        uint32_t value;
+        std::memcpy(&value, in, sizeof(value));
+        return value;
+    }
+
+    inline size_t blockCount(size_t degree)
+    {
+        return (degree + CompressedAdjacencyEdges::BLOCK_SIZE - 1) / CompressedAdjacencyEdges::BLOCK_SIZE;
+    }
+}
+
+/*
+ * =========== constructors ===============
+ */
+CompressedAdjacencyEdges::~CompressedAdjacencyEdges() = default;
+
+CompressedAdjacencyEdges::CompressedAdjacencyEdges()
+    : listOffsets(1, 0) {}
+
+CompressedAdjacencyEdges::CompressedAdjacencyEdges(const std::vector<std::pair<int, int>> &initialEdges)
+{
+    encodeFrom(AdjacencyArrayEdges(initialEdges));
+}
+
+CompressedAdjacencyEdges::CompressedAdjacencyEdges(const AdjacencyArrayEdges &uncompressed)
+{
+    encodeFrom(uncompressed);
+
+    // keep weights only if the source has any, an unweighted graph stays without weight array
+    size_t nodeCount = uncompressed.getNodeCount();
+    for (size_t node = 0; node < nodeCount && edgeWeights.empty(); node++)
+    {
+        for (double weight : uncompressed.weights(static_cast<int>(node)))
+        {
+            if (!std::isnan(weight))
+            {
+                allocateWeights();
+                break;
+            }
+        }
+    }
+    if (!edgeWeights.empty())
+    {
+        for (size_t node = 0; node < nodeCount; node++)
+        {
+            Span<const double> nodeWeights = uncompressed.weights(static_cast<int>(node));
+            std::copy(nodeWeights.begin(), nodeWeights.end(), edgeWeights.begin() + entryOffsets[node]);
+        }
+    }
+}
+
+/*
+ * ======= Interface Methoden ===============
+ */
+
+void CompressedAdjacencyEdges::addEdge(int source, int destination)
+{
+    if (source < 0 || destination < 0 || isEdge(source, destination))
+    {
+        return;
+    }
+
+    size_t requiredOffsets = static_cast<size_t>(std::max(source, destination)) + 2;
+    if (listOffsets.size() < requiredOffsets)
+    {
+        // every new list gets its own zero degree varint, the old end marker becomes the first of them
+        size_t firstNewNode = listOffsets.size() - 1;
+        listOffsets.resize(requiredOffsets);
+        for (size_t node = firstNewNode; node + 1 < requiredOffsets; node++)
+        {
+            listOffsets[node] = encodedLists.size();
+            writeVarint(0, encodedLists);
+        }
+        listOffsets.back() = encodedLists.size();
+        if (!entryOffsets.empty())
+        {
+            entryOffsets.resize(requiredOffsets, edgeWeights.size());
+        }
+    }
+
+    // re-encode the lists of both endpoints and splice them into the byte stream
+    std::vector<int> list;
+    std::vector<uint8_t> encoded;
+    for (auto [from, to] : {std::make_pair(source, destination), std::make_pair(destination, source)})
+    {
+        decodeList(from, list);
+        auto insertPosition = std::lower_bound(list.begin(), list.end(), to);
+        size_t insertIndex = insertPosition - list.begin();
+        list.insert(insertPosition, to);
+
+        encoded.clear();
+        encodeList(Span<const int>(list.data(), list.size()), encoded);
+
+        uint64_t listBegin = listOffsets[from];
+        uint64_t listEnd = listOffsets[from + 1];
+        encodedLists.erase(encodedLists.begin() + listBegin, encodedLists.begin() + listEnd);
+        encodedLists.insert(encodedLists.begin() + listBegin, encoded.begin(), encoded.end());
+
+        int64_t growth = static_cast<int64_t>(encoded.size()) - static_cast<int64_t>(listEnd - listBegin);
+        for (size_t i = from + 1; i < listOffsets.size(); i++)
+        {
+            listOffsets[i] += growth;
+        }
+
+        if (!edgeWeights.empty())
+        {
+            edgeWeights.insert(edgeWeights.begin() + entryOffsets[from] + insertIndex, std::numeric_limits<double>::quiet_NaN());
+            for (size_t i = from + 1; i < entryOffsets.size(); i++)
+            {
+                ++entryOffsets[i];
+            }
+        }
+        ++adjacencyEntries;
+
+        if (from == to)
+        {
+            selfLoopCount++;
+            break; // self-loops are stored once
+        }
+    }
+}
+
+std::vector<int> CompressedAdjacencyEdges::getNeighbors(int nodeID)
+{
+    std::vector<int> result;
+    decodeList(nodeID, result);
+    return result;
+}
+
+Span<const int> CompressedAdjacencyEdges::neighbors(int nodeID) const
+{
+    thread_local std::vector<int> buffer;
+    decodeList(nodeID, buffer);
+    return Span<const int>(buffer.data(), buffer.size());
+}
+
+bool CompressedAdjacencyEdges::isEdge(int source, int destination)
+{
+    return findInList(source, destination) >= 0;
+}
+
+std::vector<std::pair<int, int>> CompressedAdjacencyEdges::getEdges() const
+{
+    std::vector<std::pair<int, int>> edges;
+    std::vector<int> list;
+    for (size_t node = 0; node + 1 < listOffsets.size(); node++)
+    {
+        decodeList(static_cast<int>(node), list);
+        // lists are sorted, so the neighbors with a larger ID are at the back
+        for (auto it = std::upper_bound(list.begin(), list.end(), static_cast<int>(node)); it != list.end(); ++it)
+        {
+            edges.emplace_back(static_cast<int>(node), *it);
+        }
+    }
+    return edges;
+}
+
+void CompressedAdjacencyEdges::setWeight(int source, int destination, double weight)
+{
+    long forward = findInList(source, destination);
+    if (forward < 0)
+    {
+        return;
+    }
+    long backward = findInList(destination, source);
+
+    if (edgeWeights.empty())
+    {
+        allocateWeights();
+    }
+    edgeWeights[entryOffsets[source] + forward] = weight;
+    edgeWeights[entryOffsets[destination] + backward] = weight;
+}
+
+double CompressedAdjacencyEdges::getWeight(int source, int destination) const
+{
+    long position = edgeWeights.empty() ? -1 : findInList(source, destination);
+    if (position < 0)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return edgeWeights[entryOffsets[source] + position];
+}
+
+Span<const double> CompressedAdjacencyEdges::weights(int nodeID) const
+{
+    if (nodeID < 0 || static_cast<size_t>(nodeID) + 1 >= listOffsets.size())
+    {
+        return Span<const double>();
+    }
+    if (!edgeWeights.empty())
+    {
+        return Span<const double>(edgeWeights.data() + entryOffsets[nodeID], edgeWeights.data() + entryOffsets[nodeID + 1]);
+    }
+
+    // no weight has been set yet, hand out NaNs of the right length
+    const uint8_t *cursor = encodedLists.data() + listOffsets[nodeID];
+    size_t degree = readVarint(cursor);
+    thread_local std::vector<double> unsetWeights;
+    unsetWeights.assign(degree, std::numeric_limits<double>::quiet_NaN());
+    return Span<const double>(unsetWeights.data(), unsetWeights.size());
+}
+
+size_t CompressedAdjacencyEdges::size() const
+{
+    return (adjacencyEntries + selfLoopCount) / 2; // counted like AdjacencyArrayEdges
+}
+
+size_t CompressedAdjacencyEdges::getNodeCount() const
+{
+    return listOffsets.size() - 1;
+}
+
+size_t CompressedAdjacencyEdges::memoryUsage() const
+{
+    return encodedLists.capacity() * sizeof(uint8_t) + listOffsets.capacity() * sizeof(uint64_t) + entryOffsets.capacity() * sizeof(uint64_t) + edgeWeights.capacity() * sizeof(double);
+}
+
+/*
+ * ======= Encoding ===============
+ */
+
+void CompressedAdjacencyEdges::encodeFrom(const AdjacencyArrayEdges &uncompressed)
+{
+    size_t nodeCount = uncompressed.getNodeCount();
+    encodedLists.clear();
+    listOffsets.assign(nodeCount + 1, 0);
+    adjacencyEntries = 0;
+    selfLoopCount = 0;
+
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        listOffsets[node] = encodedLists.size();
+        Span<const int> list = uncompressed.neighbors(static_cast<int>(node));
+        encodeList(list, encodedLists);
+        adjacencyEntries += list.size();
+        selfLoopCount += std::binary_search(list.begin(), list.end(), static_cast<int>(node));
+    }
+    listOffsets[nodeCount] = encodedLists.size();
+    encodedLists.shrink_to_fit();
+}
+
+void CompressedAdjacencyEdges::encodeList(Span<const int> list, std::vector<uint8_t> &out)
+{
+    writeVarint(list.size(), out);
+
+    size_t blocks = blockCount(list.size());
+    size_t skipTableBegin = out.size();
+    if (blocks > 1)
+    {
+        out.resize(out.size() + (blocks - 1) * SKIP_ENTRY_BYTES);
+    }
+    size_t blocksBegin = out.size();
+
+    for (size_t block = 0; block < blocks; block++)
+    {
+        size_t first = block * BLOCK_SIZE;
+        size_t last = std::min(first + BLOCK_SIZE, list.size());
+
+        if (block > 0)
+        {
+            uint8_t *entry = out.data() + skipTableBegin + (block - 1) * SKIP_ENTRY_BYTES;
+            writeFixed(static_cast<uint32_t>(list[first]), entry);
+            writeFixed(static_cast<uint32_t>(out.size() - blocksBegin), entry + sizeof(uint32_t));
+        }
+
+        writeVarint(static_cast<uint32_t>(list[first]), out);
+        for (size_t i = first + 1; i < last; i++)
+        {
+            writeVarint(static_cast<uint32_t>(list[i] - list[i - 1]), out);
+        }
+    }
+}
+
+void CompressedAdjacencyEdges::decodeList(int nodeID, std::vector<int> &out) const
+{
+    out.clear();
+    if (nodeID < 0 || static_cast<size_t>(nodeID) + 1 >= listOffsets.size())
+    {
+        return;
+    }
+
+    const uint8_t *cursor = encodedLists.data() + listOffsets[nodeID];
+    size_t degree = readVarint(cursor);
+    size_t blocks = blockCount(degree);
+    if (blocks > 1)
+    {
+        cursor += (blocks - 1) * SKIP_ENTRY_BYTES;
+    }
+
+    out.resize(degree);
+    int *target = out.data();
+    for (size_t first = 0; first < degree; first += BLOCK_SIZE)
+    {
+        size_t last = std::min(first + BLOCK_SIZE, degree);
+        int value = static_cast<int>(readVarint(cursor));
+        target[first] = value;
+        for (size_t i = first + 1; i < last; i++)
+        {
+            value += static_cast<int>(readVarint(cursor));
+            target[i] = value;
+        }
+    }
+}
+
+long CompressedAdjacencyEdges::findInList(int source, int destination) const
+{
+    if (source < 0 || destination < 0 || static_cast<size_t>(source) + 1 >= listOffsets.size())
+    {
+        return -1;
+    }
+
+    const uint8_t *cursor = encodedLists.data() + listOffsets[source];
+    size_t degree = readVarint(cursor);
+    size_t blocks = blockCount(degree);
+
+    // pick the last block whose first neighbor is <= destination from the skip table
+    size_t block = 0;
+    const uint8_t *blocksBegin = cursor;
+    if (blocks > 1)
+    {
+        const uint8_t *skipTable = cursor;
+        blocksBegin = cursor + (blocks - 1) * SKIP_ENTRY_BYTES;
+
+        size_t low = 0, high = blocks - 1; // number of skip entries with first neighbor <= destination
+        while (low < high)
+        {
+            size_t middle = (low + high) / 2;
+            if (readFixed(skipTable + middle * SKIP_ENTRY_BYTES) <= static_cast<uint32_t>(destination))
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        block = low;
+        cursor = blocksBegin;
+        if (block > 0)
+        {
+            cursor += readFixed(skipTable + (block - 1) * SKIP_ENTRY_BYTES + sizeof(uint32_t));
+        }
+    }
+
+    size_t first = block * BLOCK_SIZE;
+    size_t last = std::min(first + BLOCK_SIZE, degree);
+    int value = 0;
+    for (size_t i = first; i < last; i++)
+    {
+        value = (i == first) ? static_cast<int>(readVarint(cursor)) : value + static_cast<int>(readVarint(cursor));
+        if (value == destination)
+        {
+            return static_cast<long>(i);
+        }
+        if (value > destination)
+        {
+            break;
+        }
+    }
+    return -1;
+}
+
+void CompressedAdjacencyEdges::allocateWeights()
+{
+    size_t nodeCount = listOffsets.size() - 1;
+    entryOffsets.assign(nodeCount + 1, 0);
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        const uint8_t *cursor = encodedLists.data() + listOffsets[node];
+        entryOffsets[node + 1] = entryOffsets[node] + readVarint(cursor);
+    }
+    edgeWeights.assign(adjacencyEntries, std::numeric_limits<double>::quiet_NaN());
+}
@@ -0,0 +1,343 @@
+#include "DeltaAdjacencyEdges.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <numeric>
+
+/*
+ * ======= declaration of local functions ======
+ */
+void collectMergedList(Span<const int>, Span<const double>, const std::vector<int> &, const std::vector<double> &, size_t,
+                       std::vector<int> &, std::vector<double> &);
+
+/*
+ * =========== constructors ===============
+ */
+DeltaAdjacencyEdges::DeltaAdjacencyEdges(const std::vector<std::pair<int, int>> &initialEdges, size_t mergeThreshold)
+    : base(std::make_shared<AdjacencyArrayEdges>(initialEdges)), mergeThreshold(std::max<size_t>(mergeThreshold, 1))
+{
+}
+
+DeltaAdjacencyEdges::~DeltaAdjacencyEdges()
+{
+    if (pendingMerge.valid())
+    {
+        pendingMerge.wait();
+    }
+}
+
+/*
+ * ======= Interface Methoden ===============
+ */
+void DeltaAdjacencyEdges::addEdge(int source, int destination)
+{
+    installMerge(false);
+
+    if (source < 0 || destination < 0 || isEdge(source, destination))
+    {
+        return;
+    }
+
+    size_t requiredNodes = static_cast<size_t>(std::max(source, destination)) + 1;
+    if (appendedAdjacency.size() < requiredNodes)
+    {
+        appendedAdjacency.resize(requiredNodes);
+        appendedWeights.resize(requiredNodes);
+    }
+
+    appendedAdjacency[source].push_back(destination);
+    appendedWeights[source].push_back(std::numeric_limits<double>::quiet_NaN());
+    deltaSize++;
+    if (source == destination) // self-loops are stored once
+    {
+        deltaSelfLoops++;
+    }
+    else
+    {
+        appendedAdjacency[destination].push_back(source);
+        appendedWeights[destination].push_back(std::numeric_limits<double>::quiet_NaN());
+        deltaSize++;
+    }
+
+    if (deltaSize >= mergeThreshold && !pendingMerge.valid())
+    {
+        startMerge();
+    }
+}
+
+std::vector<int> DeltaAdjacencyEdges::getNeighbors(int nodeID)
+{
+    installMerge(false);
+    return neighbors(nodeID).toVector();
+}
+
+Span<const int> DeltaAdjacencyEdges::neighbors(int nodeID) const
+{
+    if (appendedNeighbors(nodeID).empty())
+    {
+        return base->neighbors(nodeID);
+    }
+
+    thread_local std::vector<int> neighborBuffer;
+    thread_local std::vector<double> weightBuffer;
+    collectMergedList(base->neighbors(nodeID), base->weights(nodeID), appendedAdjacency[nodeID], appendedWeights[nodeID],
+                      appendedAdjacency[nodeID].size(), neighborBuffer, weightBuffer);
+
+    return Span<const int>(neighborBuffer);
+}
+
+Span<const int> DeltaAdjacencyEdges::baseNeighbors(int nodeID) const
+{
+    return base->neighbors(nodeID);
+}
+
+Span<const int> DeltaAdjacencyEdges::appendedNeighbors(int nodeID) const
+{
+    if (nodeID < 0 || static_cast<size_t>(nodeID) >= appendedAdjacency.size())
+    {
+        return {};
+    }
+    return Span<const int>(appendedAdjacency[nodeID]);
+}
+
+bool DeltaAdjacencyEdges::isEdge(int source, int destination)
+{
+    installMerge(false);
+
+    Span<const int> stored = base->neighbors(source);
+    if (std::binary_search(stored.begin(), stored.end(), destination))
+    {
+        return true;
+    }
+
+    Span<const int> appended = appendedNeighbors(source);
+    return std::find(appended.begin(), appended.end(), destination) != appended.end();
+}
+
+std::vector<std::pair<int, int>> DeltaAdjacencyEdges::getEdges() const
+{
+    std::vector<std::pair<int, int>> edgesVector;
+
+    size_t nodeCount = std::max(base->getNodeCount(), appendedAdjacency.size());
+    for (size_t currentNode = 0; currentNode < nodeCount; currentNode++)
+    {
+        for (int neighbor : neighbors(static_cast<int>(currentNode)))
+        {
+            // no edge duplicates
+            if (static_cast<int>(currentNode) < neighbor)
+            {
+                edgesVector.emplace_back(static_cast<int>(currentNode), neighbor);
+            }
+        }
+    }
+
+    return edgesVector;
+}
+
+void DeltaAdjacencyEdges::setWeight(int source, int destination, double weight)
+{
+    installMerge(true); // the merge thread may read the weights of the base
+
+    Span<const int> appended = appendedNeighbors(source);
+    auto position = std::find(appended.begin(), appended.end(), destination);
+    if (position == appended.end())
+    {
+        base->setWeight(source, destination, weight);
+        return;
+    }
+
+    appendedWeights[source][position - appended.begin()] = weight;
+    auto &reverseList = appendedAdjacency[destination];
+    auto reversePosition = std::find(reverseList.begin(), reverseList.end(), source);
+    appendedWeights[destination][reversePosition - reverseList.begin()] = weight;
+}
+
+double DeltaAdjacencyEdges::getWeight(int source, int destination) const
+{
+    Span<const int> appended = appendedNeighbors(source);
+    auto position = std::find(appended.begin(), appended.end(), destination);
+    if (position != appended.end())
+    {
+        return appendedWeights[source][position - appended.begin()];
+    }
+
+    return base->getWeight(source, destination);
+}
+
+Span<const double> DeltaAdjacencyEdges::weights(int nodeID) const
+{
+    if (appendedNeighbors(nodeID).empty())
+    {
+        return base->weights(nodeID);
+    }
+
+    thread_local std::vector<int> neighborBuffer;
+    thread_local std::vector<double> weightBuffer;
+    collectMergedList(base->neighbors(nodeID), base->weights(nodeID), appendedAdjacency[nodeID], appendedWeights[nodeID],
+                      appendedAdjacency[nodeID].size(), neighborBuffer, weightBuffer);
+
+    return Span<const double>(weightBuffer);
+}
+
+size_t DeltaAdjacencyEdges::size() const
+{
+    return base->size() + (deltaSize + deltaSelfLoops) / 2; // counted like AdjacencyArrayEdges
+}
+
+/*
+ * ======= merging ===============
+ */
+void DeltaAdjacencyEdges::compact()
+{
+    installMerge(true);
+    if (deltaSize > 0)
+    {
+        startMerge();
+        installMerge(true);
+    }
+}
+
+bool DeltaAdjacencyEdges::isMerging() const
+{
+    return pendingMerge.valid();
+}
+
+size_t DeltaAdjacencyEdges::getDeltaSize() const
+{
+    return deltaSize;
+}
+
+size_t DeltaAdjacencyEdges::getNodeCount() const
+{
+    return std::max(base->getNodeCount(), appendedAdjacency.size());
+}
+
+void DeltaAdjacencyEdges::startMerge()
+{
+    // the merge works on copies of the append buffers, so edges can still be added meanwhile
+    pendingMerge = std::async(std::launch::async, &DeltaAdjacencyEdges::merge, base, appendedAdjacency, appendedWeights);
+}
+
+void DeltaAdjacencyEdges::installMerge(bool wait)
+{
+    if (!pendingMerge.valid())
+    {
+        return;
+    }
+    if (!wait && pendingMerge.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+
+    MergeResult result = pendingMerge.get();
+    base = std::move(result.mergedBase);
+
+    // drop the merged entries, everything appended while merging stays in the delta
+    for (size_t node = 0; node < result.mergedPrefixLengths.size(); node++)
+    {
+        size_t mergedLength = result.mergedPrefixLengths[node];
+        auto mergedEnd = appendedAdjacency[node].begin() + mergedLength;
+        if (std::find(appendedAdjacency[node].begin(), mergedEnd, static_cast<int>(node)) != mergedEnd)
+        {
+            deltaSelfLoops--;
+        }
+        appendedAdjacency[node].erase(appendedAdjacency[node].begin(), appendedAdjacency[node].begin() + mergedLength);
+        appendedWeights[node].erase(appendedWeights[node].begin(), appendedWeights[node].begin() + mergedLength);
+        deltaSize -= mergedLength;
+    }
+}
+
+DeltaAdjacencyEdges::MergeResult DeltaAdjacencyEdges::merge(std::shared_ptr<const AdjacencyArrayEdges> base,
+                                                            std::vector<std::vector<int>> appendedAdjacency,
+                                                            std::vector<std::vector<double>> appendedWeights)
+{
+    size_t nodeCount = std::max(base->getNodeCount(), appendedAdjacency.size());
+
+    MergeResult result;
+    result.mergedPrefixLengths.resize(appendedAdjacency.size());
+
+    // 1: list lengths and offsets of the merged adjacency array
+    std::vector<EdgeOffset> offsets(nodeCount + 1, 0);
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        size_t appendedCount = node < appendedAdjacency.size() ? appendedAdjacency[node].size() : 0;
+        offsets[node + 1] = offsets[node] + base->neighbors(static_cast<int>(node)).size() + appendedCount;
+    }
+
+    // 2: merge each sorted base list with its sorted append buffer
+    std::vector<int> adjacency(offsets[nodeCount]);
+    std::vector<double> weights(offsets[nodeCount]);
+    std::vector<int> mergedList;
+    std::vector<double> mergedWeights;
+    std::vector<int> noAppended;
+    std::vector<double> noAppendedWeights;
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        int nodeID = static_cast<int>(node);
+        bool hasAppended = node < appendedAdjacency.size();
+        const auto &appendedList = hasAppended ? appendedAdjacency[node] : noAppended;
+        const auto &appendedListWeights = hasAppended ? appendedWeights[node] : noAppendedWeights;
+
+        collectMergedList(base->neighbors(nodeID), base->weights(nodeID), appendedList, appendedListWeights,
+                          appendedList.size(), mergedList, mergedWeights);
+        std::copy(mergedList.begin(), mergedList.end(), adjacency.begin() + offsets[node]);
+        std::copy(mergedWeights.begin(), mergedWeights.end(), weights.begin() + offsets[node]);
+
+        if (hasAppended)
+        {
+            result.mergedPrefixLengths[node] = appendedList.size();
+        }
+    }
+
+    result.mergedBase = std::make_shared<AdjacencyArrayEdges>(std::move(offsets), std::move(adjacency), std::move(weights));
+    return result;
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Merges a sorted base list with the first appendedCount entries of an unsorted append buffer.
+ *
+ * @param baseList sorted neighbors from the base
+ * @param baseWeights weights aligned with baseList
+ * @param appendedList neighbors in insertion order
+ * @param appendedListWeights weights aligned with appendedList
+ * @param appendedCount how many entries of appendedList to take
+ * @param[out] mergedList the sorted union of both lists
+ * @param[out] mergedWeights weights aligned with mergedList
+ */
+void collectMergedList(Span<const int> baseList, Span<const double> baseWeights,
+                       const std::vector<int> &appendedList, const std::vector<double> &appendedListWeights, size_t appendedCount,
+                       std::vector<int> &mergedList, std::vector<double> &mergedWeights)
+{
+    // sort the append buffer by neighbor through an index permutation to keep weights aligned
+    thread_local std::vector<size_t> order;
+    order.resize(appendedCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+              { return appendedList[a] < appendedList[b]; });
+
+    mergedList.clear();
+    mergedWeights.clear();
+    size_t baseIndex = 0, orderIndex = 0;
+    while (baseIndex < baseList.size() || orderIndex < order.size())
+    {
+        bool takeBase = orderIndex == order.size() ||
+                        (baseIndex < baseList.size() && baseList[baseIndex] < appendedList[order[orderIndex]]);
+        if (takeBase)
+        {
+            mergedList.push_back(baseList[baseIndex]);
+            mergedWeights.push_back(baseWeights[baseIndex]);
+            baseIndex++;
+        }
+        else
+        {
+            mergedList.push_back(appendedList[order[orderIndex]]);
+            mergedWeights.push_back(appendedListWeights[order[orderIndex]]);
+            orderIndex++;
+        }
+    }
+}
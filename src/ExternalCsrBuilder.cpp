@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+#include "ExternalCsrBuilder.hpp"
+#include "GraphParser.hpp"
+#include "GraphSnapshot.hpp"
+#include "InputFile.hpp"
+#include "NodeOrdering.hpp"
+
+using namespace std;
+
+/*
+ * ======= Declaration of local helper functions ===============
+ */
+
+uint64_t edgeKey(int, int);
+string runPrefixFor(const string &, const string &);
+
+const size_t MIN_READER_ENTRIES = 512; ///< smallest read buffer of a run, so runs aren't read in tiny pieces
+const size_t MAX_MERGE_FAN_IN = 256;   ///< most runs open at once, well below the usual limit of 1024 open files
+
+/**
+ * @brief Removes a set of temporary files when it goes out of scope, also if the build fails.
+ */
+struct TemporaryFiles
+{
+    vector<string> paths;
+
+    ~TemporaryFiles()
+    {
+        for (const string &path : paths)
+        {
+            remove(path.c_str());
+        }
+    }
+};
+
+/**
+ * @brief Reads a sorted run back in blocks of keys.
+ */
+class RunReader
+{
+public:
+    RunReader(const string &path, size_t bufferEntries)
+        : file(path, ios::binary), buffer(bufferEntries)
+    {
+        if (!file.is_open())
+        {
+            throw runtime_error("Failed to open temporary run file: " + path);
+        }
+    }
+
+    /**
+     * @brief Retrieves the next key of the run.
+     *
+     * @return bool False if the run is exhausted.
+     */
+    bool next(uint64_t &key)
+    {
+        if (position == filled)
+        {
+            file.read(reinterpret_cast<char *>(buffer.data()), buffer.size() * sizeof(uint64_t));
+            filled = file.gcount() / sizeof(uint64_t);
+            position = 0;
+            if (filled == 0)
+            {
+                return false;
+            }
+        }
+        key = buffer[position++];
+        return true;
+    }
+
+private:
+    ifstream file;
+    vector<uint64_t> buffer;
+    size_t position = 0;
+    size_t filled = 0;
+};
+
+/**
+ * @brief Merges sorted runs into one sorted stream of keys, dropping keys found in more than one run.
+ */
+class RunMerger
+{
+public:
+    RunMerger(const vector<string> &runFiles, size_t bufferEntries, size_t &removedDuplicates)
+        : removedDuplicates(removedDuplicates)
+    {
+        readers.reserve(runFiles.size());
+        for (const string &path : runFiles)
+        {
+            readers.emplace_back(path, bufferEntries);
+        }
+        for (size_t i = 0; i < readers.size(); i++)
+        {
+            uint64_t key;
+            if (readers[i].next(key))
+            {
+                queue.emplace(key, i);
+            }
+        }
+    }
+
+    /**
+     * @brief Retrieves the next distinct key of all runs.
+     *
+     * @return bool False if all runs are exhausted.
+     */
+    bool next(uint64_t &key)
+    {
+        while (!queue.empty())
+        {
+            auto [smallest, runIndex] = queue.top();
+            queue.pop();
+            uint64_t nextKey;
+            if (readers[runIndex].next(nextKey))
+            {
+                queue.emplace(nextKey, runIndex);
+            }
+
+            // runs are deduplicated on their own, but the same edge may be in several of them
+            if (hasPrevious && smallest == previous)
+            {
+                removedDuplicates++;
+                continue;
+            }
+            hasPrevious = true;
+            previous = smallest;
+            key = smallest;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // smallest key first, with the index of its run
+    using QueueEntry = pair<uint64_t, size_t>;
+
+    vector<RunReader> readers;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queue;
+    size_t &removedDuplicates;
+    bool hasPrevious = false;
+    uint64_t previous = 0;
+};
+
+/*
+ * ======= ExternalCsrBuilder ===============
+ */
+
+ExternalCsrBuilder::ExternalCsrBuilder(const ExternalCsrOptions &options) : options(options) {}
+
+ExternalCsrStats ExternalCsrBuilder::build(const string &edgesFile, const string &csrFile)
+{
+    auto startTime = chrono::steady_clock::now();
+    ExternalCsrStats stats;
+
+    string runPrefix = runPrefixFor(csrFile, options.temporaryDirectory);
+    TemporaryFiles temporaryFiles;
+    int maxNodeId = -1;
+
+    writeRuns(edgesFile, runPrefix, temporaryFiles.paths, stats, maxNodeId);
+    vector<string> runFiles = temporaryFiles.paths;
+    reduceRuns(runFiles, runPrefix, temporaryFiles.paths, stats);
+    string offsetsFile = runPrefix + ".offsets.tmp";
+    temporaryFiles.paths.push_back(offsetsFile);
+
+    mergeRuns(runFiles, csrFile, offsetsFile, maxNodeId, stats);
+
+    stats.buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    return stats;
+}
+
+void ExternalCsrBuilder::writeRuns(const string &edgesFile, const string &runPrefix, vector<string> &runFiles, ExternalCsrStats &stats, int &maxNodeId)
+{
+    InputFile input(edgesFile);
+    if (!input.isOpen())
+    {
+        throw runtime_error("Failed to open edge file: " + edgesFile);
+    }
+    Span<const char> text = input.contents();
+
+    // half of the budget holds the run, an eighth the text segment parsed at once,
+    // whose parsed edges take at most twice its size
+    size_t runCapacity = max<size_t>(options.memoryBudget / 2 / sizeof(uint64_t), 16);
+    size_t segmentBytes = max<size_t>(options.memoryBudget / 8, 256);
+
+    // a line of at least 4 bytes yields at most 2 keys, so small files don't take the whole budget
+    vector<uint64_t> run;
+    run.reserve(min(runCapacity, text.size() / 2 + 1));
+
+    // sorts the collected keys and writes them to the next run file
+    auto spill = [&]()
+    {
+        if (run.empty())
+        {
+            return;
+        }
+        sort(run.begin(), run.end());
+        auto last = unique(run.begin(), run.end());
+        stats.removedDuplicates += run.end() - last;
+        run.erase(last, run.end());
+
+        string path = runPrefix + ".run" + to_string(runFiles.size()) + ".tmp";
+        runFiles.push_back(path);
+        ofstream file(path, ios::binary | ios::trunc);
+        file.write(reinterpret_cast<const char *>(run.data()), run.size() * sizeof(uint64_t));
+        if (!file)
+        {
+            throw runtime_error("Failed to write temporary run file: " + path);
+        }
+        run.clear();
+    };
+
+    auto push = [&](uint64_t key)
+    {
+        if (run.size() == runCapacity)
+        {
+            spill();
+        }
+        run.push_back(key);
+    };
+
+    GraphParser parser;
+    size_t lineOffset = 0;
+    size_t begin = 0;
+    while (begin < text.size())
+    {
+        // segments end after a line break so no line is split
+        size_t end = min(begin + segmentBytes, text.size());
+        if (end < text.size())
+        {
+            const void *lineBreak = memchr(text.data() + end, '\n', text.size() - end);
+            end = lineBreak == nullptr ? text.size() : static_cast<const char *>(lineBreak) - text.data() + 1;
+        }
+        Span<const char> segment(text.data() + begin, end - begin);
+
+        ParsedEdges parsed = parser.parseEdges(segment);
+        for (ParseError &error : parsed.errors)
+        {
+            error.line += lineOffset;
+        }
+        stats.malformedLines += parsed.errors.size();
+        GraphParser::reportErrors(edgesFile, parsed.errors);
+        stats.peakBytes = max(stats.peakBytes, run.capacity() * sizeof(uint64_t) + parsed.edges.capacity() * sizeof(pair<int, int>));
+
+        for (auto [source, destination] : parsed.edges)
+        {
+            if (source < 0 || destination < 0)
+            {
+                stats.skippedInvalidEdges++;
+                continue;
+            }
+            stats.edgesRead++;
+            maxNodeId = max(maxNodeId, max(source, destination));
+
+            if (source == destination)
+            {
+                if (options.dropSelfLoops)
+                {
+                    stats.droppedSelfLoops++;
+                }
+                else
+                {
+                    push(edgeKey(source, source));
+                }
+                continue;
+            }
+            push(edgeKey(source, destination));
+            push(edgeKey(destination, source));
+        }
+
+        lineOffset += count(segment.begin(), segment.end(), '\n');
+        begin = end;
+    }
+    spill();
+
+    stats.runs = runFiles.size();
+}
+
+size_t ExternalCsrBuilder::mergeFanIn() const
+{
+    // a quarter of the budget is shared by the run readers
+    return clamp<size_t>(options.memoryBudget / 4 / (MIN_READER_ENTRIES * sizeof(uint64_t)), 2, MAX_MERGE_FAN_IN);
+}
+
+void ExternalCsrBuilder::reduceRuns(vector<string> &runFiles, const string &runPrefix, vector<string> &temporaryPaths, ExternalCsrStats &stats)
+{
+    size_t fanIn = mergeFanIn();
+    size_t readerEntries = max<size_t>(options.memoryBudget / 4 / sizeof(uint64_t) / fanIn, MIN_READER_ENTRIES);
+    size_t outputEntries = max<size_t>(options.memoryBudget / 4 / sizeof(uint64_t), 1024);
+    vector<uint64_t> outputBuffer;
+
+    while (runFiles.size() > fanIn)
+    {
+        // merge groups of fanIn runs into one run each, until the final merge can open all of them
+        vector<string> mergedRuns;
+        for (size_t groupBegin = 0; groupBegin < runFiles.size(); groupBegin += fanIn)
+        {
+            vector<string> group(runFiles.begin() + groupBegin, runFiles.begin() + min(groupBegin + fanIn, runFiles.size()));
+            if (group.size() == 1)
+            {
+                mergedRuns.push_back(group[0]);
+                continue;
+            }
+
+            string path = runPrefix + ".run" + to_string(temporaryPaths.size()) + ".tmp";
+            temporaryPaths.push_back(path);
+            mergedRuns.push_back(path);
+            ofstream file(path, ios::binary | ios::trunc);
+            outputBuffer.reserve(outputEntries);
+            stats.peakBytes = max(stats.peakBytes, group.size() * readerEntries * sizeof(uint64_t) + outputEntries * sizeof(uint64_t));
+
+            RunMerger merger(group, readerEntries, stats.removedDuplicates);
+            uint64_t key;
+            while (merger.next(key))
+            {
+                if (outputBuffer.size() == outputEntries)
+                {
+                    file.write(reinterpret_cast<const char *>(outputBuffer.data()), outputBuffer.size() * sizeof(uint64_t));
+                    outputBuffer.clear();
+                }
+                outputBuffer.push_back(key);
+            }
+            file.write(reinterpret_cast<const char *>(outputBuffer.data()), outputBuffer.size() * sizeof(uint64_t));
+            outputBuffer.clear();
+            if (!file)
+            {
+                throw runtime_error("Failed to write temporary run file: " + path);
+            }
+
+            // the merged runs aren't needed anymore, free their disk space right away
+            for (const string &mergedPath : group)
+            {
+                remove(mergedPath.c_str());
+            }
+        }
+
+        runFiles = move(mergedRuns);
+        stats.mergePasses++;
+    }
+}
+
+void ExternalCsrBuilder::mergeRuns(const vector<string> &runFiles, const string &csrFile, const string &offsetsFile, int maxNodeId, ExternalCsrStats &stats)
+{
+    // the other half of the budget is shared by the run readers and the output buffers
+    size_t readerEntries = max<size_t>(options.memoryBudget / 4 / sizeof(uint64_t) / max<size_t>(runFiles.size(), 1), MIN_READER_ENTRIES);
+    size_t outputEntries = max<size_t>(options.memoryBudget / 4 / (sizeof(int) + sizeof(EdgeOffset)), 1024);
+
+    RunMerger merger(runFiles, readerEntries, stats.removedDuplicates);
+
+    SnapshotWriter writer(csrFile, 0, 0, static_cast<uint32_t>(NodeOrder::Input));
+    ofstream offsets(offsetsFile, ios::binary | ios::trunc);
+    if (!offsets.is_open())
+    {
+        throw runtime_error("Failed to open temporary offsets file: " + offsetsFile);
+    }
+
+    vector<int> adjacencyBuffer;
+    vector<EdgeOffset> offsetBuffer;
+    adjacencyBuffer.reserve(outputEntries);
+    offsetBuffer.reserve(outputEntries);
+    stats.peakBytes = max(stats.peakBytes, runFiles.size() * readerEntries * sizeof(uint64_t) + outputEntries * (sizeof(int) + sizeof(EdgeOffset)));
+
+    auto flushOffsets = [&]()
+    {
+        offsets.write(reinterpret_cast<const char *>(offsetBuffer.data()), offsetBuffer.size() * sizeof(EdgeOffset));
+        offsetBuffer.clear();
+    };
+    auto pushOffset = [&](size_t offset)
+    {
+        if (offsetBuffer.size() == outputEntries)
+        {
+            flushOffsets();
+        }
+        offsetBuffer.push_back(offset);
+    };
+
+    writer.beginSection(SnapshotSection::Adjacency);
+    size_t entryCount = 0;
+    size_t startedLists = 0; // lists whose start offset has been written
+    uint64_t key;
+
+    while (merger.next(key))
+    {
+        size_t source = key >> 32;
+        while (startedLists <= source)
+        {
+            pushOffset(entryCount);
+            startedLists++;
+        }
+
+        if (adjacencyBuffer.size() == outputEntries)
+        {
+            writer.write(adjacencyBuffer.data(), adjacencyBuffer.size() * sizeof(int));
+            adjacencyBuffer.clear();
+        }
+        adjacencyBuffer.push_back(static_cast<int>(key & 0xFFFFFFFFu));
+        entryCount++;
+    }
+    writer.write(adjacencyBuffer.data(), adjacencyBuffer.size() * sizeof(int));
+
+    // start of the remaining lists and the end marker
+    size_t listCount = static_cast<size_t>(maxNodeId + 1);
+    while (startedLists <= listCount)
+    {
+        pushOffset(entryCount);
+        startedLists++;
+    }
+    flushOffsets();
+    offsets.close();
+    if (offsets.fail())
+    {
+        throw runtime_error("Failed to write temporary offsets file: " + offsetsFile);
+    }
+
+    // copy the offsets behind the adjacency lists
+    ifstream offsetsInput(offsetsFile, ios::binary);
+    writer.beginSection(SnapshotSection::WideOffsets);
+    offsetBuffer.resize(outputEntries);
+    while (offsetsInput.read(reinterpret_cast<char *>(offsetBuffer.data()), offsetBuffer.size() * sizeof(EdgeOffset)) || offsetsInput.gcount() > 0)
+    {
+        writer.write(offsetBuffer.data(), offsetsInput.gcount());
+    }
+    writer.finish();
+
+    stats.adjacencyEntries = entryCount;
+    stats.listCount = listCount;
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * @brief Packs a directed edge into a key that sorts by source, then destination.
+ */
+uint64_t edgeKey(int source, int destination)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(source)) << 32) | static_cast<uint32_t>(destination);
+}
+
+/**
+ * @brief Builds the common prefix of the temporary files of a build.
+ *
+ * @param csrFile the snapshot being written
+ * @param temporaryDirectory where to put the files, empty for next to csrFile
+ */
+string runPrefixFor(const string &csrFile, const string &temporaryDirectory)
+{
+    if (temporaryDirectory.empty())
+    {
+        return csrFile;
+    }
+    size_t separator = csrFile.find_last_of('/');
+    string fileName = separator == string::npos ? csrFile : csrFile.substr(separator + 1);
+    return temporaryDirectory + "/" + fileName;
+}
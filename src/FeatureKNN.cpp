@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+// the AVX2 kernel is compiled for its own target and only called if the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FEATURE_KNN_AVX2
+#include <immintrin.h>
+#endif
+
+#include "FeatureKNN.hpp"
+#include "Parallel.hpp"
+
+using namespace std;
+
+const size_t VECTOR_DOUBLES = 4;     ///< doubles per AVX2 register, rows are padded to it with either kernel
+const size_t QUERY_BLOCK = 32;      ///< queries compared with the same block of rows
+const size_t CANDIDATE_BLOCK = 256; ///< rows scanned at once, small enough to stay in cache for all queries of a block
+
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+/**
+ * Sums over the columns observed in both of two rows
+ */
+struct MaskedSums
+{
+    double common = 0.0;            ///< number of columns observed in both rows
+    double squaredDifference = 0.0; ///< Euclidean only
+    double dot = 0.0;               ///< cosine only
+    double queryNorm = 0.0;         ///< cosine only, squared
+    double rowNorm = 0.0;           ///< cosine only, squared
+};
+
+template <bool Cosine>
+MaskedSums maskedSums(const double *, const double *, const double *, const double *, size_t);
+template <bool Cosine>
+MaskedSums maskedSumsScalar(const double *, const double *, const double *, const double *, size_t);
+#ifdef FEATURE_KNN_AVX2
+bool cpuHasAvx2();
+template <bool Cosine>
+__attribute__((target("avx2,fma"))) MaskedSums maskedSumsAvx2(const double *, const double *, const double *, const double *, size_t);
+#endif
+
+/*
+ * ======= Implementation of IStrategy Interface methods =============
+ */
+void FeatureKNN::run()
+{
+    if (!graph)
+    {
+        cerr << "Error: Graph is not set in FeatureKNN strategy." << endl;
+        return;
+    }
+    buildIndex(*graph);
+
+    size_t featureCount = graph->getFeatureCount();
+    vector<size_t> querySlots;
+    for (size_t slot = 0; slot < slotRows.size(); ++slot)
+    {
+        Span<const double> row = as_const(*graph).featureRow(slot);
+        if (any_of(row.begin(), row.end(), [](double feature) { return isnan(feature); }))
+        {
+            querySlots.push_back(slot);
+        }
+    }
+
+    // the graph isn't written until every query is done, so all of them see the features as loaded
+    vector<double> filledRows(querySlots.size() * featureCount);
+    size_t probedPartitions = min<size_t>(max(probes, 1), pivotRows.size());
+
+    parallelFor(0, querySlots.size(), threads, [&](size_t begin, size_t end, unsigned)
+    {
+        vector<vector<pair<double, size_t>>> nearest(QUERY_BLOCK);
+        vector<pair<double, size_t>> pivotDistances(pivotRows.size());
+        vector<Span<const double>> similarNodes;
+        vector<vector<size_t>> missingColumns(QUERY_BLOCK);
+
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += QUERY_BLOCK)
+        {
+            size_t blockEnd = min(end, blockBegin + QUERY_BLOCK);
+            for (size_t query = blockBegin; query < blockEnd; ++query)
+            {
+                nearest[query - blockBegin].clear();
+                missingColumns[query - blockBegin].clear();
+                Span<const double> row = as_const(*graph).featureRow(querySlots[query]);
+                for (size_t column = 0; column < featureCount; ++column)
+                {
+                    if (isnan(row[column]))
+                    {
+                        missingColumns[query - blockBegin].push_back(column);
+                    }
+                }
+            }
+
+            if (pivotRows.empty())
+            {
+                // every query of the block is compared with one block of rows before moving on to the next
+                for (size_t rowBegin = 0; rowBegin < rowSlots.size(); rowBegin += CANDIDATE_BLOCK)
+                {
+                    size_t rowEnd = min(rowSlots.size(), rowBegin + CANDIDATE_BLOCK);
+                    for (size_t query = blockBegin; query < blockEnd; ++query)
+                    {
+                        scanRows(slotRows[querySlots[query]], missingColumns[query - blockBegin], rowBegin, rowEnd, nearest[query - blockBegin]);
+                    }
+                }
+            }
+            else
+            {
+                for (size_t query = blockBegin; query < blockEnd; ++query)
+                {
+                    size_t queryRow = slotRows[querySlots[query]];
+                    for (size_t partition = 0; partition < pivotRows.size(); ++partition)
+                    {
+                        pivotDistances[partition] = {distance(queryRow, pivotRows[partition]), partition};
+                    }
+                    partial_sort(pivotDistances.begin(), pivotDistances.begin() + probedPartitions, pivotDistances.end());
+                    for (size_t probe = 0; probe < probedPartitions; ++probe)
+                    {
+                        size_t partition = pivotDistances[probe].second;
+                        scanRows(queryRow, missingColumns[query - blockBegin], partitionOffsets[partition], partitionOffsets[partition + 1], nearest[query - blockBegin]);
+                    }
+                }
+            }
+
+            for (size_t query = blockBegin; query < blockEnd; ++query)
+            {
+                // closest first, the heap order depends on the order of the scan
+                sort_heap(nearest[query - blockBegin].begin(), nearest[query - blockBegin].end());
+                similarNodes.clear();
+                for (auto [nodeDistance, slot] : nearest[query - blockBegin])
+                {
+                    similarNodes.push_back(as_const(*graph).featureRow(slot));
+                }
+
+                Span<const double> row = as_const(*graph).featureRow(querySlots[query]);
+                Span<double> filledRow(filledRows.data() + query * featureCount, featureCount);
+                copy(row.begin(), row.end(), filledRow.begin());
+                fillMissingFeatures(filledRow, similarNodes);
+            }
+        }
+    });
+
+    for (size_t query = 0; query < querySlots.size(); ++query)
+    {
+        const double *filledRow = filledRows.data() + query * featureCount;
+        copy(filledRow, filledRow + featureCount, graph->featureRow(querySlots[query]).begin());
+    }
+}
+
+shared_ptr<Graph> FeatureKNN::extractResults() const
+{
+    return graph;
+}
+
+void FeatureKNN::configure(const map<string, double> &params)
+{
+    if (params.find("k") != params.end())
+    {
+        k = static_cast<int>(params.at("k"));
+    }
+    if (params.find("cosine") != params.end())
+    {
+        cosine = params.at("cosine") != 0.0;
+    }
+    if (params.find("threads") != params.end())
+    {
+        threads = static_cast<unsigned>(max(params.at("threads"), 0.0));
+    }
+    if (params.find("partitions") != params.end())
+    {
+        partitions = max(static_cast<int>(params.at("partitions")), 0);
+    }
+    if (params.find("probes") != params.end())
+    {
+        int newProbes = static_cast<int>(params.at("probes"));
+        if (newProbes > 0)
+        {
+            probes = newProbes;
+        }
+        else
+        {
+            cerr << "Warning: probes must be positive. Keeping the previous value: " << probes << endl;
+        }
+    }
+}
+
+void FeatureKNN::reset()
+{
+    k = 15;
+    cosine = false;
+    threads = 0;
+    partitions = 0;
+    probes = 4;
+    values.clear();
+    masks.clear();
+    rowSlots.clear();
+    slotRows.clear();
+    partitionOffsets.clear();
+    pivotRows.clear();
+}
+
+/*
+ * ======= Strategy Methods ======================
+ */
+void FeatureKNN::buildIndex(const Graph &graph)
+{
+    size_t nodeCount = graph.getNodeCount();
+    size_t featureCount = graph.getFeatureCount();
+    rowStride = (featureCount + VECTOR_DOUBLES - 1) / VECTOR_DOUBLES * VECTOR_DOUBLES;
+
+    // first in slot order, the partitions reorder the rows below
+    values.assign(nodeCount * rowStride, 0.0);
+    masks.assign(nodeCount * rowStride, 0.0);
+    rowSlots.resize(nodeCount);
+    slotRows.resize(nodeCount);
+    for (size_t slot = 0; slot < nodeCount; ++slot)
+    {
+        Span<const double> row = graph.featureRow(slot);
+        for (size_t column = 0; column < featureCount; ++column)
+        {
+            if (!isnan(row[column]))
+            {
+                values[slot * rowStride + column] = row[column];
+                masks[slot * rowStride + column] = 1.0;
+            }
+        }
+        rowSlots[slot] = slot;
+        slotRows[slot] = slot;
+    }
+
+    pivotRows.clear();
+    partitionOffsets.assign({0, nodeCount});
+    size_t partitionCount = min<size_t>(partitions, nodeCount);
+    if (partitionCount == 0)
+    {
+        return;
+    }
+
+    // pivots spread evenly over the slots, every node joins the partition of its nearest pivot
+    for (size_t partition = 0; partition < partitionCount; ++partition)
+    {
+        pivotRows.push_back(partition * nodeCount / partitionCount);
+    }
+    vector<size_t> partitionOf(nodeCount);
+    parallelFor(0, nodeCount, threads, [&](size_t begin, size_t end, unsigned)
+    {
+        for (size_t row = begin; row < end; ++row)
+        {
+            double nearestDistance = numeric_limits<double>::infinity();
+            partitionOf[row] = 0;
+            for (size_t partition = 0; partition < partitionCount; ++partition)
+            {
+                double pivotDistance = distance(row, pivotRows[partition]);
+                if (pivotDistance < nearestDistance)
+                {
+                    nearestDistance = pivotDistance;
+                    partitionOf[row] = partition;
+                }
+            }
+        }
+    });
+
+    // counting sort of the rows by partition, so each partition is scanned as one contiguous range
+    partitionOffsets.assign(partitionCount + 1, 0);
+    for (size_t partition : partitionOf)
+    {
+        partitionOffsets[partition + 1]++;
+    }
+    for (size_t partition = 0; partition < partitionCount; ++partition)
+    {
+        partitionOffsets[partition + 1] += partitionOffsets[partition];
+    }
+
+    vector<size_t> cursor(partitionOffsets.begin(), partitionOffsets.end() - 1);
+    vector<double, AlignedAllocator<double>> sortedValues(values.size());
+    vector<double, AlignedAllocator<double>> sortedMasks(masks.size());
+    for (size_t slot = 0; slot < nodeCount; ++slot)
+    {
+        size_t row = cursor[partitionOf[slot]]++;
+        copy_n(values.begin() + slot * rowStride, rowStride, sortedValues.begin() + row * rowStride);
+        copy_n(masks.begin() + slot * rowStride, rowStride, sortedMasks.begin() + row * rowStride);
+        rowSlots[row] = slot;
+        slotRows[slot] = row;
+    }
+    values = move(sortedValues);
+    masks = move(sortedMasks);
+    for (size_t &pivotRow : pivotRows)
+    {
+        pivotRow = slotRows[pivotRow];
+    }
+}
+
+double FeatureKNN::distance(size_t queryRow, size_t row) const
+{
+    const double *queryValues = values.data() + queryRow * rowStride;
+    const double *queryMasks = masks.data() + queryRow * rowStride;
+    const double *rowValues = values.data() + row * rowStride;
+    const double *rowMasks = masks.data() + row * rowStride;
+
+    if (cosine)
+    {
+        MaskedSums sums = maskedSums<true>(queryValues, queryMasks, rowValues, rowMasks, rowStride);
+        if (sums.common == 0.0)
+        {
+            return numeric_limits<double>::infinity();
+        }
+        double norms = sqrt(sums.queryNorm * sums.rowNorm);
+        return norms == 0.0 ? 1.0 : 1.0 - sums.dot / norms;
+    }
+
+    MaskedSums sums = maskedSums<false>(queryValues, queryMasks, rowValues, rowMasks, rowStride);
+    if (sums.common == 0.0)
+    {
+        return numeric_limits<double>::infinity();
+    }
+    return sqrt(sums.squaredDifference / sums.common);
+}
+
+void FeatureKNN::scanRows(size_t queryRow, const vector<size_t> &missingColumns, size_t begin, size_t end, vector<pair<double, size_t>> &nearest) const
+{
+    size_t nearestCount = static_cast<size_t>(max(k, 0));
+    for (size_t row = begin; row < end; ++row)
+    {
+        // rows without a value for any missing column couldn't fill anything
+        const double *rowMasks = masks.data() + row * rowStride;
+        if (row == queryRow || none_of(missingColumns.begin(), missingColumns.end(), [&](size_t column) { return rowMasks[column] != 0.0; }))
+        {
+            continue;
+        }
+        double rowDistance = distance(queryRow, row);
+        if (isinf(rowDistance))
+        {
+            continue;
+        }
+
+        // ties are broken by slot, so the result doesn't depend on the order of the scan
+        pair<double, size_t> candidate(rowDistance, rowSlots[row]);
+        if (nearest.size() < nearestCount)
+        {
+            nearest.push_back(candidate);
+            push_heap(nearest.begin(), nearest.end());
+        }
+        else if (nearestCount > 0 && candidate < nearest.front())
+        {
+            pop_heap(nearest.begin(), nearest.end());
+            nearest.back() = candidate;
+            push_heap(nearest.begin(), nearest.end());
+        }
+    }
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * @brief Computes the sums of a masked distance over two rows of length stride.
+ *
+ * Uses the AVX2 kernel if the CPU supports AVX2 and FMA, checked once, and the scalar loop otherwise.
+ *
+ * @tparam Cosine whether to sum the dot product and norms instead of the squared differences
+ */
+template <bool Cosine>
+MaskedSums maskedSums(const double *queryValues, const double *queryMasks, const double *rowValues, const double *rowMasks, size_t stride)
+{
+#ifdef FEATURE_KNN_AVX2
+    if (cpuHasAvx2())
+    {
+        return maskedSumsAvx2<Cosine>(queryValues, queryMasks, rowValues, rowMasks, stride);
+    }
+#endif
+    return maskedSumsScalar<Cosine>(queryValues, queryMasks, rowValues, rowMasks, stride);
+}
+
+/**
+ * @brief Portable version of maskedSums.
+ */
+template <bool Cosine>
+MaskedSums maskedSumsScalar(const double *queryValues, const double *queryMasks, const double *rowValues, const double *rowMasks, size_t stride)
+{
+    MaskedSums sums;
+    for (size_t i = 0; i < stride; ++i)
+    {
+        double both = queryMasks[i] * rowMasks[i];
+        double query = queryValues[i] * both;
+        double row = rowValues[i] * both;
+        sums.common += both;
+        if constexpr (Cosine)
+        {
+            sums.dot += query * row;
+            sums.queryNorm += query * query;
+            sums.rowNorm += row * row;
+        }
+        else
+        {
+            sums.squaredDifference += (query - row) * (query - row);
+        }
+    }
+    return sums;
+}
+
+#ifdef FEATURE_KNN_AVX2
+/**
+ * @brief Checks once whether the CPU runs the AVX2 kernel, which also uses FMA.
+ */
+bool cpuHasAvx2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+
+/**
+ * @brief Adds up the four lanes of a register.
+ */
+__attribute__((target("avx2,fma"))) inline double horizontalSum(__m256d sums)
+{
+    __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(sums), _mm256_extractf128_pd(sums, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+}
+
+/**
+ * @brief AVX2 version of maskedSums.
+ *
+ * Rows are aligned to 32 bytes and stride is a multiple of VECTOR_DOUBLES, so the loop needs no remainder.
+ */
+template <bool Cosine>
+__attribute__((target("avx2,fma"))) MaskedSums maskedSumsAvx2(const double *queryValues, const double *queryMasks, const double *rowValues, const double *rowMasks, size_t stride)
+{
+    MaskedSums sums;
+    __m256d common = _mm256_setzero_pd();
+    __m256d first = _mm256_setzero_pd();
+    __m256d second = _mm256_setzero_pd();
+    __m256d third = _mm256_setzero_pd();
+    for (size_t i = 0; i < stride; i += VECTOR_DOUBLES)
+    {
+        __m256d both = _mm256_mul_pd(_mm256_load_pd(queryMasks + i), _mm256_load_pd(rowMasks + i));
+        __m256d query = _mm256_mul_pd(_mm256_load_pd(queryValues + i), both);
+        __m256d row = _mm256_mul_pd(_mm256_load_pd(rowValues + i), both);
+        common = _mm256_add_pd(common, both);
+        if constexpr (Cosine)
+        {
+            first = _mm256_fmadd_pd(query, row, first);
+            second = _mm256_fmadd_pd(query, query, second);
+            third = _mm256_fmadd_pd(row, row, third);
+        }
+        else
+        {
+            __m256d difference = _mm256_sub_pd(query, row);
+            first = _mm256_fmadd_pd(difference, difference, first);
+        }
+    }
+    sums.common = horizontalSum(common);
+    if constexpr (Cosine)
+    {
+        sums.dot = horizontalSum(first);
+        sums.queryNorm = horizontalSum(second);
+        sums.rowNorm = horizontalSum(third);
+    }
+    else
+    {
+        sums.squaredDifference = horizontalSum(first);
+    }
+    return sums;
+}
+#endif
@@ -0,0 +1,131 @@
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#include "FeatureWriter.hpp"
+#include "Parallel.hpp"
+
+using namespace std;
+
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+const int MAX_FIXED_PRECISION = 100;
+
+void appendInt(string &, int);
+void appendDouble(string &, double, int);
+
+FeatureWriter::FeatureWriter(const FeatureWriterOptions &options) : options(options)
+{
+    if (options.fixedPrecision < -1 || options.fixedPrecision > MAX_FIXED_PRECISION)
+    {
+        throw invalid_argument("fixed precision has to be between -1 and " + to_string(MAX_FIXED_PRECISION));
+    }
+    if (this->options.chunkRows == 0)
+    {
+        this->options.chunkRows = 1;
+    }
+}
+
+bool FeatureWriter::write(const Graph &graph, const string &fileName) const
+{
+    ofstream outFile(fileName, ios::binary);
+    if (!outFile.is_open())
+    {
+        return false;
+    }
+
+    unsigned threads = options.threads == 0 ? defaultThreadCount() : options.threads;
+    vector<string> buffers(threads);
+    size_t nodeCount = graph.getNodeCount();
+    size_t batchRows = threads * options.chunkRows;
+
+    // each batch gives every thread one chunk, which are written in order before the next batch
+    for (size_t batchBegin = 0; batchBegin < nodeCount; batchBegin += batchRows)
+    {
+        size_t batchEnd = min(nodeCount, batchBegin + batchRows);
+        size_t chunkCount = (batchEnd - batchBegin + options.chunkRows - 1) / options.chunkRows;
+
+        parallelFor(0, chunkCount, threads, [&](size_t chunkBegin, size_t chunkEnd, unsigned)
+                    {
+            for (size_t chunk = chunkBegin; chunk < chunkEnd; chunk++)
+            {
+                size_t rowBegin = batchBegin + chunk * options.chunkRows;
+                buffers[chunk].clear();
+                formatRows(graph, rowBegin, min(batchEnd, rowBegin + options.chunkRows), buffers[chunk]);
+            } });
+
+        for (size_t chunk = 0; chunk < chunkCount; chunk++)
+        {
+            outFile.write(buffers[chunk].data(), buffers[chunk].size());
+        }
+    }
+
+    outFile.close();
+    return !outFile.fail();
+}
+
+void FeatureWriter::formatRows(const Graph &graph, size_t beginSlot, size_t endSlot, string &out) const
+{
+    for (size_t slot = beginSlot; slot < endSlot; slot++)
+    {
+        int nodeId = graph.getIdBySlot(slot);
+        appendInt(out, graph.getOriginalId(nodeId)); // IDs as in the input files, even if the graph was reordered
+        out += '\t';
+
+        Span<const double> features = graph.featureRow(slot);
+        for (size_t i = 0; i < features.size(); i++)
+        {
+            if (isnan(features[i]))
+            {
+                out += "0.0";
+            }
+            else
+            {
+                appendDouble(out, features[i], options.fixedPrecision);
+            }
+
+            if (i != features.size() - 1)
+            {
+                out += ", ";
+            }
+        }
+
+        out += '\t';
+        appendInt(out, graph.getLabelById(nodeId));
+        out += '\n';
+    }
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Appends an integer in decimal
+ */
+void appendInt(string &out, int value)
+{
+    char digits[16];
+    char *end = to_chars(digits, digits + sizeof(digits), value).ptr;
+    out.append(digits, end);
+}
+
+/**
+ * Appends a number like ostream does by default, or with fixed digits after the decimal point
+ *
+ * @param out the buffer to append to
+ * @param value the number, not NaN
+ * @param fixedPrecision digits after the decimal point, -1 for 6 significant digits (%g)
+ */
+void appendDouble(string &out, double value, int fixedPrecision)
+{
+    // sign, 309 integer digits, point and the digits after it
+    char digits[320 + MAX_FIXED_PRECISION];
+    char *end = fixedPrecision < 0
+                    ? to_chars(digits, digits + sizeof(digits), value, chars_format::general, 6).ptr
+                    : to_chars(digits, digits + sizeof(digits), value, chars_format::fixed, fixedPrecision).ptr;
+    out.append(digits, end);
+}
@@ -1,193 +1,832 @@
 #include <memory>
-#include <fstream>
+#include <chrono>
+#include <future>
+#include <cmath>
 #include <iostream>
-#include <sstream>
-#include <cctype>
-#include <cstdlib>
 #include <limits>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
 
 #include "Graph.hpp"
+#include "CompressedAdjacencyEdges.hpp"
+#include "DeltaAdjacencyEdges.hpp"
+#include "GraphParser.hpp"
+#include "GraphSnapshot.hpp"
+#include "InputFile.hpp"
+#include "MappedAdjacencyEdges.hpp"
+#include "MappedFile.hpp"
 
 using namespace std;
 
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+/**
+ * @brief Edges loaded by the edge task of the text constructor.
+ */
+struct LoadedEdges
+{
+    bool opened = false;              ///< false if the edge file couldn't be opened
+    unique_ptr<AdjacencyArrayEdges> edges; ///< the adjacency array, null if the IDs are too sparse to build it on
+    vector<pair<int, int>> edgeList;  ///< the edges as read, only kept if the graph is renumbered
+    vector<ParseError> errors;        ///< malformed lines, reported once both files are loaded
+};
+
+unique_ptr<AdjacencyArrayEdges> readSnapshotEdges(SnapshotReader &, const string &);
+LoadedEdges loadEdges(const string &, bool, LoadTimings &);
+unique_ptr<AdjacencyArrayEdges> permuteAdjacency(const IEdges &, const vector<int> &, const IdIndex &);
+size_t listCountOf(const IEdges &);
+bool hasDenseIds(const vector<pair<int, int>> &);
+double secondsSince(chrono::steady_clock::time_point);
+
 /**
  * @brief Constructs a graph by parsing from txt files.
  *
+ * The edge file may also be a CSR snapshot, as written by save() or ExternalCsrBuilder.
+ * Text files may be entries of a zip archive ("archive.zip!/entry.txt") or gzip-compressed (".gz").
+ * The edge file is loaded on a second thread, so building the adjacency array overlaps with parsing the nodes.
+ * If its IDs are too sparse for an adjacency array indexed by them, the nodes are renumbered densely first.
+ *
  * @param nodesFile The file containing node information.
  * @param edgesFile The file containing edge information.
+ * @param order The numbering of the nodes, NodeOrder::Input keeps the IDs of the files.
  */
-Graph::Graph(const string &nodesFile, const string &edgesFile)
+template <typename EdgeBackend>
+BasicGraph<EdgeBackend>::BasicGraph(const string &nodesFile, const string &edgesFile, NodeOrder order)
 {
-    // Read edge file
-    vector<pair<int, int>> initialEdges; // Vector to hold all edges
-    ifstream edgesFileStream(edgesFile);
-    if (!edgesFileStream.is_open())
+    auto startTime = chrono::steady_clock::now();
+
+    // the two files are independent, the edges are read, parsed and built into the adjacency array meanwhile
+    future<LoadedEdges> edgeTask = async(launch::async, loadEdges, cref(edgesFile), order != NodeOrder::Input, ref(loadTimings));
+
+    // read node file
+    auto phaseStart = chrono::steady_clock::now();
+    InputFile nodesInput(nodesFile);
+    loadTimings.nodeReadSeconds = secondsSince(phaseStart);
+    ParsedNodes parsedNodes;
+    if (nodesInput.isOpen())
+    {
+        phaseStart = chrono::steady_clock::now();
+        parsedNodes = GraphParser().parseNodes(nodesInput.contents());
+        loadTimings.nodeParseSeconds = secondsSince(phaseStart);
+    }
+
+    LoadedEdges loadedEdges = edgeTask.get();
+    loadTimings.totalSeconds = secondsSince(startTime);
+    if (!loadedEdges.opened)
     {
         cerr << "Failed to open edge file!" << endl;
         return;
     }
+    GraphParser::reportErrors(edgesFile, loadedEdges.errors);
+    edges = move(loadedEdges.edges);
+
+    if (!nodesInput.isOpen())
+    {
+        cerr << "Failed to open node file!" << endl;
+        if (!edges)
+        {
+            remapToDenseIds(loadedEdges.edgeList);
+        }
+        return;
+    }
+    GraphParser::reportErrors(nodesFile, parsedNodes.errors);
+
+    nodeIds = move(parsedNodes.nodeIds);
+    featureMatrix = move(parsedNodes.featureMatrix);
+    labels = move(parsedNodes.labels);
+    featureCount = parsedNodes.featureCount;
 
-    string line;
-    while (getline(edgesFileStream, line))
+    slotIndex.build(nodeIds);
+
+    if (!edges || order != NodeOrder::Input)
     {
-        istringstream iss(line);
-        int source, destination;
-        if (iss >> source >> destination)
+        phaseStart = chrono::steady_clock::now();
+        if (!edges)
         {
-            // Collect edge by adding it to the vector
-            initialEdges.emplace_back(source, destination);
+            remapToDenseIds(loadedEdges.edgeList);
         }
-        else
+        if (order != NodeOrder::Input)
         {
-            cerr << "Invalid line in edge file: " << line << endl;
+            reorder(order, loadedEdges.edgeList);
         }
+        loadTimings.reorderSeconds = secondsSince(phaseStart);
     }
-    edgesFileStream.close();
+    loadTimings.totalSeconds = secondsSince(startTime);
+}
 
-    // Construct AdjacencyArrayEdges using the complete edge set
-    edges = make_unique<AdjacencyArrayEdges>(initialEdges);
+template <typename EdgeBackend>
+BasicGraph<EdgeBackend>::BasicGraph(const string &snapshotFile, SnapshotAccess access)
+{
+    SnapshotReader reader(snapshotFile);
+    const SnapshotHeader &header = reader.getHeader();
+    size_t nodeCount = header.nodeCount;
+    featureCount = header.featureCount;
 
-    // read node file
-    ifstream nodesFileStream(nodesFile);
-    if (!nodesFileStream.is_open())
+    // node IDs and labels are small, they are read in both modes
+    reader.readSection(SnapshotSection::NodeIds, nodeIds);
+    reader.readSection(SnapshotSection::Labels, labels);
+    if (nodeIds.size() != nodeCount || labels.size() != nodeCount)
     {
-        cerr << "Failed to open node file!" << endl;
-        return;
+        throw runtime_error(snapshotFile + ": node sections don't match the header");
     }
 
-    while (getline(nodesFileStream, line))
+    if (access == SnapshotAccess::Map)
     {
-        istringstream iss(line);
-        // Node ID parsing
-        int nodeId;
-        iss >> nodeId;
-        // Features parsing
-        string featuresString;
-        getline(iss, featuresString); // jump to start of features
-
-        // remove \t after nodeId
-        if (!featuresString.empty() && featuresString[0] == '\t')
+        if (!is_same_v<EdgeBackend, IEdges>)
         {
-            featuresString.erase(0, 1); // Remove the first character
+            throw logic_error(snapshotFile + ": mapped edges need a Graph, other backends hold their edges in memory");
         }
+        if (header.version < 2)
+        {
+            throw runtime_error(snapshotFile + ": snapshots before version 2 can't be memory-mapped");
+        }
+        snapshotMapping = make_shared<MappedFile>(snapshotFile, true);
+        Span<char> bytes = snapshotMapping->writableContents();
 
-        vector<double> features;
-        istringstream featuresStream(featuresString);
-
-        // parsing feature value
-        int label;
-        string feature;
-        while (getline(featuresStream, feature, ','))
+        // views a section in the mapping, empty if the snapshot doesn't have it
+        auto mapSection = [&](SnapshotSection section, size_t elementSize) -> pair<char *, size_t>
         {
-            if (feature[0] == ' ')
+            const SnapshotSectionEntry *entry = reader.findSection(section);
+            if (entry == nullptr)
             {
-                feature.erase(0, 1);
+                return {nullptr, 0};
             }
-            size_t tmp = feature.find('\t');
-            if (tmp != string::npos)
+            if (entry->offset + entry->size > bytes.size() || entry->size % elementSize != 0)
             {
-                label = stoi(feature.substr(tmp + 1));
-                feature = feature.substr(0, tmp);
+                throw runtime_error(snapshotFile + ": section " + to_string(entry->id) + " is truncated");
             }
-            if (feature == "'#'" || feature == "#")
+            return {bytes.data() + entry->offset, entry->size / elementSize};
+        };
+
+        // offsets before version 3 are int32, they are widened on the heap instead of used in place
+        bool wideOffsets = header.version >= 3;
+        SnapshotSection offsetSection = wideOffsets ? SnapshotSection::WideOffsets : SnapshotSection::Offsets;
+
+        auto [features, featureValues] = mapSection(SnapshotSection::Features, sizeof(double));
+        auto [offsets, offsetCount] = mapSection(offsetSection, wideOffsets ? sizeof(EdgeOffset) : sizeof(int));
+        auto [adjacency, adjacencyCount] = mapSection(SnapshotSection::Adjacency, sizeof(int));
+        auto [weights, weightCount] = mapSection(SnapshotSection::Weights, sizeof(double));
+
+        vector<EdgeOffset> widenedOffsets;
+        Span<const EdgeOffset> offsetView(reinterpret_cast<const EdgeOffset *>(offsets), offsetCount);
+        if (!wideOffsets)
+        {
+            const int *narrowOffsets = reinterpret_cast<const int *>(offsets);
+            widenedOffsets.assign(narrowOffsets, narrowOffsets + offsetCount);
+            offsetView = Span<const EdgeOffset>(widenedOffsets.data(), widenedOffsets.size());
+        }
+        if (featureValues != nodeCount * featureCount || offsetView.empty() || offsetView.back() != adjacencyCount || (weightCount != 0 && weightCount != adjacencyCount))
+        {
+            throw runtime_error(snapshotFile + ": sections don't match each other");
+        }
+        reader.verifySection(*reader.findSection(offsetSection), offsets);
+
+        mappedFeatures = Span<double>(reinterpret_cast<double *>(features), featureValues);
+        Span<const int> adjacencyView(reinterpret_cast<const int *>(adjacency), adjacencyCount);
+        Span<double> weightView(reinterpret_cast<double *>(weights), weightCount);
+        if constexpr (is_same_v<EdgeBackend, IEdges>)
+        {
+            if (wideOffsets)
             {
-                features.push_back(numeric_limits<double>::quiet_NaN()); // Replace missing feature
+                edges = make_unique<MappedAdjacencyEdges>(snapshotMapping, offsetView, adjacencyView, weightView);
             }
             else
             {
-                features.push_back(stod(feature)); // Convert to double
+                edges = make_unique<MappedAdjacencyEdges>(snapshotMapping, move(widenedOffsets), adjacencyView, weightView);
+            }
+        }
+    }
+    else
+    {
+        // features, restoring missing values from the mask for snapshots that stored them as 0
+        reader.readSection(SnapshotSection::Features, featureMatrix);
+        vector<uint64_t> missingMask;
+        reader.readSection(SnapshotSection::MissingMask, missingMask);
+        if (featureMatrix.size() != nodeCount * featureCount || missingMask.size() != (featureMatrix.size() + 63) / 64)
+        {
+            throw runtime_error(snapshotFile + ": feature sections don't match the header");
+        }
+        for (size_t i = 0; i < featureMatrix.size(); i++)
+        {
+            if ((missingMask[i / 64] >> (i % 64)) & 1)
+            {
+                featureMatrix[i] = numeric_limits<double>::quiet_NaN();
+            }
+        }
+
+        edges = readSnapshotEdges(reader, snapshotFile);
+    }
+
+    // permutation of a reordered graph or one with sparse IDs
+    if (reader.readSection(SnapshotSection::OriginalIds, originalIds))
+    {
+        nodeOrder = static_cast<NodeOrder>(header.nodeOrder);
+        internalIndex.build(originalIds);
+    }
+
+    slotIndex.build(nodeIds);
+}
+
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::save(const string &snapshotFile) const
+{
+    SnapshotWriter writer(snapshotFile, nodeIds.size(), featureCount, static_cast<uint32_t>(nodeOrder));
+
+    writer.writeSection(SnapshotSection::NodeIds, nodeIds.data(), nodeIds.size() * sizeof(int));
+    writer.writeSection(SnapshotSection::Labels, labels.data(), labels.size() * sizeof(int));
+
+    // features with NaN for missing values, the mask marks them for readers that don't want to scan for NaN
+    Span<const double> features(nodeIds.empty() ? nullptr : featureRow(0).data(), nodeIds.size() * featureCount);
+    vector<uint64_t> missingMask((features.size() + 63) / 64, 0);
+    for (size_t i = 0; i < features.size(); i++)
+    {
+        if (isnan(features[i]))
+        {
+            missingMask[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+    writer.writeSection(SnapshotSection::Features, features.data(), features.size() * sizeof(double));
+    writer.writeSection(SnapshotSection::MissingMask, missingMask.data(), missingMask.size() * sizeof(uint64_t));
+
+    // edges in CSR form, converted if the graph uses another backend
+    Span<const EdgeOffset> offsets;
+    Span<const int> adjacency;
+    Span<const double> weights;
+    unique_ptr<AdjacencyArrayEdges> converted;
+    const IEdges *backend = edges.get();
+    if (auto csr = dynamic_cast<const AdjacencyArrayEdges *>(backend))
+    {
+        offsets = csr->csrOffsets();
+        adjacency = csr->csrAdjacency();
+        weights = csr->csrWeights();
+    }
+    else if (auto mapped = dynamic_cast<const MappedAdjacencyEdges *>(backend))
+    {
+        offsets = mapped->csrOffsets();
+        adjacency = mapped->csrAdjacency();
+        weights = mapped->csrWeights();
+    }
+    else
+    {
+        // copied list by list, so self-loops and weights survive, which getEdges() leaves out
+        vector<int> allNodes(edges ? listCountOf(*edges) : 0);
+        iota(allNodes.begin(), allNodes.end(), 0);
+        converted = edges ? permuteAdjacency(*edges, allNodes, IdIndex(allNodes)) : make_unique<AdjacencyArrayEdges>();
+        offsets = converted->csrOffsets();
+        adjacency = converted->csrAdjacency();
+        weights = converted->csrWeights();
+    }
+    writer.writeSection(SnapshotSection::WideOffsets, offsets.data(), offsets.size() * sizeof(EdgeOffset));
+    writer.writeSection(SnapshotSection::Adjacency, adjacency.data(), adjacency.size() * sizeof(int));
+    if (any_of(weights.begin(), weights.end(), [](double weight)
+               { return !isnan(weight); }))
+    {
+        writer.writeSection(SnapshotSection::Weights, weights.data(), weights.size() * sizeof(double));
+    }
+
+    if (!originalIds.empty())
+    {
+        writer.writeSection(SnapshotSection::OriginalIds, originalIds.data(), originalIds.size() * sizeof(int));
+    }
+
+    writer.finish();
+}
+
+template <typename EdgeBackend>
+vector<int> BasicGraph<EdgeBackend>::collectNodeIds(const vector<pair<int, int>> &edgeList) const
+{
+    vector<int> allNodes(nodeIds);
+    vector<int> edgeOnlyNodes;
+    for (auto [source, destination] : edgeList)
+    {
+        for (int nodeId : {source, destination})
+        {
+            if (nodeId >= 0 && slotIndex.find(nodeId) < 0)
+            {
+                edgeOnlyNodes.push_back(nodeId);
             }
         }
+    }
+    sort(edgeOnlyNodes.begin(), edgeOnlyNodes.end());
+    edgeOnlyNodes.erase(unique(edgeOnlyNodes.begin(), edgeOnlyNodes.end()), edgeOnlyNodes.end());
+    allNodes.insert(allNodes.end(), edgeOnlyNodes.begin(), edgeOnlyNodes.end());
+    return allNodes;
+}
 
-        // Add Node to the Graph
-        nodes.emplace_back(nodeId, features, label);
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::renumberNodes(const IdIndex &newIds)
+{
+    // move the node data into slots ordered by new ID
+    vector<pair<int, size_t>> slotOrder; // (new ID, old slot)
+    slotOrder.reserve(nodeIds.size());
+    for (size_t slot = 0; slot < nodeIds.size(); slot++)
+    {
+        slotOrder.emplace_back(static_cast<int>(newIds.find(nodeIds[slot])), slot);
     }
-    nodesFileStream.close();
+    sort(slotOrder.begin(), slotOrder.end());
+
+    vector<double, AlignedAllocator<double>> reorderedFeatures(featureMatrix.size());
+    vector<int> reorderedLabels(labels.size());
+    for (size_t slot = 0; slot < slotOrder.size(); slot++)
+    {
+        auto [newId, oldSlot] = slotOrder[slot];
+        nodeIds[slot] = newId;
+        reorderedLabels[slot] = labels[oldSlot];
+        copy(featureMatrix.begin() + oldSlot * featureCount, featureMatrix.begin() + (oldSlot + 1) * featureCount, reorderedFeatures.begin() + slot * featureCount);
+    }
+    featureMatrix.swap(reorderedFeatures);
+    labels.swap(reorderedLabels);
+
+    slotIndex.build(nodeIds);
 }
 
-vector<int> Graph::getNodes() const
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::remapToDenseIds(vector<pair<int, int>> &edgeList)
 {
-    vector<int> nodeIds;
-    for (const auto &node : nodes)
+    originalIds = collectNodeIds(edgeList);
+    internalIndex.build(originalIds);
+
+    // build the edges on the new IDs
+    for (auto &[source, destination] : edgeList)
+    {
+        source = static_cast<int>(internalIndex.find(source));
+        destination = static_cast<int>(internalIndex.find(destination));
+    }
+    edges = make_unique<AdjacencyArrayEdges>(edgeList);
+    renumberNodes(internalIndex);
+}
+
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::reorder(NodeOrder order, const vector<pair<int, int>> &edgeList)
+{
+    // every node gets a new ID, including the ones only known from the edge file,
+    // which after a dense remap are all of 0..n-1
+    vector<int> nodesToNumber;
+    if (originalIds.empty())
+    {
+        nodesToNumber = collectNodeIds(edgeList);
+    }
+    else
     {
-        nodeIds.push_back(node.getId());
+        nodesToNumber.resize(originalIds.size());
+        iota(nodesToNumber.begin(), nodesToNumber.end(), 0);
     }
+
+    // new ID -> current ID
+    vector<int> newOrder = computeNodeOrder(*edges, nodesToNumber, order);
+    IdIndex newIds(newOrder);
+    edges = permuteAdjacency(*edges, newOrder, newIds);
+    renumberNodes(newIds);
+
+    if (!originalIds.empty())
+    {
+        for (int &nodeId : newOrder)
+        {
+            nodeId = originalIds[nodeId];
+        }
+    }
+    originalIds = move(newOrder);
+    internalIndex.build(originalIds);
+    nodeOrder = order;
+}
+
+template <typename EdgeBackend>
+vector<int> BasicGraph<EdgeBackend>::getNodes() const
+{
     return nodeIds;
 }
 
-vector<pair<int, int>> Graph::getEdges() const
+template <typename EdgeBackend>
+vector<pair<int, int>> BasicGraph<EdgeBackend>::getEdges() const
 {
     return edges->getEdges();
 }
 
-vector<int> Graph::getNeighbors(int nodeId) const
+template <typename EdgeBackend>
+vector<int> BasicGraph<EdgeBackend>::getNeighbors(int nodeId) const
 {
     return edges->getNeighbors(nodeId);
 }
 
-int Graph::getNodeCount() const
+template <typename EdgeBackend>
+vector<int> BasicGraph<EdgeBackend>::getNeighbors(ExternalId nodeId) const
+{
+    return getNeighbors(internalId(nodeId));
+}
+
+template <typename EdgeBackend>
+Span<const int> BasicGraph<EdgeBackend>::neighbors(ExternalId nodeId) const
+{
+    return neighbors(internalId(nodeId));
+}
+
+template <typename EdgeBackend>
+bool BasicGraph<EdgeBackend>::isEdge(ExternalId source, ExternalId destination) const
+{
+    return isEdge(internalId(source), internalId(destination));
+}
+
+template <typename EdgeBackend>
+vector<bool> BasicGraph<EdgeBackend>::areEdges(Span<const pair<int, int>> queries) const
 {
-    return nodes.size();
+    return edges->areEdges(queries);
 }
 
-int Graph::getEdgeCount() const
+template <typename EdgeBackend>
+int BasicGraph<EdgeBackend>::getNodeCount() const
 {
-    auto nonConstEdges = const_cast<IEdges *>(this->edges.get());
-    return nonConstEdges->size();
+    return nodeIds.size();
 }
 
-vector<double> Graph::getFeatureById(int nodeId) const
+template <typename EdgeBackend>
+long BasicGraph<EdgeBackend>::getSlotById(ExternalId nodeId) const
 {
-    for (const auto &node : nodes)
+    return getSlotById(internalId(nodeId));
+}
+
+template <typename EdgeBackend>
+int BasicGraph<EdgeBackend>::getIdBySlot(size_t slot) const
+{
+    return nodeIds[slot];
+}
+
+template <typename EdgeBackend>
+NodeOrder BasicGraph<EdgeBackend>::getNodeOrder() const
+{
+    return nodeOrder;
+}
+
+template <typename EdgeBackend>
+const LoadTimings &BasicGraph<EdgeBackend>::getLoadTimings() const
+{
+    return loadTimings;
+}
+
+template <typename EdgeBackend>
+bool BasicGraph<EdgeBackend>::isMemoryMapped() const
+{
+    return snapshotMapping != nullptr;
+}
+
+template <typename EdgeBackend>
+int BasicGraph<EdgeBackend>::getOriginalId(int nodeId) const
+{
+    if (originalIds.empty())
     {
-        if (node.getId() == nodeId)
-        {
-            return node.getFeatureVector();
-        }
+        return nodeId;
+    }
+    if (nodeId < 0 || static_cast<size_t>(nodeId) >= originalIds.size())
+    {
+        return -1;
+    }
+    return originalIds[nodeId];
+}
+
+template <typename EdgeBackend>
+int BasicGraph<EdgeBackend>::getInternalId(int originalId) const
+{
+    if (originalIds.empty())
+    {
+        return originalId;
+    }
+    return static_cast<int>(internalIndex.find(originalId));
+}
+
+template <typename EdgeBackend>
+int BasicGraph<EdgeBackend>::internalId(ExternalId id) const
+{
+    return getInternalId(id.value);
+}
+
+template <typename EdgeBackend>
+size_t BasicGraph<EdgeBackend>::getFeatureCount() const
+{
+    return featureCount;
+}
+
+template <typename EdgeBackend>
+Span<double> BasicGraph<EdgeBackend>::featureRow(size_t slot)
+{
+    double *features = mappedFeatures.empty() ? featureMatrix.data() : mappedFeatures.data();
+    return Span<double>(features + slot * featureCount, featureCount);
+}
+
+template <typename EdgeBackend>
+Span<const double> BasicGraph<EdgeBackend>::featureRow(size_t slot) const
+{
+    const double *features = mappedFeatures.empty() ? featureMatrix.data() : mappedFeatures.data();
+    return Span<const double>(features + slot * featureCount, featureCount);
+}
+
+template <typename EdgeBackend>
+Span<double> BasicGraph<EdgeBackend>::featureRowById(int nodeId)
+{
+    long slot = getSlotById(nodeId);
+    if (slot < 0)
+    {
+        return {};
     }
-    return {};
+    return featureRow(slot);
+}
+
+template <typename EdgeBackend>
+Span<const double> BasicGraph<EdgeBackend>::featureRowById(int nodeId) const
+{
+    long slot = getSlotById(nodeId);
+    if (slot < 0)
+    {
+        return {};
+    }
+    return featureRow(slot);
+}
+
+template <typename EdgeBackend>
+Span<double> BasicGraph<EdgeBackend>::featureRowById(ExternalId nodeId)
+{
+    return featureRowById(internalId(nodeId));
+}
+
+template <typename EdgeBackend>
+Span<const double> BasicGraph<EdgeBackend>::featureRowById(ExternalId nodeId) const
+{
+    return featureRowById(internalId(nodeId));
 }
 
-void Graph::updateFeatureById(int nodeId, const vector<double> &newFeatures)
+template <typename EdgeBackend>
+vector<double> BasicGraph<EdgeBackend>::getFeatureById(int nodeId) const
 {
-    // Determine expected feature size from first node
-    size_t expectedFeatureSize = nodes.empty() ? 0 : nodes[0].getFeatureVector().size();
+    return featureRowById(nodeId).toVector();
+}
 
+template <typename EdgeBackend>
+vector<double> BasicGraph<EdgeBackend>::getFeatureById(ExternalId nodeId) const
+{
+    return getFeatureById(internalId(nodeId));
+}
+
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::updateFeatureById(int nodeId, const vector<double> &newFeatures)
+{
     // Validate feature vector length
-    if (newFeatures.size() != expectedFeatureSize)
+    if (newFeatures.size() != featureCount)
     {
         throw invalid_argument("Feature vector length mismatch");
     }
 
-    for (auto &node : nodes)
+    long slot = getSlotById(nodeId);
+    if (slot < 0)
     {
-        if (node.getId() == nodeId)
-        {
-            node.setFeatureVector(newFeatures);
-            return;
-        }
+        throw invalid_argument("Node ID not found");
     }
-    throw invalid_argument("Node ID not found");
+    copy(newFeatures.begin(), newFeatures.end(), featureRow(slot).begin());
 }
 
-void Graph::setEdgeWeight(int source, int destination, double weight)
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::updateFeatureById(ExternalId nodeId, const vector<double> &newFeatures)
+{
+    updateFeatureById(internalId(nodeId), newFeatures);
+}
+
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::setEdgeWeight(int source, int destination, double weight)
 {
     edges->setWeight(source, destination, weight);
 }
 
-double Graph::getEdgeWeight(int source, int destination) const
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::setEdgeWeight(ExternalId source, ExternalId destination, double weight)
+{
+    setEdgeWeight(internalId(source), internalId(destination), weight);
+}
+
+template <typename EdgeBackend>
+void BasicGraph<EdgeBackend>::setEdges(unique_ptr<EdgeBackend> newEdges)
+{
+    edges = move(newEdges);
+}
+
+template <typename EdgeBackend>
+double BasicGraph<EdgeBackend>::getEdgeWeight(int source, int destination) const
 {
     return edges->getWeight(source, destination);
 }
 
-int Graph::getLabelById(int nodeId)
+template <typename EdgeBackend>
+double BasicGraph<EdgeBackend>::getEdgeWeight(ExternalId source, ExternalId destination) const
+{
+    return getEdgeWeight(internalId(source), internalId(destination));
+}
+
+template <typename EdgeBackend>
+Span<const double> BasicGraph<EdgeBackend>::edgeWeights(ExternalId nodeId) const
+{
+    return edgeWeights(internalId(nodeId));
+}
+
+template <typename EdgeBackend>
+int BasicGraph<EdgeBackend>::getLabelById(int nodeId) const
+{
+    long slot = getSlotById(nodeId);
+    if (slot < 0)
+    {
+        return 0;
+    }
+    return labels[slot];
+}
+
+template <typename EdgeBackend>
+int BasicGraph<EdgeBackend>::getLabelById(ExternalId nodeId) const
+{
+    return getLabelById(internalId(nodeId));
+}
+
+template class BasicGraph<IEdges>;
+template class BasicGraph<AdjacencyArrayEdges>;
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Reads the CSR sections of a snapshot into an adjacency array
+ *
+ * @param reader the opened snapshot
+ * @param snapshotFile path of the snapshot, for error messages
+ * @return the edges with their weights
+ * @throws runtime_error if the sections are missing, corrupt or don't match each other
+ */
+unique_ptr<AdjacencyArrayEdges> readSnapshotEdges(SnapshotReader &reader, const string &snapshotFile)
+{
+    vector<EdgeOffset> offsets;
+    vector<int> adjacency;
+    vector<double> weights;
+    if (!reader.readSection(SnapshotSection::WideOffsets, offsets))
+    {
+        // int32 offsets of snapshots before version 3
+        vector<int> narrowOffsets;
+        reader.readSection(SnapshotSection::Offsets, narrowOffsets);
+        offsets.assign(narrowOffsets.begin(), narrowOffsets.end());
+    }
+    reader.readSection(SnapshotSection::Adjacency, adjacency);
+    reader.readSection(SnapshotSection::Weights, weights);
+    if (offsets.empty() || offsets.back() != adjacency.size() || (!weights.empty() && weights.size() != adjacency.size()))
+    {
+        throw runtime_error(snapshotFile + ": edge sections don't match each other");
+    }
+    return make_unique<AdjacencyArrayEdges>(move(offsets), move(adjacency), move(weights));
+}
+
+/**
+ * Reads, parses and builds the edges of the text constructor, runs concurrently with parsing the nodes
+ *
+ * @param edgesFile text edge file or CSR snapshot
+ * @param keepEdgeList whether the edges are needed as list afterwards, for reordering
+ * @param timings receives the edge phases
+ * @return the edges, with opened false if the file couldn't be opened
+ */
+LoadedEdges loadEdges(const string &edgesFile, bool keepEdgeList, LoadTimings &timings)
+{
+    LoadedEdges loaded;
+    auto phaseStart = chrono::steady_clock::now();
+
+    if (SnapshotReader::isSnapshot(edgesFile))
+    {
+        // prebuilt adjacency array, e.g. of an edge file too large to parse in memory
+        SnapshotReader reader(edgesFile);
+        loaded.edges = readSnapshotEdges(reader, edgesFile);
+        timings.csrBuildSeconds = secondsSince(phaseStart);
+        if (keepEdgeList)
+        {
+            // only used to number the nodes, so it includes the nodes whose only edge is a self-loop
+            for (size_t node = 0; node < loaded.edges->getNodeCount(); node++)
+            {
+                Span<const int> adjacents = loaded.edges->neighbors(static_cast<int>(node));
+                for (auto it = lower_bound(adjacents.begin(), adjacents.end(), static_cast<int>(node)); it != adjacents.end(); ++it)
+                {
+                    loaded.edgeList.emplace_back(static_cast<int>(node), *it);
+                }
+            }
+        }
+        loaded.opened = true;
+        return loaded;
+    }
+
+    InputFile edgesInput(edgesFile);
+    timings.edgeReadSeconds = secondsSince(phaseStart);
+    if (!edgesInput.isOpen())
+    {
+        return loaded;
+    }
+    loaded.opened = true;
+
+    phaseStart = chrono::steady_clock::now();
+    ParsedEdges parsedEdges = GraphParser().parseEdges(edgesInput.contents());
+    loaded.errors = move(parsedEdges.errors);
+    timings.edgeParseSeconds = secondsSince(phaseStart);
+
+    // sparse IDs are renumbered with the nodes before the adjacency array is built
+    if (!hasDenseIds(parsedEdges.edges))
+    {
+        loaded.edgeList = move(parsedEdges.edges);
+        return loaded;
+    }
+
+    // Construct AdjacencyArrayEdges using the complete edge set
+    phaseStart = chrono::steady_clock::now();
+    loaded.edges = make_unique<AdjacencyArrayEdges>(parsedEdges.edges);
+    timings.csrBuildSeconds = secondsSince(phaseStart);
+    if (keepEdgeList)
+    {
+        loaded.edgeList = move(parsedEdges.edges);
+    }
+    return loaded;
+}
+
+/**
+ * Copies an adjacency array onto new node IDs. The lists are moved and renumbered as they are,
+ * so self-loops and weights are kept, unlike rebuilding from getEdges().
+ *
+ * @param edges the adjacency array on the current IDs
+ * @param newOrder new ID -> current ID, covering every node with an edge
+ * @param newIds current ID -> new ID
+ * @return the adjacency array on the new IDs
+ */
+unique_ptr<AdjacencyArrayEdges> permuteAdjacency(const IEdges &edges, const vector<int> &newOrder, const IdIndex &newIds)
 {
-    for (const auto &node : nodes)
+    vector<EdgeOffset> offsets(1, 0);
+    vector<int> adjacency;
+    vector<double> weights;
+    adjacency.reserve(2 * edges.size());
+    weights.reserve(2 * edges.size());
+
+    vector<pair<int, double>> list; // (new neighbor ID, weight) of one node
+    for (int node : newOrder)
     {
-        if (node.getId() == nodeId)
+        Span<const int> adjacents = edges.neighbors(node);
+        Span<const double> adjacentWeights = edges.weights(node);
+        list.clear();
+        for (size_t i = 0; i < adjacents.size(); i++)
         {
-            return node.getLabel();
+            list.emplace_back(static_cast<int>(newIds.find(adjacents[i])), adjacentWeights[i]);
         }
+        sort(list.begin(), list.end(), [](const pair<int, double> &a, const pair<int, double> &b)
+             { return a.first < b.first; });
+
+        for (auto [neighbor, weight] : list)
+        {
+            adjacency.push_back(neighbor);
+            weights.push_back(weight);
+        }
+        offsets.push_back(adjacency.size());
+    }
+
+    return make_unique<AdjacencyArrayEdges>(move(offsets), move(adjacency), move(weights));
+}
+
+/**
+ * Number of adjacency lists of an edge backend, i.e. the highest node ID with an edge + 1
+ */
+size_t listCountOf(const IEdges &edges)
+{
+    if (auto delta = dynamic_cast<const DeltaAdjacencyEdges *>(&edges))
+    {
+        return delta->getNodeCount();
+    }
+    if (auto compressed = dynamic_cast<const CompressedAdjacencyEdges *>(&edges))
+    {
+        return compressed->getNodeCount();
     }
-    return 0;
-}
\ No newline at end of file
+
+    // other backends only list their edges, so a node whose only edge is a self-loop has to be below the highest endpoint
+    int maxNode = -1;
+    for (auto [source, destination] : edges.getEdges())
+    {
+        maxNode = max({maxNode, source, destination});
+    }
+    return static_cast<size_t>(maxNode + 1);
+}
+
+/**
+ * Checks if an adjacency array indexed by the IDs of an edge list stays in proportion to the edges:
+ * the largest ID is at most twice the number of adjacency entries, plus some slack for tiny graphs.
+ */
+bool hasDenseIds(const vector<pair<int, int>> &edgeList)
+{
+    int maxId = -1;
+    for (auto [source, destination] : edgeList)
+    {
+        maxId = max(maxId, max(source, destination));
+    }
+    return maxId < 0 || static_cast<size_t>(maxId) < 4 * edgeList.size() + 1024;
+}
+
+/**
+ * Wall clock seconds elapsed since a point in time
+ */
+double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
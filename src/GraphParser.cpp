@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include "GraphParser.hpp"
+#include "Parallel.hpp"
+
+using namespace std;
+
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+const size_t MIN_CHUNK_BYTES = 1 << 16; ///< smaller chunks aren't worth a thread
+const size_t REPORTED_ERRORS = 5;       ///< number of errors printed by reportErrors()
+
+template <typename LineHandler>
+size_t forEachLine(const char *, const char *, LineHandler &&);
+const char *skipBlanks(const char *, const char *, bool);
+bool parseInt(const char *&, const char *, int &);
+bool parseDouble(const char *&, const char *, double &);
+
+/**
+ * @brief Nodes of one chunk, rows may differ in length until they are joined.
+ */
+struct NodeChunk
+{
+    vector<int> nodeIds;
+    vector<int> labels;
+    vector<double> features;    ///< all rows back to back
+    vector<size_t> rowLengths;  ///< number of features of each row
+    vector<size_t> rowLines;    ///< chunk-local line number of each row
+    vector<ParseError> errors;  ///< with chunk-local line numbers
+    size_t lineCount = 0;
+};
+
+/*
+ * ======= Public methods ===================
+ */
+
+GraphParser::GraphParser(unsigned threads)
+    : threads(threads == 0 ? defaultThreadCount() : threads) {}
+
+ParsedEdges GraphParser::parseEdges(Span<const char> text) const
+{
+    vector<size_t> bounds = splitIntoChunks(text);
+    size_t chunkCount = bounds.size() - 1;
+
+    vector<vector<pair<int, int>>> chunkEdges(chunkCount);
+    vector<vector<ParseError>> chunkErrors(chunkCount);
+    vector<size_t> chunkLines(chunkCount);
+
+    parallelFor(0, chunkCount, threads, [&](size_t chunkBegin, size_t chunkEnd, unsigned)
+                {
+        for (size_t chunk = chunkBegin; chunk < chunkEnd; chunk++)
+        {
+            vector<pair<int, int>> &edges = chunkEdges[chunk];
+            edges.reserve((bounds[chunk + 1] - bounds[chunk]) / 8);
+
+            chunkLines[chunk] = forEachLine(text.data() + bounds[chunk], text.data() + bounds[chunk + 1], [&](const char *position, const char *lineEnd, size_t line)
+                                            {
+                position = skipBlanks(position, lineEnd, true);
+                if (position == lineEnd)
+                {
+                    return; // blank line
+                }
+
+                int source, destination;
+                bool valid = parseInt(position, lineEnd, source);
+                const char *separator = position;
+                position = skipBlanks(position, lineEnd, true);
+                valid = valid && position != separator && parseInt(position, lineEnd, destination);
+
+                // like stream extraction, anything after the two IDs is ignored
+                if (valid && (position == lineEnd || *position == ' ' || *position == '\t'))
+                {
+                    edges.emplace_back(source, destination);
+                }
+                else
+                {
+                    chunkErrors[chunk].push_back({line, "expected two whitespace-separated node IDs"});
+                } });
+        } });
+
+    // join the chunks in file order
+    ParsedEdges result;
+    vector<size_t> edgeOffsets(chunkCount + 1, 0);
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        edgeOffsets[chunk + 1] = edgeOffsets[chunk] + chunkEdges[chunk].size();
+    }
+    result.edges.resize(edgeOffsets[chunkCount]);
+    parallelFor(0, chunkCount, threads, [&](size_t chunkBegin, size_t chunkEnd, unsigned)
+                {
+        for (size_t chunk = chunkBegin; chunk < chunkEnd; chunk++)
+        {
+            copy(chunkEdges[chunk].begin(), chunkEdges[chunk].end(), result.edges.begin() + edgeOffsets[chunk]);
+            vector<pair<int, int>>().swap(chunkEdges[chunk]);
+        } });
+
+    size_t firstLine = 0;
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        for (ParseError &error : chunkErrors[chunk])
+        {
+            error.line += firstLine;
+            result.errors.push_back(move(error));
+        }
+        firstLine += chunkLines[chunk];
+    }
+
+    return result;
+}
+
+ParsedNodes GraphParser::parseNodes(Span<const char> text) const
+{
+    vector<size_t> bounds = splitIntoChunks(text);
+    size_t chunkCount = bounds.size() - 1;
+    vector<NodeChunk> chunks(chunkCount);
+
+    parallelFor(0, chunkCount, threads, [&](size_t chunkBegin, size_t chunkEnd, unsigned)
+                {
+        for (size_t chunkIndex = chunkBegin; chunkIndex < chunkEnd; chunkIndex++)
+        {
+            NodeChunk &chunk = chunks[chunkIndex];
+            chunk.lineCount = forEachLine(text.data() + bounds[chunkIndex], text.data() + bounds[chunkIndex + 1], [&](const char *position, const char *lineEnd, size_t line)
+                                          {
+                position = skipBlanks(position, lineEnd, true);
+                if (position == lineEnd)
+                {
+                    return; // blank line
+                }
+
+                size_t rowLength = 0;
+                auto fail = [&](const char *message)
+                {
+                    chunk.features.resize(chunk.features.size() - rowLength); // drop the partial row
+                    chunk.errors.push_back({line, message});
+                };
+
+                int nodeId;
+                if (!parseInt(position, lineEnd, nodeId))
+                {
+                    return fail("expected a node ID");
+                }
+                const char *separator = position;
+                position = skipBlanks(position, lineEnd, true);
+                if (position != lineEnd && position == separator)
+                {
+                    return fail("expected a tab after the node ID");
+                }
+
+                // comma-separated features, optionally followed by a tab and the label
+                int label = 0;
+                while (position != lineEnd)
+                {
+                    position = skipBlanks(position, lineEnd, false);
+                    double value;
+                    if (lineEnd - position >= 3 && memcmp(position, "'#'", 3) == 0)
+                    {
+                        value = numeric_limits<double>::quiet_NaN();
+                        position += 3;
+                    }
+                    else if (position != lineEnd && *position == '#')
+                    {
+                        value = numeric_limits<double>::quiet_NaN();
+                        position += 1;
+                    }
+                    else if (!parseDouble(position, lineEnd, value))
+                    {
+                        return fail("invalid feature value");
+                    }
+                    chunk.features.push_back(value);
+                    rowLength++;
+
+                    position = skipBlanks(position, lineEnd, false);
+                    if (position == lineEnd)
+                    {
+                        break;
+                    }
+                    if (*position == ',')
+                    {
+                        position++;
+                        continue;
+                    }
+                    if (*position == '\t')
+                    {
+                        position = skipBlanks(position, lineEnd, true);
+                        if (!parseInt(position, lineEnd, label))
+                        {
+                            return fail("invalid label");
+                        }
+                        break;
+                    }
+                    return fail("expected ',' or a tab after a feature value");
+                }
+
+                chunk.nodeIds.push_back(nodeId);
+                chunk.labels.push_back(label);
+                chunk.rowLengths.push_back(rowLength);
+                chunk.rowLines.push_back(line); });
+        } });
+
+    // the first row determines the row width of the feature matrix
+    ParsedNodes result;
+    vector<size_t> rowOffsets(chunkCount + 1, 0);
+    bool foundFirstRow = false;
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        rowOffsets[chunk + 1] = rowOffsets[chunk] + chunks[chunk].nodeIds.size();
+        if (!foundFirstRow && !chunks[chunk].rowLengths.empty())
+        {
+            result.featureCount = chunks[chunk].rowLengths.front();
+            foundFirstRow = true;
+        }
+    }
+    size_t rowCount = rowOffsets[chunkCount];
+    size_t featureCount = result.featureCount;
+
+    result.nodeIds.resize(rowCount);
+    result.labels.resize(rowCount);
+    result.featureMatrix.resize(rowCount * featureCount);
+    parallelFor(0, chunkCount, threads, [&](size_t chunkBegin, size_t chunkEnd, unsigned)
+                {
+        for (size_t chunkIndex = chunkBegin; chunkIndex < chunkEnd; chunkIndex++)
+        {
+            NodeChunk &chunk = chunks[chunkIndex];
+            copy(chunk.nodeIds.begin(), chunk.nodeIds.end(), result.nodeIds.begin() + rowOffsets[chunkIndex]);
+            copy(chunk.labels.begin(), chunk.labels.end(), result.labels.begin() + rowOffsets[chunkIndex]);
+
+            auto source = chunk.features.begin();
+            auto target = result.featureMatrix.begin() + rowOffsets[chunkIndex] * featureCount;
+            for (size_t row = 0; row < chunk.rowLengths.size(); row++)
+            {
+                size_t rowLength = chunk.rowLengths[row];
+                size_t copied = min(rowLength, featureCount);
+                copy(source, source + copied, target);
+                fill(target + copied, target + featureCount, numeric_limits<double>::quiet_NaN());
+                if (rowLength != featureCount)
+                {
+                    chunk.errors.push_back({chunk.rowLines[row], "node " + to_string(chunk.nodeIds[row]) + " has " + to_string(rowLength) + " features instead of " + to_string(featureCount)});
+                }
+                source += rowLength;
+                target += featureCount;
+            }
+            vector<double>().swap(chunk.features);
+        } });
+
+    size_t firstLine = 0;
+    for (NodeChunk &chunk : chunks)
+    {
+        sort(chunk.errors.begin(), chunk.errors.end(), [](const ParseError &a, const ParseError &b)
+             { return a.line < b.line; });
+        for (ParseError &error : chunk.errors)
+        {
+            error.line += firstLine;
+            result.errors.push_back(move(error));
+        }
+        firstLine += chunk.lineCount;
+    }
+
+    return result;
+}
+
+void GraphParser::reportErrors(const string &fileName, const vector<ParseError> &errors)
+{
+    if (errors.empty())
+    {
+        return;
+    }
+
+    cerr << fileName << ": " << errors.size() << " malformed line(s)" << endl;
+    for (size_t i = 0; i < min(errors.size(), REPORTED_ERRORS); i++)
+    {
+        cerr << "  line " << errors[i].line << ": " << errors[i].message << endl;
+    }
+    if (errors.size() > REPORTED_ERRORS)
+    {
+        cerr << "  ... and " << errors.size() - REPORTED_ERRORS << " more" << endl;
+    }
+}
+
+vector<size_t> GraphParser::splitIntoChunks(Span<const char> text) const
+{
+    size_t chunkCount = max<size_t>(1, min<size_t>(threads, text.size() / MIN_CHUNK_BYTES));
+
+    vector<size_t> bounds(1, 0);
+    for (size_t chunk = 1; chunk < chunkCount; chunk++)
+    {
+        // move each boundary behind the next line break
+        size_t target = max(bounds.back(), text.size() * chunk / chunkCount);
+        const void *lineBreak = memchr(text.data() + target, '\n', text.size() - target);
+        if (lineBreak == nullptr)
+        {
+            break;
+        }
+        bounds.push_back(static_cast<const char *>(lineBreak) - text.data() + 1);
+    }
+    bounds.push_back(text.size());
+    return bounds;
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Calls the handler for every line in [begin, end) without its line break and trailing '\r'
+ *
+ * @param begin start of the first line
+ * @param end end of the text
+ * @param handler called with the begin and end of the line and its 1-based line number
+ * @return the number of lines
+ */
+template <typename LineHandler>
+size_t forEachLine(const char *begin, const char *end, LineHandler &&handler)
+{
+    size_t line = 0;
+    while (begin < end)
+    {
+        const char *lineBreak = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        const char *lineEnd = lineBreak != nullptr ? lineBreak : end;
+        const char *contentEnd = (lineEnd > begin && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+
+        handler(begin, contentEnd, ++line);
+        begin = lineEnd + 1;
+    }
+    return line;
+}
+
+/**
+ * Skips spaces, and tabs if requested
+ *
+ * @return the first position that isn't skipped
+ */
+const char *skipBlanks(const char *position, const char *end, bool skipTabs)
+{
+    while (position != end && (*position == ' ' || (skipTabs && *position == '\t')))
+    {
+        position++;
+    }
+    return position;
+}
+
+/**
+ * Parses an integer with an optional '+' and advances position behind it
+ *
+ * @return true if an integer was read
+ */
+bool parseInt(const char *&position, const char *end, int &value)
+{
+    const char *first = (position != end && *position == '+') ? position + 1 : position;
+    auto [next, error] = from_chars(first, end, value);
+    if (error != errc())
+    {
+        return false;
+    }
+    position = next;
+    return true;
+}
+
+/**
+ * Parses a floating point number with an optional '+' and advances position behind it
+ *
+ * @return true if a number was read
+ */
+bool parseDouble(const char *&position, const char *end, double &value)
+{
+    const char *first = (position != end && *position == '+') ? position + 1 : position;
+    auto [next, error] = from_chars(first, end, value);
+    if (error != errc())
+    {
+        return false;
+    }
+    position = next;
+    return true;
+}
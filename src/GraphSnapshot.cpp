@@ -0,0 +1,163 @@
+#include <cstring>
+
+#include "GraphSnapshot.hpp"
+#include "Checksum.hpp"
+
+using namespace std;
+
+/*
+ * ======= SnapshotWriter ===============
+ */
+
+SnapshotWriter::SnapshotWriter(const string &path, uint64_t nodeCount, uint64_t featureCount, uint32_t nodeOrder)
+    : path(path), file(path, ios::binary | ios::trunc), header{}
+{
+    if (!file.is_open())
+    {
+        throw runtime_error("Failed to open snapshot file for writing: " + path);
+    }
+
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrderMark = SNAPSHOT_BYTE_ORDER_MARK;
+    header.nodeCount = nodeCount;
+    header.featureCount = featureCount;
+    header.nodeOrder = nodeOrder;
+
+    // the header is written last, once the section table is complete
+    vector<char> headerPage(SNAPSHOT_PAGE_SIZE, 0);
+    file.write(headerPage.data(), headerPage.size());
+    position = SNAPSHOT_PAGE_SIZE;
+}
+
+void SnapshotWriter::beginSection(SnapshotSection section)
+{
+    endSection();
+    if (header.sectionCount == SNAPSHOT_MAX_SECTIONS)
+    {
+        throw runtime_error(path + ": too many snapshot sections");
+    }
+
+    // pad to the next page so each section can be mapped on its own
+    size_t padding = (SNAPSHOT_PAGE_SIZE - position % SNAPSHOT_PAGE_SIZE) % SNAPSHOT_PAGE_SIZE;
+    if (padding > 0)
+    {
+        vector<char> zeros(padding, 0);
+        file.write(zeros.data(), zeros.size());
+        position += padding;
+    }
+
+    current = &header.sections[header.sectionCount++];
+    current->id = static_cast<uint32_t>(section);
+    current->offset = position;
+}
+
+void SnapshotWriter::write(const void *data, size_t size)
+{
+    if (current == nullptr)
+    {
+        throw logic_error("SnapshotWriter::write called outside of a section");
+    }
+    current->checksum = crc32(data, size, current->checksum);
+    current->size += size;
+    file.write(static_cast<const char *>(data), size);
+    position += size;
+}
+
+void SnapshotWriter::writeSection(SnapshotSection section, const void *data, size_t size)
+{
+    beginSection(section);
+    write(data, size);
+    endSection();
+}
+
+void SnapshotWriter::finish()
+{
+    endSection();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.close();
+    if (file.fail())
+    {
+        throw runtime_error("Failed to write snapshot file: " + path);
+    }
+}
+
+void SnapshotWriter::endSection()
+{
+    current = nullptr;
+}
+
+/*
+ * ======= SnapshotReader ===============
+ */
+
+SnapshotReader::SnapshotReader(const string &path)
+    : path(path), file(path, ios::binary), header{}
+{
+    if (!file.is_open())
+    {
+        throw runtime_error("Failed to open snapshot file: " + path);
+    }
+
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw runtime_error(path + " is not a graph snapshot");
+    }
+    if (header.version == 0 || header.version > SNAPSHOT_VERSION)
+    {
+        throw runtime_error(path + ": unsupported snapshot version " + to_string(header.version));
+    }
+    if (header.byteOrderMark != SNAPSHOT_BYTE_ORDER_MARK)
+    {
+        throw runtime_error(path + ": snapshot was written with another byte order");
+    }
+    if (header.sectionCount > SNAPSHOT_MAX_SECTIONS)
+    {
+        throw runtime_error(path + ": corrupt snapshot header");
+    }
+}
+
+bool SnapshotReader::isSnapshot(const string &path)
+{
+    ifstream file(path, ios::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+const SnapshotHeader &SnapshotReader::getHeader() const
+{
+    return header;
+}
+
+const SnapshotSectionEntry *SnapshotReader::findSection(SnapshotSection section) const
+{
+    for (uint32_t i = 0; i < header.sectionCount; i++)
+    {
+        if (header.sections[i].id == static_cast<uint32_t>(section))
+        {
+            return &header.sections[i];
+        }
+    }
+    return nullptr;
+}
+
+void SnapshotReader::readBytes(const SnapshotSectionEntry &entry, void *target)
+{
+    file.seekg(entry.offset);
+    file.read(static_cast<char *>(target), entry.size);
+    if (!file)
+    {
+        throw runtime_error(path + ": section " + to_string(entry.id) + " is truncated");
+    }
+    verifySection(entry, target);
+}
+
+void SnapshotReader::verifySection(const SnapshotSectionEntry &entry, const void *contents) const
+{
+    if (crc32(contents, entry.size) != entry.checksum)
+    {
+        throw runtime_error(path + ": checksum mismatch in section " + to_string(entry.id));
+    }
+}
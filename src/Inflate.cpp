@@ -0,0 +1,382 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "Inflate.hpp"
+
+using namespace std;
+
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+const int MAX_CODE_BITS = 15;
+const int LITERAL_CODES = 288;
+const int DISTANCE_CODES = 30;
+
+const uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+/**
+ * @brief Reads the bits of a DEFLATE stream, least significant bit first.
+ */
+class BitReader
+{
+public:
+    explicit BitReader(Span<const char> input) : input(input) {}
+
+    /**
+     * @brief Makes sure at least count bits are buffered. Past the end, zeros are buffered so
+     * a table lookup can peek, consuming them is detected by consume().
+     */
+    void fill(int count)
+    {
+        while (bitCount < count)
+        {
+            uint64_t byte = position < input.size() ? static_cast<unsigned char>(input[position]) : 0;
+            position++;
+            bitBuffer |= byte << bitCount;
+            bitCount += 8;
+        }
+    }
+
+    uint32_t peek(int count) const
+    {
+        return static_cast<uint32_t>(bitBuffer & ((uint64_t(1) << count) - 1));
+    }
+
+    void consume(int count)
+    {
+        bitBuffer >>= count;
+        bitCount -= count;
+        if (consumedBytes() > input.size())
+        {
+            throw runtime_error("DEFLATE stream is truncated");
+        }
+    }
+
+    uint32_t bits(int count)
+    {
+        fill(count);
+        uint32_t value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    /**
+     * @brief Drops the bits up to the next byte boundary, for stored blocks.
+     */
+    void alignToByte()
+    {
+        consume(bitCount % 8);
+    }
+
+    /**
+     * @brief Number of input bytes consumed so far, buffered whole bytes don't count.
+     */
+    size_t consumedBytes() const
+    {
+        return position - bitCount / 8;
+    }
+
+    /**
+     * @brief Copies whole bytes straight from the input, the reader has to be byte-aligned.
+     */
+    void copyBytes(size_t count, vector<char> &out)
+    {
+        size_t start = consumedBytes();
+        if (start + count > input.size())
+        {
+            throw runtime_error("DEFLATE stream is truncated");
+        }
+        out.insert(out.end(), input.data() + start, input.data() + start + count);
+        position = start + count;
+        bitBuffer = 0;
+        bitCount = 0;
+    }
+
+private:
+    Span<const char> input;
+    size_t position = 0;
+    uint64_t bitBuffer = 0;
+    int bitCount = 0;
+};
+
+/**
+ * @brief A canonical Huffman code as lookup table indexed by the next maxBits bits.
+ */
+struct HuffmanTable
+{
+    vector<uint16_t> symbols; ///< symbol of each table entry
+    vector<uint8_t> lengths;  ///< code length of each table entry, 0 for bit patterns that aren't a code
+    int maxBits = 0;
+
+    void build(const uint8_t *codeLengths, int symbolCount);
+    int decode(BitReader &reader) const;
+};
+
+HuffmanTable fixedTable(bool);
+void inflateBlock(BitReader &, vector<char> &, const HuffmanTable &, const HuffmanTable &);
+void readDynamicTables(BitReader &, HuffmanTable &, HuffmanTable &);
+
+size_t inflate(Span<const char> compressed, vector<char> &out)
+{
+    BitReader reader(compressed);
+    HuffmanTable literals, distances;
+    bool lastBlock = false;
+
+    while (!lastBlock)
+    {
+        lastBlock = reader.bits(1) == 1;
+        uint32_t type = reader.bits(2);
+
+        if (type == 0)
+        {
+            // stored block
+            reader.alignToByte();
+            uint32_t length = reader.bits(16);
+            uint32_t complement = reader.bits(16);
+            if ((length ^ 0xFFFF) != complement)
+            {
+                throw runtime_error("corrupt stored DEFLATE block");
+            }
+            reader.copyBytes(length, out);
+        }
+        else if (type == 1)
+        {
+            static const HuffmanTable fixedLiterals = fixedTable(true);
+            static const HuffmanTable fixedDistances = fixedTable(false);
+            inflateBlock(reader, out, fixedLiterals, fixedDistances);
+        }
+        else if (type == 2)
+        {
+            readDynamicTables(reader, literals, distances);
+            inflateBlock(reader, out, literals, distances);
+        }
+        else
+        {
+            throw runtime_error("invalid DEFLATE block type");
+        }
+    }
+
+    return reader.consumedBytes();
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Builds the lookup table of a canonical Huffman code from the code length of each symbol
+ *
+ * @param codeLengths length of the code of each symbol, 0 for unused symbols
+ * @param symbolCount number of symbols
+ * @throws runtime_error if the lengths describe an over-subscribed code
+ */
+void HuffmanTable::build(const uint8_t *codeLengths, int symbolCount)
+{
+    int counts[MAX_CODE_BITS + 1] = {0};
+    maxBits = 0;
+    for (int symbol = 0; symbol < symbolCount; symbol++)
+    {
+        counts[codeLengths[symbol]]++;
+        maxBits = max<int>(maxBits, codeLengths[symbol]);
+    }
+    counts[0] = 0;
+
+    // first code of each length, rejecting codes with more codes than bit patterns
+    int nextCode[MAX_CODE_BITS + 2] = {0};
+    int available = 1;
+    for (int bits = 1; bits <= MAX_CODE_BITS; bits++)
+    {
+        available = (available << 1) - counts[bits];
+        if (available < 0)
+        {
+            throw runtime_error("over-subscribed Huffman code in DEFLATE stream");
+        }
+        nextCode[bits + 1] = (nextCode[bits] + counts[bits]) << 1;
+    }
+
+    // a table without codes still needs one entry, decoding it fails
+    maxBits = max(maxBits, 1);
+    symbols.assign(size_t(1) << maxBits, 0);
+    lengths.assign(size_t(1) << maxBits, 0);
+    for (int symbol = 0; symbol < symbolCount; symbol++)
+    {
+        int length = codeLengths[symbol];
+        if (length == 0)
+        {
+            continue;
+        }
+
+        // codes are sent most significant bit first, the table is indexed by bits in reading order
+        uint32_t code = nextCode[length]++;
+        uint32_t reversed = 0;
+        for (int bit = 0; bit < length; bit++)
+        {
+            reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+        }
+        for (size_t index = reversed; index < symbols.size(); index += size_t(1) << length)
+        {
+            symbols[index] = static_cast<uint16_t>(symbol);
+            lengths[index] = static_cast<uint8_t>(length);
+        }
+    }
+}
+
+/**
+ * Decodes the next symbol
+ *
+ * @throws runtime_error if the bits are no code of the table
+ */
+int HuffmanTable::decode(BitReader &reader) const
+{
+    reader.fill(maxBits);
+    uint32_t index = reader.peek(maxBits);
+    if (lengths[index] == 0)
+    {
+        throw runtime_error("invalid Huffman code in DEFLATE stream");
+    }
+    reader.consume(lengths[index]);
+    return symbols[index];
+}
+
+/**
+ * Builds the literal/length or the distance table of blocks with fixed codes
+ */
+HuffmanTable fixedTable(bool literals)
+{
+    uint8_t lengths[LITERAL_CODES];
+    HuffmanTable table;
+    if (literals)
+    {
+        memset(lengths, 8, 144);
+        memset(lengths + 144, 9, 112);
+        memset(lengths + 256, 7, 24);
+        memset(lengths + 280, 8, 8);
+        table.build(lengths, LITERAL_CODES);
+    }
+    else
+    {
+        memset(lengths, 5, DISTANCE_CODES);
+        table.build(lengths, DISTANCE_CODES);
+    }
+    return table;
+}
+
+/**
+ * Reads the code lengths of a dynamic block and builds its literal/length and distance tables
+ */
+void readDynamicTables(BitReader &reader, HuffmanTable &literals, HuffmanTable &distances)
+{
+    int literalCount = reader.bits(5) + 257;
+    int distanceCount = reader.bits(5) + 1;
+    int codeLengthCount = reader.bits(4) + 4;
+    if (literalCount > 286 || distanceCount > DISTANCE_CODES)
+    {
+        throw runtime_error("too many codes in dynamic DEFLATE block");
+    }
+
+    uint8_t codeLengthLengths[19] = {0};
+    for (int i = 0; i < codeLengthCount; i++)
+    {
+        codeLengthLengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(reader.bits(3));
+    }
+    HuffmanTable codeLengths;
+    codeLengths.build(codeLengthLengths, 19);
+
+    // literal/length and distance code lengths form one sequence, repeats may cross between them
+    uint8_t lengths[286 + DISTANCE_CODES] = {0};
+    int count = 0;
+    while (count < literalCount + distanceCount)
+    {
+        int symbol = codeLengths.decode(reader);
+        if (symbol < 16)
+        {
+            lengths[count++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint8_t repeated = 0;
+        int repeat;
+        if (symbol == 16)
+        {
+            if (count == 0)
+            {
+                throw runtime_error("repeated code length without a previous one in DEFLATE stream");
+            }
+            repeated = lengths[count - 1];
+            repeat = 3 + reader.bits(2);
+        }
+        else if (symbol == 17)
+        {
+            repeat = 3 + reader.bits(3);
+        }
+        else
+        {
+            repeat = 11 + reader.bits(7);
+        }
+        if (count + repeat > literalCount + distanceCount)
+        {
+            throw runtime_error("too many code lengths in dynamic DEFLATE block");
+        }
+        memset(lengths + count, repeated, repeat);
+        count += repeat;
+    }
+
+    if (lengths[256] == 0)
+    {
+        throw runtime_error("dynamic DEFLATE block without end code");
+    }
+    literals.build(lengths, literalCount);
+    distances.build(lengths + literalCount, distanceCount);
+}
+
+/**
+ * Decodes the symbols of a compressed block until its end code
+ */
+void inflateBlock(BitReader &reader, vector<char> &out, const HuffmanTable &literals, const HuffmanTable &distances)
+{
+    while (true)
+    {
+        int symbol = literals.decode(reader);
+        if (symbol < 256)
+        {
+            out.push_back(static_cast<char>(symbol));
+            continue;
+        }
+        if (symbol == 256)
+        {
+            return;
+        }
+
+        symbol -= 257;
+        if (symbol >= 29)
+        {
+            throw runtime_error("invalid length code in DEFLATE stream");
+        }
+        size_t length = LENGTH_BASE[symbol] + reader.bits(LENGTH_EXTRA[symbol]);
+
+        int distanceSymbol = distances.decode(reader);
+        if (distanceSymbol >= DISTANCE_CODES)
+        {
+            throw runtime_error("invalid distance code in DEFLATE stream");
+        }
+        size_t distance = DISTANCE_BASE[distanceSymbol] + reader.bits(DISTANCE_EXTRA[distanceSymbol]);
+        if (distance > out.size())
+        {
+            throw runtime_error("DEFLATE distance reaches before the start of the data");
+        }
+
+        // byte by byte, the copy may overlap the bytes it produces
+        size_t from = out.size() - distance;
+        for (size_t i = 0; i < length; i++)
+        {
+            char byte = out[from + i];
+            out.push_back(byte);
+        }
+    }
+}
@@ -0,0 +1,302 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "InputFile.hpp"
+#include "Checksum.hpp"
+#include "Inflate.hpp"
+
+using namespace std;
+
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+const uint32_t ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+const uint32_t ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+const uint32_t ZIP_END_SIGNATURE = 0x06054b50;
+const size_t ZIP_END_SIZE = 22;
+const size_t ZIP_MAX_COMMENT = 0xFFFF;
+
+uint32_t readLittleEndian(Span<const char>, size_t, size_t, const string &);
+bool endsWith(const string &, const string &);
+
+/*
+ * ======= ZipArchive ===============
+ */
+
+ZipArchive::ZipArchive(const string &path) : path(path), mapping(path)
+{
+    if (!mapping.isOpen())
+    {
+        return;
+    }
+    Span<const char> bytes = mapping.contents();
+
+    // the end of central directory record is followed only by the archive comment
+    if (bytes.size() < ZIP_END_SIZE)
+    {
+        throw runtime_error(path + " is not a zip archive");
+    }
+    size_t end = bytes.size() - ZIP_END_SIZE;
+    size_t lowest = end > ZIP_MAX_COMMENT ? end - ZIP_MAX_COMMENT : 0;
+    while (readLittleEndian(bytes, end, 4, path) != ZIP_END_SIGNATURE)
+    {
+        if (end == lowest)
+        {
+            throw runtime_error(path + " is not a zip archive");
+        }
+        end--;
+    }
+
+    size_t entryCount = readLittleEndian(bytes, end + 10, 2, path);
+    size_t position = readLittleEndian(bytes, end + 16, 4, path);
+    if (entryCount == 0xFFFF || position == 0xFFFFFFFF)
+    {
+        throw runtime_error(path + ": zip64 archives are not supported");
+    }
+
+    entries.reserve(entryCount);
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        if (readLittleEndian(bytes, position, 4, path) != ZIP_CENTRAL_HEADER_SIGNATURE)
+        {
+            throw runtime_error(path + ": corrupt zip central directory");
+        }
+        Entry entry;
+        entry.flags = readLittleEndian(bytes, position + 8, 2, path);
+        entry.method = readLittleEndian(bytes, position + 10, 2, path);
+        entry.crc = readLittleEndian(bytes, position + 16, 4, path);
+        entry.compressedSize = readLittleEndian(bytes, position + 20, 4, path);
+        entry.size = readLittleEndian(bytes, position + 24, 4, path);
+        size_t nameSize = readLittleEndian(bytes, position + 28, 2, path);
+        size_t extraSize = readLittleEndian(bytes, position + 30, 2, path);
+        size_t commentSize = readLittleEndian(bytes, position + 32, 2, path);
+        entry.localHeaderOffset = readLittleEndian(bytes, position + 42, 4, path);
+        if (position + 46 + nameSize > bytes.size())
+        {
+            throw runtime_error(path + ": corrupt zip central directory");
+        }
+        entry.name.assign(bytes.data() + position + 46, nameSize);
+        entries.push_back(move(entry));
+        position += 46 + nameSize + extraSize + commentSize;
+    }
+}
+
+bool ZipArchive::isOpen() const
+{
+    return mapping.isOpen();
+}
+
+vector<string> ZipArchive::entryNames() const
+{
+    vector<string> names;
+    names.reserve(entries.size());
+    for (const Entry &entry : entries)
+    {
+        names.push_back(entry.name);
+    }
+    return names;
+}
+
+bool ZipArchive::hasEntry(const string &name) const
+{
+    for (const Entry &entry : entries)
+    {
+        if (entry.name == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+vector<char> ZipArchive::read(const string &name) const
+{
+    const Entry *entry = nullptr;
+    for (const Entry &candidate : entries)
+    {
+        if (candidate.name == name)
+        {
+            entry = &candidate;
+            break;
+        }
+    }
+    if (entry == nullptr)
+    {
+        throw runtime_error(path + " has no entry " + name);
+    }
+    if (entry->flags & 1)
+    {
+        throw runtime_error(path + ": encrypted entry " + name + " is not supported");
+    }
+
+    // the local header may have another extra field than the central directory
+    Span<const char> bytes = mapping.contents();
+    size_t header = entry->localHeaderOffset;
+    if (readLittleEndian(bytes, header, 4, path) != ZIP_LOCAL_HEADER_SIGNATURE)
+    {
+        throw runtime_error(path + ": corrupt local header of " + name);
+    }
+    size_t dataStart = header + 30 + readLittleEndian(bytes, header + 26, 2, path) + readLittleEndian(bytes, header + 28, 2, path);
+    if (dataStart + entry->compressedSize > bytes.size())
+    {
+        throw runtime_error(path + ": entry " + name + " is truncated");
+    }
+    Span<const char> data(bytes.data() + dataStart, entry->compressedSize);
+
+    vector<char> contents;
+    contents.reserve(entry->size);
+    if (entry->method == 0)
+    {
+        contents.assign(data.begin(), data.end());
+    }
+    else if (entry->method == 8)
+    {
+        inflate(data, contents);
+    }
+    else
+    {
+        throw runtime_error(path + ": compression method " + to_string(entry->method) + " of " + name + " is not supported");
+    }
+
+    if (contents.size() != entry->size || crc32(contents.data(), contents.size()) != entry->crc)
+    {
+        throw runtime_error(path + ": checksum mismatch in entry " + name);
+    }
+    return contents;
+}
+
+/*
+ * ======= gzip ===============
+ */
+
+vector<char> readGzip(Span<const char> contents, const string &name)
+{
+    vector<char> out;
+    if (contents.size() >= 4)
+    {
+        // the size of the last member is a good guess for single-member files
+        out.reserve(readLittleEndian(contents, contents.size() - 4, 4, name));
+    }
+
+    size_t position = 0;
+    do
+    {
+        if (readLittleEndian(contents, position, 2, name) != 0x8b1f || readLittleEndian(contents, position + 2, 1, name) != 8)
+        {
+            throw runtime_error(name + " is not a gzip file");
+        }
+        uint32_t flags = readLittleEndian(contents, position + 3, 1, name);
+        position += 10;
+
+        if (flags & 4) // extra field
+        {
+            position += 2 + readLittleEndian(contents, position, 2, name);
+        }
+        for (uint32_t zeroTerminated : {8u, 16u}) // file name and comment
+        {
+            if (flags & zeroTerminated)
+            {
+                while (readLittleEndian(contents, position, 1, name) != 0)
+                {
+                    position++;
+                }
+                position++;
+            }
+        }
+        if (flags & 2) // header checksum
+        {
+            position += 2;
+        }
+        if (position > contents.size())
+        {
+            throw runtime_error(name + ": gzip header is truncated");
+        }
+
+        size_t memberStart = out.size();
+        position += inflate(Span<const char>(contents.data() + position, contents.size() - position), out);
+
+        uint32_t crc = readLittleEndian(contents, position, 4, name);
+        uint32_t size = readLittleEndian(contents, position + 4, 4, name);
+        position += 8;
+        if (crc32(out.data() + memberStart, out.size() - memberStart) != crc || static_cast<uint32_t>(out.size() - memberStart) != size)
+        {
+            throw runtime_error(name + ": gzip checksum mismatch");
+        }
+    } while (position < contents.size());
+
+    return out;
+}
+
+/*
+ * ======= InputFile ===============
+ */
+
+InputFile::InputFile(const string &path)
+{
+    size_t separator = path.find(ARCHIVE_SEPARATOR);
+    if (separator != string::npos)
+    {
+        ZipArchive archive(path.substr(0, separator));
+        string entryName = path.substr(separator + strlen(ARCHIVE_SEPARATOR));
+        if (archive.isOpen() && archive.hasEntry(entryName))
+        {
+            decompressed = archive.read(entryName);
+            isDecompressed = true;
+        }
+        return;
+    }
+
+    mapping = MappedFile(path);
+    if (mapping.isOpen() && endsWith(path, ".gz"))
+    {
+        decompressed = readGzip(mapping.contents(), path);
+        isDecompressed = true;
+        mapping = MappedFile();
+    }
+}
+
+bool InputFile::isOpen() const
+{
+    return isDecompressed || mapping.isOpen();
+}
+
+Span<const char> InputFile::contents() const
+{
+    if (isDecompressed)
+    {
+        return Span<const char>(decompressed.data(), decompressed.size());
+    }
+    return mapping.contents();
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Reads an unsigned little endian number of 1 to 4 bytes
+ *
+ * @throws runtime_error if the number reaches past the end of bytes
+ */
+uint32_t readLittleEndian(Span<const char> bytes, size_t position, size_t size, const string &name)
+{
+    if (position + size > bytes.size())
+    {
+        throw runtime_error(name + " is truncated");
+    }
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[position + i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Checks if text ends with suffix
+ */
+bool endsWith(const string &text, const string &suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
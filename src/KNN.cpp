@@ -1,13 +1,110 @@
-#include <queue>
-#include <unordered_set>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
 #include <iostream>
 #include <algorithm>
 
 #include "KNN.hpp"
+#include "Parallel.hpp"
 
 using namespace std;
 
+const size_t FUSED_BLOCK_NODES = 1024; ///< nodes filled concurrently by estimateFeaturesFused before writing back
+
+/*
+ * ======= Declaration of local helper functions ===============
+ */
+
+bool isCloser(const pair<int, int> &, const pair<int, int> &);
+bool hasMissingFeature(Span<const double>);
+bool missesAnyColumn(Span<const double>, const vector<size_t> &);
+
+/**
+ * @brief Bounded BFS that only remembers the nodes it has queued, so its memory depends on k instead of the graph.
+ *
+ * The visited nodes are kept in a small open addressing table, reset by an epoch counter between searches.
+ */
+class NearestNodeSearch
+{
+public:
+    explicit NearestNodeSearch(int k) : k(max(k, 0))
+    {
+        // at most k + 1 nodes are queued, so the table stays at most half full
+        while ((size_t(1) << tableBits) < 2 * (static_cast<size_t>(this->k) + 1))
+        {
+            tableBits++;
+        }
+        tableNodes.resize(size_t(1) << tableBits);
+        tableStamps.assign(size_t(1) << tableBits, 0);
+        toVisit.reserve(this->k + 1);
+    }
+
+    /**
+     * @brief Finds up to k nodes closest to source, like KNN::calcPaths does.
+     *
+     * @return the found (node, distance) pairs, closest first and ties by node ID. Valid until the next call
+     */
+    template <typename Edges>
+    const vector<pair<int, int>> &find(const Edges &edges, int source)
+    {
+        if (++epoch == 0) // wrapped around, old stamps could match again
+        {
+            fill(tableStamps.begin(), tableStamps.end(), 0);
+            epoch = 1;
+        }
+        toVisit.clear();
+        markVisited(source);
+        toVisit.emplace_back(source, 0);
+
+        int foundNeighbors = 0;
+        for (size_t head = 0; head < toVisit.size() && foundNeighbors < k; head++)
+        {
+            auto [current, distance] = toVisit[head];
+            for (int neighbor : edges.neighbors(current))
+            {
+                if (markVisited(neighbor))
+                {
+                    toVisit.emplace_back(neighbor, distance + 1);
+                    if (++foundNeighbors >= k)
+                        break;
+                }
+            }
+        }
+
+        nearest.assign(toVisit.begin() + 1, toVisit.end());
+        sort(nearest.begin(), nearest.end(), isCloser);
+        return nearest;
+    }
+
+private:
+    int k;
+    unsigned tableBits = 1;
+    vector<int> tableNodes;
+    vector<uint32_t> tableStamps; ///< a slot is in use if its stamp equals epoch
+    uint32_t epoch = 0;
+    vector<pair<int, int>> toVisit; ///< (node, distance) in BFS order, the source first
+    vector<pair<int, int>> nearest;
+
+    // returns false if node was already visited
+    bool markVisited(int node)
+    {
+        size_t mask = (size_t(1) << tableBits) - 1;
+        size_t slot = (static_cast<uint32_t>(node) * 2654435761u) >> (32 - tableBits);
+        while (tableStamps[slot] == epoch)
+        {
+            if (tableNodes[slot] == node)
+            {
+                return false;
+            }
+            slot = (slot + 1) & mask;
+        }
+        tableStamps[slot] = epoch;
+        tableNodes[slot] = node;
+        return true;
+    }
+};
+
 /*
  * ======= Implementation of IStrategy Interface methods =============
  */
@@ -19,9 +116,20 @@ void KNN::run()
         return;
     }
     
-    cacheNeighbors(*graph);
+    if (fused)
+    {
+        estimateFeaturesFused(*graph, k);
+        return;
+    }
     calcPaths(*graph, k);
-    estimateFeatures(*graph, k);
+    if (jacobi)
+    {
+        estimateFeaturesJacobi(*graph, k);
+    }
+    else
+    {
+        estimateFeatures(*graph, k);
+    }
 }
 
 shared_ptr<Graph> KNN::extractResults() const
@@ -48,143 +156,422 @@ void KNN::configure(const map<string, double> &params)
                  << maxIterations << endl;
         }
     }
+    if (params.find("threads") != params.end())
+    {
+        threads = static_cast<unsigned>(max(params.at("threads"), 0.0));
+    }
+    if (params.find("fused") != params.end())
+    {
+        fused = params.at("fused") != 0.0;
+    }
+    if (params.find("jacobi") != params.end())
+    {
+        jacobi = params.at("jacobi") != 0.0;
+    }
 }
 
 void KNN::reset()
 {
-    cachedNeighbors.clear();
-    precomputedPaths.clear();
+    pathOffsets.clear();
+    pathEntries.clear();
+    similarOffsets.clear();
+    similarIds.clear();
+    dependentOffsets.clear();
+    dependents.clear();
     k = 15;
+    threads = 0;
+    fused = false;
+    jacobi = false;
 }
 
 /*
  * ======= Strategy Methods ======================
  */
-void KNN::cacheNeighbors(const Graph &graph)
-{
-    //Each node and its neighbors are stored
-    for (const auto &node : graph.getNodes())
-    {
-        cachedNeighbors[node] = graph.getNeighbors(node);
-    }
-}
-
 void KNN::calcPaths(const Graph &graph, int k)
 {    //Calculate the shortest paths for all nodes up to a distance of k.
-    for (const auto &node : graph.getNodes())
-    {
-        unordered_map<int, int> distances;
-        queue<int> toVisit;
-        unordered_set<int> visited;
- 
-        distances[node] = 0;
-        toVisit.push(node);
-        visited.insert(node);
- 
-        int foundNeighbors = 0;
-        // Perform BFS, but stop if k nearest nodes are found
-        while (!toVisit.empty() && foundNeighbors < k)
+    vector<int> nodes = graph.getNodes();
+    size_t pushLimit = static_cast<size_t>(max(k, 0)) + 1; // the source and at most k found nodes
+    int maxNodeId = nodes.empty() ? -1 : *max_element(nodes.begin(), nodes.end());
+
+    // parallelFor hands out contiguous chunks by increasing thread index, so the rows
+    // of each thread can be appended in thread order afterwards
+    unsigned threadCount = threads == 0 ? defaultThreadCount() : threads;
+    vector<vector<pair<int, int>>> threadEntries(threadCount);
+    vector<size_t> rowSizes(nodes.size());
+
+    graph.visitEdges([&](const auto &edges)
+    {
+        parallelFor(0, nodes.size(), threadCount, [&](size_t begin, size_t end, unsigned threadIndex)
         {
-            int current = toVisit.front();
-            toVisit.pop();
- 
-            for (int neighbor : cachedNeighbors[current])
+            // a node is visited in the current BFS if its stamp equals epoch, so no array is cleared between sources
+            vector<uint32_t> stamps(maxNodeId + 1, 0);
+            vector<int> distances(maxNodeId + 1);
+            vector<int> toVisit(pushLimit);
+            uint32_t epoch = 0;
+            vector<pair<int, int>> &entries = threadEntries[threadIndex];
+
+            for (size_t i = begin; i < end; i++)
             {
-                if (visited.find(neighbor) == visited.end()) 
+                if (++epoch == 0) // wrapped around, old stamps could match again
+                {
+                    fill(stamps.begin(), stamps.end(), 0);
+                    epoch = 1;
+                }
+
+                int node = nodes[i];
+                size_t rowBegin = entries.size();
+                size_t head = 0, tail = 0;
+                stamps[node] = epoch;
+                distances[node] = 0;
+                toVisit[tail++] = node;
+
+                int foundNeighbors = 0;
+                // Perform BFS, but stop if k nearest nodes are found
+                while (head < tail && foundNeighbors < k)
                 {
-                    distances[neighbor] = distances[current] + 1;
-                    toVisit.push(neighbor);
-                    visited.insert(neighbor);
-                    foundNeighbors++;
- 
-                    if (foundNeighbors >= k) 
-                        break; 
+                    int current = toVisit[head++];
+
+                    for (int neighbor : edges.neighbors(current))
+                    {
+                        if (static_cast<size_t>(neighbor) >= stamps.size()) // node only in the edge file
+                        {
+                            stamps.resize(neighbor + 1, 0);
+                            distances.resize(neighbor + 1);
+                        }
+                        if (stamps[neighbor] != epoch)
+                        {
+                            stamps[neighbor] = epoch;
+                            distances[neighbor] = distances[current] + 1;
+                            toVisit[tail++] = neighbor;
+                            entries.emplace_back(neighbor, distances[neighbor]);
+                            foundNeighbors++;
+
+                            if (foundNeighbors >= k)
+                                break;
+                        }
+                    }
                 }
+
+                sort(entries.begin() + rowBegin, entries.end(), isCloser);
+                rowSizes[i] = entries.size() - rowBegin;
+            }
+        });
+    });
+
+    pathOffsets.assign(nodes.size() + 1, 0);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        pathOffsets[i + 1] = pathOffsets[i] + rowSizes[i];
+    }
+    pathEntries.clear();
+    pathEntries.reserve(pathOffsets.back());
+    for (vector<pair<int, int>> &entries : threadEntries)
+    {
+        pathEntries.insert(pathEntries.end(), entries.begin(), entries.end());
+        vector<pair<int, int>>().swap(entries);
+    }
+}
+
+void KNN::buildSimilarLists(const Graph &graph, int k)
+{
+    size_t nodeCount = graph.getNodeCount();
+
+    //the closest k-neighbors within a distance of 'k' of every node, rows of pathEntries are sorted by distance
+    similarOffsets.assign(nodeCount + 1, 0);
+    similarIds.clear();
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        for (size_t entry = pathOffsets[i]; entry < pathOffsets[i + 1] && similarIds.size() - similarOffsets[i] < static_cast<size_t>(max(k, 0)); ++entry)
+        {
+            auto [neighbor, distance] = pathEntries[entry];
+            if (distance <= k)
+            {
+                similarIds.push_back(neighbor);
+            }
+        }
+        similarOffsets[i + 1] = similarIds.size();
+    }
+
+    //reverse lists: the nodes whose similar nodes include a node, so a new value only wakes up those
+    dependentOffsets.assign(nodeCount + 1, 0);
+    for (int neighbor : similarIds)
+    {
+        long slot = graph.getSlotById(neighbor);
+        if (slot >= 0)
+        {
+            dependentOffsets[slot + 1]++;
+        }
+    }
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        dependentOffsets[i + 1] += dependentOffsets[i];
+    }
+    dependents.resize(dependentOffsets.back());
+    vector<size_t> dependentCursor(dependentOffsets.begin(), dependentOffsets.end() - 1);
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        for (size_t entry = similarOffsets[i]; entry < similarOffsets[i + 1]; ++entry)
+        {
+            long slot = graph.getSlotById(similarIds[entry]);
+            if (slot >= 0)
+            {
+                dependents[dependentCursor[slot]++] = i;
             }
         }
-        precomputedPaths[node] = move(distances);
     }
 }
 
 void KNN::estimateFeatures(Graph &graph, int k)
 {
     vector<int> nodes = graph.getNodes();
+    size_t nodeCount = nodes.size();
+    buildSimilarLists(graph, k);
 
-    //reserve space for needsProcessing
-    vector<bool> needsProcessing;
-    needsProcessing.reserve(graph.getNodeCount()); 
-    needsProcessing.assign(graph.getNodeCount(), true); 
+    //the first sweep visits every node with a missing feature. A node is queued again only once one of its
+    //similar nodes gained a value in a column it is missing, in this sweep if it comes later, otherwise in the next
+    vector<size_t> nextFrontier;
+    vector<int> queuedForIteration(nodeCount, 0);
+    size_t nodesWithMissingFeature = 0;
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        if (hasMissingFeature(graph.featureRow(i)))
+        {
+            nextFrontier.push_back(i);
+            queuedForIteration[i] = 1;
+            nodesWithMissingFeature++;
+        }
+    }
+    priority_queue<size_t, vector<size_t>, greater<>> frontier;
 
+    vector<size_t> missingColumns;
+    vector<size_t> newColumns;
+    vector<Span<const double>> similarNodes;
     int currentIteration = 0;
-    //check every node, if a node still has a missing feature it gets checked again
     //stop if a node got checked to often to avoid infinite loops
-    while (currentIteration < maxIterations)
+    while (!nextFrontier.empty() && currentIteration < maxIterations)
     {
-        vector<bool> nextIterationProcessing;
-        nextIterationProcessing.reserve(graph.getNodeCount()); 
-        nextIterationProcessing.assign(graph.getNodeCount(), false); 
-        //track if any node is updated to allow early stopping
-        bool anyNodeProcessed = false; 
-
+        frontier = priority_queue<size_t, vector<size_t>, greater<>>(greater<>(), move(nextFrontier));
+        nextFrontier.clear();
         currentIteration++;
 
-        for (size_t i = 0; i < nodes.size(); ++i)
+        //process the queued nodes in node order, like a sweep over all nodes would
+        while (!frontier.empty())
         {
-            int node = nodes[i];
+            size_t i = frontier.top();
+            frontier.pop();
 
-            if (!needsProcessing[i])
-                continue; 
+            Span<const double> row = as_const(graph).featureRow(i);
+            missingColumns.clear();
+            for (size_t column = 0; column < row.size(); ++column)
+            {
+                if (isnan(row[column]))
+                {
+                    missingColumns.push_back(column);
+                }
+            }
 
-            const auto &topoDistance = precomputedPaths[node];
-            priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> minHeap;
+            similarNodes.clear();
+            for (size_t entry = similarOffsets[i]; entry < similarOffsets[i + 1]; ++entry)
+            {
+                similarNodes.push_back(graph.featureRowById(similarIds[entry]));
+            }
+            guessFeatures(nodes[i], similarNodes);
 
-            //filter out the neighbors that are within a distance of 'k'
-            for (const auto &[neighbor, distance] : topoDistance)
+            newColumns.clear();
+            for (size_t column : missingColumns)
             {
-                if (neighbor != node && distance <= k)
+                if (!isnan(row[column]))
                 {
-                    minHeap.push({distance, neighbor});
+                    newColumns.push_back(column);
                 }
             }
+            if (newColumns.empty())
+                continue;
+            if (newColumns.size() == missingColumns.size())
+                nodesWithMissingFeature--;
 
-            //collect feature vectors of the closest k-neighbors
-            vector<vector<double>> similarNodes;
-            for (int j = 0; j < k && !minHeap.empty(); ++j)
+            //wake up the nodes that miss one of the new values
+            for (size_t entry = dependentOffsets[i]; entry < dependentOffsets[i + 1]; ++entry)
             {
-                similarNodes.push_back(graph.getFeatureById(minHeap.top().second));
-                minHeap.pop();
+                size_t dependent = dependents[entry];
+                if (!missesAnyColumn(as_const(graph).featureRow(dependent), newColumns))
+                    continue;
+
+                if (dependent > i && queuedForIteration[dependent] < currentIteration)
+                {
+                    queuedForIteration[dependent] = currentIteration;
+                    frontier.push(dependent);
+                }
+                else if (dependent < i && queuedForIteration[dependent] < currentIteration + 1)
+                {
+                    queuedForIteration[dependent] = currentIteration + 1;
+                    nextFrontier.push_back(dependent);
+                }
             }
+        }
+    }
+
+    if (nodesWithMissingFeature > 0)
+    {
+        cerr << (nextFrontier.empty() ? "" : "Max iteration depth reached. ") << "Could not fill all features." << endl;
+    }
+}
+
+void KNN::estimateFeaturesJacobi(Graph &graph, int k)
+{
+    size_t nodeCount = graph.getNodeCount();
+    size_t featureCount = graph.getFeatureCount();
+    unsigned threadCount = threads == 0 ? defaultThreadCount() : threads;
+    buildSimilarLists(graph, k);
+
+    vector<size_t> frontier;
+    vector<int> queuedForIteration(nodeCount, 0);
+    size_t nodesWithMissingFeature = 0;
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        if (hasMissingFeature(graph.featureRow(i)))
+        {
+            frontier.push_back(i);
+            queuedForIteration[i] = 1;
+            nodesWithMissingFeature++;
+        }
+    }
+
+    vector<double> nextRows; // the second buffer, one row per queued node
+    vector<size_t> newColumns;
+    int currentIteration = 0;
+    //stop if a node got checked to often to avoid infinite loops
+    while (!frontier.empty() && currentIteration < maxIterations)
+    {
+        currentIteration++;
+
+        //fill the queued nodes from the values of the previous sweep, the feature matrix isn't written meanwhile
+        nextRows.resize(frontier.size() * featureCount);
+        parallelFor(0, frontier.size(), threadCount, [&](size_t begin, size_t end, unsigned)
+        {
+            vector<Span<const double>> similarNodes;
+            for (size_t position = begin; position < end; ++position)
+            {
+                size_t i = frontier[position];
+                similarNodes.clear();
+                for (size_t entry = similarOffsets[i]; entry < similarOffsets[i + 1]; ++entry)
+                {
+                    similarNodes.push_back(as_const(graph).featureRowById(similarIds[entry]));
+                }
+
+                Span<const double> row = as_const(graph).featureRow(i);
+                Span<double> nextRow(nextRows.data() + position * featureCount, featureCount);
+                copy(row.begin(), row.end(), nextRow.begin());
+                fillMissingFeatures(nextRow, similarNodes);
+            }
+        });
+
+        //write back and queue the nodes that miss one of the new values for the next sweep
+        vector<size_t> nextFrontier;
+        for (size_t position = 0; position < frontier.size(); ++position)
+        {
+            size_t i = frontier[position];
+            Span<double> row = graph.featureRow(i);
+            const double *nextRow = nextRows.data() + position * featureCount;
 
-            //revisit a node if it still has a missing feature
-            bool hasMissingFeature = false;
-            for (double feature : graph.getFeatureById(node))
+            newColumns.clear();
+            bool stillMissing = false;
+            for (size_t column = 0; column < featureCount; ++column)
             {
-                if (isnan(feature))
+                if (isnan(row[column]) && !isnan(nextRow[column]))
                 {
-                    hasMissingFeature = true;
-                    break;
+                    newColumns.push_back(column);
                 }
+                stillMissing = stillMissing || isnan(nextRow[column]);
             }
+            if (newColumns.empty())
+                continue;
+            copy(nextRow, nextRow + featureCount, row.begin());
+            if (!stillMissing)
+                nodesWithMissingFeature--;
 
-            if (hasMissingFeature)
+            for (size_t entry = dependentOffsets[i]; entry < dependentOffsets[i + 1]; ++entry)
             {
-                guessFeatures(node, similarNodes);
-                anyNodeProcessed = true;
+                size_t dependent = dependents[entry];
+                if (queuedForIteration[dependent] < currentIteration + 1 && missesAnyColumn(as_const(graph).featureRow(dependent), newColumns))
+                {
+                    queuedForIteration[dependent] = currentIteration + 1;
+                    nextFrontier.push_back(dependent);
+                }
+            }
+        }
+        sort(nextFrontier.begin(), nextFrontier.end());
+        frontier = move(nextFrontier);
+    }
+
+    if (nodesWithMissingFeature > 0)
+    {
+        cerr << (frontier.empty() ? "" : "Max iteration depth reached. ") << "Could not fill all features." << endl;
+    }
+}
+
+void KNN::estimateFeaturesFused(Graph &graph, int k)
+{
+    size_t nodeCount = graph.getNodeCount();
+    size_t featureCount = graph.getFeatureCount();
+    unsigned threadCount = threads == 0 ? defaultThreadCount() : threads;
+
+    vector<double> stagedRows(FUSED_BLOCK_NODES * featureCount);
+    vector<char> isStaged(FUSED_BLOCK_NODES);
+    vector<NearestNodeSearch> searches(threadCount, NearestNodeSearch(k));
 
-                // Check if missing features remain
-                for (double feature : graph.getFeatureById(node))
+    int currentIteration = 0;
+    //stop if a node got checked to often to avoid infinite loops
+    while (currentIteration < maxIterations)
+    {
+        //track if any node is updated to allow early stopping
+        bool anyNodeProcessed = false;
+        currentIteration++;
+
+        for (size_t blockBegin = 0; blockBegin < nodeCount; blockBegin += FUSED_BLOCK_NODES)
+        {
+            size_t blockEnd = min(nodeCount, blockBegin + FUSED_BLOCK_NODES);
+
+            graph.visitEdges([&](const auto &edges)
+            {
+                parallelFor(blockBegin, blockEnd, threadCount, [&](size_t begin, size_t end, unsigned threadIndex)
                 {
-                    if (isnan(feature))
+                    vector<Span<const double>> similarNodes;
+                    for (size_t slot = begin; slot < end; slot++)
                     {
-                        nextIterationProcessing[i] = true; 
-                        break;
+                        Span<const double> row = as_const(graph).featureRow(slot);
+                        isStaged[slot - blockBegin] = hasMissingFeature(row);
+                        if (!isStaged[slot - blockBegin])
+                            continue;
+
+                        //collect feature rows of the closest k-neighbors within a distance of 'k'
+                        similarNodes.clear();
+                        for (auto [neighbor, distance] : searches[threadIndex].find(edges, graph.getIdBySlot(slot)))
+                        {
+                            if (distance <= k)
+                            {
+                                similarNodes.push_back(graph.featureRowById(neighbor));
+                            }
+                        }
+
+                        Span<double> stagedRow(stagedRows.data() + (slot - blockBegin) * featureCount, featureCount);
+                        copy(row.begin(), row.end(), stagedRow.begin());
+                        fillMissingFeatures(stagedRow, similarNodes);
                     }
+                });
+            });
+
+            for (size_t slot = blockBegin; slot < blockEnd; slot++)
+            {
+                if (isStaged[slot - blockBegin])
+                {
+                    const double *stagedRow = stagedRows.data() + (slot - blockBegin) * featureCount;
+                    copy(stagedRow, stagedRow + featureCount, graph.featureRow(slot).begin());
+                    anyNodeProcessed = true;
                 }
             }
         }
 
-        needsProcessing = move(nextIterationProcessing);
-
         //if no nodes were updated, exit early
         if (!anyNodeProcessed)
             break;
@@ -196,3 +583,38 @@ void KNN::estimateFeatures(Graph &graph, int k)
     }
 }
 
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * @brief Orders found (node, distance) pairs closest first, ties by node ID.
+ */
+bool isCloser(const pair<int, int> &a, const pair<int, int> &b)
+{
+    return a.second != b.second ? a.second < b.second : a.first < b.first;
+}
+
+/**
+ * @brief Tests whether a feature row contains a NaN.
+ */
+bool hasMissingFeature(Span<const double> features)
+{
+    for (double feature : features)
+    {
+        if (isnan(feature))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Tests whether a feature row is missing any of the given columns.
+ */
+bool missesAnyColumn(Span<const double> features, const vector<size_t> &columns)
+{
+    return any_of(columns.begin(), columns.end(), [&](size_t column)
+                  { return isnan(features[column]); });
+}
@@ -0,0 +1,138 @@
+#include "MappedAdjacencyEdges.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+/*
+ * =========== constructors ===============
+ */
+
+MappedAdjacencyEdges::MappedAdjacencyEdges(shared_ptr<MappedFile> mapping, Span<const EdgeOffset> offsets, Span<const int> adjacency, Span<double> weights)
+    : mapping(move(mapping)), offsets(offsets), adjacency(adjacency), edgeWeights(weights) {}
+
+MappedAdjacencyEdges::MappedAdjacencyEdges(shared_ptr<MappedFile> mapping, vector<EdgeOffset> offsets, Span<const int> adjacency, Span<double> weights)
+    : mapping(move(mapping)), adjacency(adjacency), edgeWeights(weights), heapOffsets(move(offsets))
+{
+    this->offsets = Span<const EdgeOffset>(heapOffsets.data(), heapOffsets.size());
+}
+
+/*
+ * ======= Interface Methoden ===============
+ */
+
+void MappedAdjacencyEdges::addEdge(int, int)
+{
+    throw logic_error("Edges of a memory-mapped graph can't be changed");
+}
+
+vector<int> MappedAdjacencyEdges::getNeighbors(int nodeID)
+{
+    return neighbors(nodeID).toVector();
+}
+
+Span<const int> MappedAdjacencyEdges::neighbors(int nodeID) const
+{
+    if (nodeID < 0 || static_cast<size_t>(nodeID) + 1 >= offsets.size())
+    {
+        return Span<const int>();
+    }
+    return Span<const int>(adjacency.data() + offsets[nodeID], adjacency.data() + offsets[nodeID + 1]);
+}
+
+bool MappedAdjacencyEdges::isEdge(int source, int destination)
+{
+    return findEdge(source, destination) >= 0;
+}
+
+vector<pair<int, int>> MappedAdjacencyEdges::getEdges() const
+{
+    vector<pair<int, int>> edges;
+    for (size_t node = 0; node + 1 < offsets.size(); node++)
+    {
+        Span<const int> adjacents = neighbors(static_cast<int>(node));
+        for (auto it = upper_bound(adjacents.begin(), adjacents.end(), static_cast<int>(node)); it != adjacents.end(); ++it)
+        {
+            edges.emplace_back(static_cast<int>(node), *it);
+        }
+    }
+    return edges;
+}
+
+void MappedAdjacencyEdges::setWeight(int source, int destination, double weight)
+{
+    long forward = findEdge(source, destination);
+    if (forward < 0)
+    {
+        return;
+    }
+
+    if (edgeWeights.empty())
+    {
+        heapWeights.assign(adjacency.size(), numeric_limits<double>::quiet_NaN());
+        edgeWeights = Span<double>(heapWeights.data(), heapWeights.size());
+    }
+    edgeWeights[forward] = weight;
+    edgeWeights[findEdge(destination, source)] = weight;
+}
+
+double MappedAdjacencyEdges::getWeight(int source, int destination) const
+{
+    long position = edgeWeights.empty() ? -1 : findEdge(source, destination);
+    return position < 0 ? numeric_limits<double>::quiet_NaN() : edgeWeights[position];
+}
+
+Span<const double> MappedAdjacencyEdges::weights(int nodeID) const
+{
+    Span<const int> adjacents = neighbors(nodeID);
+    if (!edgeWeights.empty())
+    {
+        size_t first = adjacents.data() - adjacency.data();
+        return Span<const double>(edgeWeights.data() + first, adjacents.size());
+    }
+
+    thread_local vector<double> unsetWeights;
+    unsetWeights.assign(adjacents.size(), numeric_limits<double>::quiet_NaN());
+    return Span<const double>(unsetWeights.data(), unsetWeights.size());
+}
+
+size_t MappedAdjacencyEdges::size() const
+{
+    call_once(selfLoopsCounted, [this]()
+              {
+        for (size_t node = 0; node + 1 < offsets.size(); node++)
+        {
+            selfLoopCount += findEdge(static_cast<int>(node), static_cast<int>(node)) >= 0;
+        } });
+    return (adjacency.size() + selfLoopCount) / 2; // every entry but a self-loop has a mirrored one
+}
+
+Span<const EdgeOffset> MappedAdjacencyEdges::csrOffsets() const
+{
+    return offsets;
+}
+
+Span<const int> MappedAdjacencyEdges::csrAdjacency() const
+{
+    return adjacency;
+}
+
+Span<const double> MappedAdjacencyEdges::csrWeights() const
+{
+    return edgeWeights;
+}
+
+/*
+ * ========= helper methods ============
+ */
+
+long MappedAdjacencyEdges::findEdge(int source, int destination) const
+{
+    Span<const int> adjacents = neighbors(source);
+    auto it = lower_bound(adjacents.begin(), adjacents.end(), destination);
+    if (it == adjacents.end() || *it != destination)
+    {
+        return -1;
+    }
+    return it - adjacency.data();
+}
@@ -0,0 +1,102 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "MappedFile.hpp"
+
+using namespace std;
+
+MappedFile::MappedFile(const string &path, bool copyOnWrite)
+{
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) == 0 && S_ISREG(fileStatus.st_mode))
+    {
+        opened = true;
+        length = static_cast<size_t>(fileStatus.st_size);
+
+        // mmap rejects empty mappings, an empty file simply has no contents
+        if (length > 0)
+        {
+            int protection = copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+            mapping = mmap(nullptr, length, protection, MAP_PRIVATE, fileDescriptor, 0);
+            if (mapping == MAP_FAILED)
+            {
+                mapping = nullptr;
+                length = 0;
+                opened = false;
+            }
+            else if (!copyOnWrite)
+            {
+                madvise(mapping, length, MADV_SEQUENTIAL); // read-only mappings are parsed front to back
+            }
+            writable = copyOnWrite && mapping != nullptr;
+        }
+    }
+
+    close(fileDescriptor); // the mapping stays valid without the descriptor
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : mapping(exchange(other.mapping, nullptr)), length(exchange(other.length, 0)), opened(exchange(other.opened, false)), writable(exchange(other.writable, false)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        mapping = exchange(other.mapping, nullptr);
+        length = exchange(other.length, 0);
+        opened = exchange(other.opened, false);
+        writable = exchange(other.writable, false);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+bool MappedFile::isOpen() const
+{
+    return opened;
+}
+
+Span<const char> MappedFile::contents() const
+{
+    return Span<const char>(static_cast<const char *>(mapping), length);
+}
+
+Span<char> MappedFile::writableContents()
+{
+    if (!writable)
+    {
+        return Span<char>();
+    }
+    return Span<char>(static_cast<char *>(mapping), length);
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+void MappedFile::unmap()
+{
+    if (mapping != nullptr)
+    {
+        munmap(mapping, length);
+        mapping = nullptr;
+    }
+    length = 0;
+    writable = false;
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "NodeOrdering.hpp"
+#include "IdIndex.hpp"
+
+using namespace std;
+
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+vector<int> orderByDegree(const vector<int> &, const vector<size_t> &);
+vector<int> orderByTraversal(const IEdges &, const vector<int> &, const vector<size_t> &, bool);
+
+/*
+ * ======= Public functions ===================
+ */
+
+NodeOrder parseNodeOrder(const string &name)
+{
+    string lowerName(name);
+    transform(lowerName.begin(), lowerName.end(), lowerName.begin(), [](unsigned char c)
+              { return tolower(c); });
+
+    if (lowerName == "input")
+    {
+        return NodeOrder::Input;
+    }
+    if (lowerName == "degree")
+    {
+        return NodeOrder::Degree;
+    }
+    if (lowerName == "rcm")
+    {
+        return NodeOrder::RCM;
+    }
+    if (lowerName == "bfs")
+    {
+        return NodeOrder::BFS;
+    }
+    throw invalid_argument("Unknown node order: " + name);
+}
+
+vector<int> computeNodeOrder(const IEdges &edges, const vector<int> &nodes, NodeOrder order)
+{
+    vector<size_t> degrees(nodes.size());
+    for (size_t position = 0; position < nodes.size(); position++)
+    {
+        degrees[position] = edges.neighbors(nodes[position]).size();
+    }
+
+    switch (order)
+    {
+    case NodeOrder::Degree:
+        return orderByDegree(nodes, degrees);
+    case NodeOrder::RCM:
+        return orderByTraversal(edges, nodes, degrees, true);
+    case NodeOrder::BFS:
+        return orderByTraversal(edges, nodes, degrees, false);
+    default:
+        return nodes;
+    }
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Sorts the nodes by descending degree, nodes of the same degree keep their relative order
+ *
+ * @param nodes the nodes to order
+ * @param degrees the degree of every node, by position in nodes
+ * @return the nodes in their new order
+ */
+vector<int> orderByDegree(const vector<int> &nodes, const vector<size_t> &degrees)
+{
+    vector<size_t> positions(nodes.size());
+    for (size_t position = 0; position < nodes.size(); position++)
+    {
+        positions[position] = position;
+    }
+    stable_sort(positions.begin(), positions.end(), [&](size_t a, size_t b)
+                { return degrees[a] > degrees[b]; });
+
+    vector<int> ordered;
+    ordered.reserve(nodes.size());
+    for (size_t position : positions)
+    {
+        ordered.push_back(nodes[position]);
+    }
+    return ordered;
+}
+
+/**
+ * Numbers the nodes in breadth-first order, one connected component after another.
+ *
+ * In Cuthill-McKee mode every component starts at its node of lowest degree, neighbors are
+ * visited by ascending degree and the final order is reversed.
+ *
+ * @param edges the edges between the nodes
+ * @param nodes the nodes to order
+ * @param degrees the degree of every node, by position in nodes
+ * @param cuthillMcKee true for reverse Cuthill-McKee, false for plain BFS in input order
+ * @return the nodes in their new order
+ */
+vector<int> orderByTraversal(const IEdges &edges, const vector<int> &nodes, const vector<size_t> &degrees, bool cuthillMcKee)
+{
+    IdIndex positionOf(nodes);
+
+    // candidates for starting a new component
+    vector<size_t> starts(nodes.size());
+    for (size_t position = 0; position < nodes.size(); position++)
+    {
+        starts[position] = position;
+    }
+    if (cuthillMcKee)
+    {
+        stable_sort(starts.begin(), starts.end(), [&](size_t a, size_t b)
+                    { return degrees[a] < degrees[b]; });
+    }
+
+    vector<char> visited(nodes.size(), false);
+    vector<size_t> queue; // visiting order, the part after head is still to be expanded
+    queue.reserve(nodes.size());
+    vector<size_t> discovered;
+
+    for (size_t start : starts)
+    {
+        if (visited[start])
+        {
+            continue;
+        }
+        visited[start] = true;
+        queue.push_back(start);
+
+        for (size_t head = queue.size() - 1; head < queue.size(); head++)
+        {
+            discovered.clear();
+            for (int neighbor : edges.neighbors(nodes[queue[head]]))
+            {
+                long position = positionOf.find(neighbor);
+                if (position >= 0 && !visited[position])
+                {
+                    visited[position] = true;
+                    discovered.push_back(static_cast<size_t>(position));
+                }
+            }
+            if (cuthillMcKee)
+            {
+                stable_sort(discovered.begin(), discovered.end(), [&](size_t a, size_t b)
+                            { return degrees[a] < degrees[b]; });
+            }
+            queue.insert(queue.end(), discovered.begin(), discovered.end());
+        }
+    }
+
+    if (cuthillMcKee)
+    {
+        reverse(queue.begin(), queue.end());
+    }
+
+    vector<int> ordered;
+    ordered.reserve(nodes.size());
+    for (size_t position : queue)
+    {
+        ordered.push_back(nodes[position]);
+    }
+    return ordered;
+}
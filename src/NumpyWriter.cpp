@@ -0,0 +1,224 @@
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "NumpyWriter.hpp"
+#include "Checksum.hpp"
+
+using namespace std;
+
+/*
+ * ======= Declaration of local helper functions ===================
+ */
+
+const char NPY_MAGIC[] = "\x93NUMPY";
+const size_t NPY_ALIGNMENT = 64; ///< header and data start are padded to this, like NumPy does
+const uint16_t ZIP_DOS_DATE = (0 << 9) | (1 << 5) | 1; ///< 1980-01-01, numpy.load ignores dates
+
+string npyHeader(const NumpyArray &);
+void appendLittleEndian(string &, uint64_t, size_t);
+
+char numpyByteOrder()
+{
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const char *>(&probe) == 1 ? '<' : '>';
+}
+
+void writeNpy(const string &fileName, const NumpyArray &array)
+{
+    ofstream file(fileName, ios::binary | ios::trunc);
+    if (!file.is_open())
+    {
+        throw runtime_error("Failed to open file for writing: " + fileName);
+    }
+
+    string header = npyHeader(array);
+    file.write(header.data(), header.size());
+    file.write(static_cast<const char *>(array.data), array.bytes);
+    file.close();
+    if (file.fail())
+    {
+        throw runtime_error("Failed to write NumPy file: " + fileName);
+    }
+}
+
+void writeNpz(const string &fileName, const vector<NumpyArray> &arrays)
+{
+    ofstream file(fileName, ios::binary | ios::trunc);
+    if (!file.is_open())
+    {
+        throw runtime_error("Failed to open file for writing: " + fileName);
+    }
+
+    string centralDirectory;
+    uint64_t position = 0;
+    for (const NumpyArray &array : arrays)
+    {
+        string entryName = array.name + ".npy";
+        string header = npyHeader(array);
+        uint64_t entrySize = header.size() + array.bytes;
+        if (entrySize > numeric_limits<uint32_t>::max() || position > numeric_limits<uint32_t>::max())
+        {
+            throw overflow_error(fileName + ": arrays above 4 GiB need zip64, write them as .npy files instead");
+        }
+        uint32_t crc = crc32(array.data, array.bytes, crc32(header.data(), header.size()));
+
+        // fields shared by the local header and the central directory, from "version needed" to the name length
+        string fields;
+        appendLittleEndian(fields, 20, 2); // version needed: 2.0
+        appendLittleEndian(fields, 0, 2);  // flags
+        appendLittleEndian(fields, 0, 2);  // method: stored
+        appendLittleEndian(fields, 0, 2);  // time
+        appendLittleEndian(fields, ZIP_DOS_DATE, 2);
+        appendLittleEndian(fields, crc, 4);
+        appendLittleEndian(fields, entrySize, 4); // compressed size
+        appendLittleEndian(fields, entrySize, 4); // uncompressed size
+        appendLittleEndian(fields, entryName.size(), 2);
+        appendLittleEndian(fields, 0, 2); // extra field length
+
+        string localHeader;
+        appendLittleEndian(localHeader, 0x04034b50, 4);
+        localHeader += fields + entryName;
+        file.write(localHeader.data(), localHeader.size());
+        file.write(header.data(), header.size());
+        file.write(static_cast<const char *>(array.data), array.bytes);
+
+        appendLittleEndian(centralDirectory, 0x02014b50, 4);
+        appendLittleEndian(centralDirectory, 20, 2); // version made by
+        centralDirectory += fields;
+        appendLittleEndian(centralDirectory, 0, 2); // comment length
+        appendLittleEndian(centralDirectory, 0, 2); // disk number
+        appendLittleEndian(centralDirectory, 0, 2); // internal attributes
+        appendLittleEndian(centralDirectory, 0, 4); // external attributes
+        appendLittleEndian(centralDirectory, position, 4);
+        centralDirectory += entryName;
+
+        position += localHeader.size() + entrySize;
+    }
+    if (position > numeric_limits<uint32_t>::max())
+    {
+        throw overflow_error(fileName + ": arrays above 4 GiB need zip64, write them as .npy files instead");
+    }
+
+    string end;
+    appendLittleEndian(end, 0x06054b50, 4);
+    appendLittleEndian(end, 0, 2); // this disk
+    appendLittleEndian(end, 0, 2); // disk of the central directory
+    appendLittleEndian(end, arrays.size(), 2);
+    appendLittleEndian(end, arrays.size(), 2);
+    appendLittleEndian(end, centralDirectory.size(), 4);
+    appendLittleEndian(end, position, 4);
+    appendLittleEndian(end, 0, 2); // comment length
+
+    file.write(centralDirectory.data(), centralDirectory.size());
+    file.write(end.data(), end.size());
+    file.close();
+    if (file.fail())
+    {
+        throw runtime_error("Failed to write NumPy archive: " + fileName);
+    }
+}
+
+/*
+ * ======= NumpyGraphExport ===============
+ */
+
+NumpyGraphExport::NumpyGraphExport(const Graph &graph) : graph(graph)
+{
+    size_t nodeCount = graph.getNodeCount();
+    nodeIds.resize(nodeCount);
+    labels.resize(nodeCount);
+    for (size_t slot = 0; slot < nodeCount; slot++)
+    {
+        int nodeId = graph.getIdBySlot(slot);
+        nodeIds[slot] = graph.getOriginalId(nodeId);
+        labels[slot] = graph.getLabelById(nodeId);
+    }
+}
+
+void NumpyGraphExport::addEmbeddings(const unordered_map<int, vector<double>> &embeddings)
+{
+    embeddingDimensions = 0;
+    for (const auto &[nodeId, embedding] : embeddings)
+    {
+        embeddingDimensions = max(embeddingDimensions, embedding.size());
+    }
+
+    embeddingMatrix.assign(nodeIds.size() * embeddingDimensions, numeric_limits<double>::quiet_NaN());
+    for (size_t slot = 0; slot < nodeIds.size(); slot++)
+    {
+        auto embedding = embeddings.find(graph.getIdBySlot(slot));
+        if (embedding != embeddings.end())
+        {
+            copy(embedding->second.begin(), embedding->second.end(), embeddingMatrix.begin() + slot * embeddingDimensions);
+        }
+    }
+}
+
+vector<NumpyArray> NumpyGraphExport::arrays() const
+{
+    size_t nodeCount = nodeIds.size();
+    const double *features = nodeCount == 0 ? nullptr : graph.featureRow(0).data();
+
+    vector<NumpyArray> result = {
+        numpyArray("node_ids", nodeIds.data(), {nodeCount}),
+        numpyArray("features", features, {nodeCount, graph.getFeatureCount()}),
+        numpyArray("labels", labels.data(), {nodeCount})};
+    if (embeddingDimensions > 0)
+    {
+        result.push_back(numpyArray("embeddings", embeddingMatrix.data(), {nodeCount, embeddingDimensions}));
+    }
+    return result;
+}
+
+void NumpyGraphExport::saveNpy(const string &prefix) const
+{
+    for (const NumpyArray &array : arrays())
+    {
+        writeNpy(prefix + "_" + array.name + ".npy", array);
+    }
+}
+
+void NumpyGraphExport::saveNpz(const string &fileName) const
+{
+    writeNpz(fileName, arrays());
+}
+
+/*
+ * =========== local helper functions ==============
+ */
+
+/**
+ * Builds the magic, version and header dictionary of an .npy file, padded so the data starts aligned
+ */
+string npyHeader(const NumpyArray &array)
+{
+    string shape = "(";
+    for (size_t i = 0; i < array.shape.size(); i++)
+    {
+        shape += to_string(array.shape[i]) + (array.shape.size() == 1 ? "," : i + 1 < array.shape.size() ? ", " : "");
+    }
+    shape += ")";
+
+    string dictionary = "{'descr': '" + array.descr + "', 'fortran_order': False, 'shape': " + shape + ", }";
+    size_t prefixSize = sizeof(NPY_MAGIC) - 1 + 2 + 2; // magic, version, header length
+    size_t padding = NPY_ALIGNMENT - (prefixSize + dictionary.size() + 1) % NPY_ALIGNMENT;
+    dictionary += string(padding % NPY_ALIGNMENT, ' ') + "\n";
+
+    string header(NPY_MAGIC, sizeof(NPY_MAGIC) - 1);
+    header += '\x01';
+    header += '\x00';
+    appendLittleEndian(header, dictionary.size(), 2);
+    return header + dictionary;
+}
+
+/**
+ * Appends the lowest bytes of a value, least significant first
+ */
+void appendLittleEndian(string &out, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+    {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
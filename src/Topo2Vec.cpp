@@ -12,6 +12,7 @@ using namespace std;
  * ======= Declaration of local helper functions ===================
  */
 
+vector<int> getSubgraphMembers(const vector<int> &);
 double getCandidateParticipation(shared_ptr<Graph>, const vector<int> &, int);
 void initializeEmbeddings(shared_ptr<Graph>, unordered_map<int, vector<double>> &, int);
 void l2normalize(unordered_map<int, vector<double>> &);
@@ -30,10 +31,12 @@ void Topo2Vec::run()
     for (auto node : graph->getNodes())
     {
         auto nodesSample = getSample(embeddings, sampleSize);
-        vector<vector<double>> similarNodes = getFeaturesOfSimilarNodes(embeddings, embeddings[node], k);
+        vector<Span<const double>> similarNodes = getFeaturesOfSimilarNodes(embeddings, embeddings[node], k);
         guessFeatures(node, similarNodes);
   
     }
+
+    learnedEmbeddings = move(embeddings);
 }
 
 shared_ptr<Graph> Topo2Vec::extractResults() const
@@ -77,6 +80,7 @@ void Topo2Vec::reset()
     windowSize = 5;
     numNegativeSamples = 5;
     learningRate = 0.025;
+    learnedEmbeddings.clear();
 }
 
 
@@ -132,9 +136,10 @@ vector<vector<int>> Topo2Vec::getContextSubgraphs()
             continue;
         }
 
+        vector<int> subgraphMembers = getSubgraphMembers(templist);
         for (int candidateNodeID : templist)
         {
-            naScore = getCandidateParticipation(graph, templist, candidateNodeID) / graph->getNeighbors(candidateNodeID).size();
+            naScore = getCandidateParticipation(graph, subgraphMembers, candidateNodeID) / graph->neighbors(candidateNodeID).size();
             naScores.emplace_back(naScore);
         }
         filterAndSort(templist, naScores, tau); // templist is now the context subgraph for the current Node
@@ -143,7 +148,7 @@ vector<vector<int>> Topo2Vec::getContextSubgraphs()
         for (int nodeID : templist)
         {
             // Count edges with already present nodes
-            for (int neighbor : graph->getNeighbors(nodeID))
+            for (int neighbor : graph->neighbors(nodeID))
             {
                 if (subgraphNodes.count(neighbor)) // If edge already in subgraph, count it
                 {
@@ -174,8 +179,7 @@ void Topo2Vec::expandSubgraph(vector<int> &templist, unordered_map<int, bool> &v
     it = unique(returnTemplist.begin(), returnTemplist.end());
     returnTemplist.resize(distance(returnTemplist.begin(), it));
 
-    vector<int> nodeIDs = graph->getNodes();
-
+    vector<int> subgraphMembers = getSubgraphMembers(templist);
     vector<int> candidateNodeNeighbors;
     double naScore, saScore;
     vector<double> naScores, saScores;
@@ -188,12 +192,13 @@ void Topo2Vec::expandSubgraph(vector<int> &templist, unordered_map<int, bool> &v
         }
 
         visited[candidateNodeID] = true;
-        candidateNodeNeighbors = graph->getNeighbors(candidateNodeID);
+        Span<const int> neighborsOfCandidate = graph->neighbors(candidateNodeID);
+        candidateNodeNeighbors.assign(neighborsOfCandidate.begin(), neighborsOfCandidate.end()); // gets filtered below
 
         // expand with neighborhood-important neighbors
         for (int candidateNodeNeighborID : candidateNodeNeighbors)
         {
-            naScore = getCandidateParticipation(graph, templist, candidateNodeNeighborID) / graph->getNeighbors(candidateNodeNeighborID).size();
+            naScore = getCandidateParticipation(graph, subgraphMembers, candidateNodeNeighborID) / graph->neighbors(candidateNodeNeighborID).size();
             naScores.emplace_back(naScore);
         }
         filterAndSort(candidateNodeNeighbors, naScores, tau);
@@ -201,7 +206,7 @@ void Topo2Vec::expandSubgraph(vector<int> &templist, unordered_map<int, bool> &v
         // expand with subgraph-important neighbors
         for (int candidateNodeNeighborID : candidateNodeNeighbors)
         {
-            saScore = getCandidateParticipation(graph, templist, candidateNodeNeighborID) / edgesInSubgraphCount;
+            saScore = getCandidateParticipation(graph, subgraphMembers, candidateNodeNeighborID) / edgesInSubgraphCount;
             saScores.emplace_back(saScore);
         }
         filterAndSort(candidateNodeNeighbors, saScores, tau);
@@ -209,7 +214,7 @@ void Topo2Vec::expandSubgraph(vector<int> &templist, unordered_map<int, bool> &v
         // count added edges in subgraph
         for (int candidateNodeID : candidateNodeNeighbors)
         {
-            for (int neighborID : graph->getNeighbors(candidateNodeID))
+            for (int neighborID : graph->neighbors(candidateNodeID))
             {
                 if (subgraphNodes.count(neighborID))
                 {
@@ -227,27 +232,42 @@ void Topo2Vec::expandSubgraph(vector<int> &templist, unordered_map<int, bool> &v
 }
 
 
+/**
+ * sorts the nodes of a subgraph and removes duplicates, so candidates can be checked against it in one batch
+ *
+ * @param templist the current subgraph, may contain nodes more than once
+ *
+ * @return the distinct nodes of the subgraph in ascending order
+ */
+vector<int> getSubgraphMembers(const vector<int> &templist)
+{
+    vector<int> members(templist);
+    sort(members.begin(), members.end());
+    members.erase(unique(members.begin(), members.end()), members.end());
+    return members;
+}
+
 /**
  * calculates how many of the neighbors of a candidate node are already in the subgraph
  *
  * @param graph the complete graph to get Neighbors of the candidate Node
- * @param templist the current subgraph
+ * @param subgraphMembers the distinct nodes of the current subgraph in ascending order
  * @param candidateNodeID ID of the node we might add to the subgraph
  *
  * @return how many neighbors of the candidateNode are in the subgraph
  */
-double getCandidateParticipation(shared_ptr<Graph> graph, const vector<int> &templist, int candidateNodeID)
+double getCandidateParticipation(shared_ptr<Graph> graph, const vector<int> &subgraphMembers, int candidateNodeID)
 {
-    vector<int> subgraph(templist);
-    vector<int> connectedNodes = graph->getNeighbors(candidateNodeID);
-
-    // calculate intersection of the neighbors of the candidate Node and the subgraph
-    vector<int> intersectionSubgraphConnectedNodes;
-    sort(subgraph.begin(), subgraph.end());
-    sort(connectedNodes.begin(), connectedNodes.end());
-    set_intersection(connectedNodes.begin(), connectedNodes.end(), subgraph.begin(), subgraph.end(), back_inserter(intersectionSubgraphConnectedNodes));
+    // one sorted batch of (candidate, member) pairs, answered with a single pass over the candidate's neighbors
+    thread_local vector<pair<int, int>> candidatePairs;
+    candidatePairs.clear();
+    for (int member : subgraphMembers)
+    {
+        candidatePairs.emplace_back(candidateNodeID, member);
+    }
 
-    return intersectionSubgraphConnectedNodes.size(); // size of intersections equals candidate participation
+    vector<bool> connected = graph->areEdges(candidatePairs);
+    return count(connected.begin(), connected.end(), true); // connected members equal candidate participation
 }
 
 /**
@@ -3,8 +3,10 @@
 #include <memory>
 
 #include "Graph.hpp"
+#include "ExternalCsrBuilder.hpp"
 #include "AttributedDeepwalk.hpp"
 #include "KNN.hpp"
+#include "FeatureKNN.hpp"
 #include "Topo2Vec.hpp"
 #include "StrategyRunner.hpp"
 
@@ -13,10 +15,63 @@ namespace py = pybind11;
 
 PYBIND11_MODULE(semProject, m)
 {
-    m.doc() = "Python Bindings for Attributed DeepWalk, kNN and Topo2Vec";
+    m.doc() = "Python Bindings for Attributed DeepWalk, kNN, feature space kNN and Topo2Vec";
+
+    py::enum_<NodeOrder>(m, "NodeOrder")
+        .value("INPUT", NodeOrder::Input)
+        .value("DEGREE", NodeOrder::Degree)
+        .value("RCM", NodeOrder::RCM)
+        .value("BFS", NodeOrder::BFS);
+
+    py::enum_<SnapshotAccess>(m, "SnapshotAccess")
+        .value("READ", SnapshotAccess::Read)
+        .value("MAP", SnapshotAccess::Map);
+
+    py::class_<LoadTimings>(m, "LoadTimings")
+        .def_readonly("edge_read_seconds", &LoadTimings::edgeReadSeconds)
+        .def_readonly("edge_parse_seconds", &LoadTimings::edgeParseSeconds)
+        .def_readonly("csr_build_seconds", &LoadTimings::csrBuildSeconds)
+        .def_readonly("node_read_seconds", &LoadTimings::nodeReadSeconds)
+        .def_readonly("node_parse_seconds", &LoadTimings::nodeParseSeconds)
+        .def_readonly("reorder_seconds", &LoadTimings::reorderSeconds)
+        .def_readonly("total_seconds", &LoadTimings::totalSeconds)
+        .def_property_readonly("edge_seconds", &LoadTimings::edgeSeconds)
+        .def_property_readonly("node_seconds", &LoadTimings::nodeSeconds);
 
     py::class_<Graph, shared_ptr<Graph>>(m, "Graph")
-        .def(py::init<const string &, const string &>(), py::arg("nodesFile"), py::arg("edgesFile"));
+        .def(py::init<const string &, const string &, NodeOrder>(), py::arg("nodesFile"), py::arg("edgesFile"), py::arg("order") = NodeOrder::Input)
+        .def(py::init<const string &, SnapshotAccess>(), py::arg("snapshotFile"), py::arg("access") = SnapshotAccess::Read)
+        .def("is_memory_mapped", &Graph::isMemoryMapped, "true if the graph works on a memory-mapped snapshot")
+        .def("get_load_timings", &Graph::getLoadTimings, "wall clock times of the phases of loading the text files")
+        .def("save", &Graph::save, py::arg("snapshotFile"), "writes the graph to a binary snapshot")
+        .def("get_original_id", &Graph::getOriginalId, "translates an internal node ID to the ID of the input files")
+        .def("get_internal_id", &Graph::getInternalId, "translates an ID of the input files to the internal node ID");
+
+    py::class_<ExternalCsrStats>(m, "ExternalCsrStats")
+        .def_readonly("build_seconds", &ExternalCsrStats::buildSeconds)
+        .def_readonly("peak_bytes", &ExternalCsrStats::peakBytes)
+        .def_readonly("edges_read", &ExternalCsrStats::edgesRead)
+        .def_readonly("runs", &ExternalCsrStats::runs)
+        .def_readonly("adjacency_entries", &ExternalCsrStats::adjacencyEntries)
+        .def_readonly("list_count", &ExternalCsrStats::listCount)
+        .def_readonly("removed_duplicates", &ExternalCsrStats::removedDuplicates)
+        .def_readonly("dropped_self_loops", &ExternalCsrStats::droppedSelfLoops)
+        .def_readonly("skipped_invalid_edges", &ExternalCsrStats::skippedInvalidEdges)
+        .def_readonly("malformed_lines", &ExternalCsrStats::malformedLines);
+
+    m.def(
+        "build_csr_file",
+        [](const string &edgesFile, const string &csrFile, size_t memoryBudget, const string &temporaryDirectory, bool dropSelfLoops)
+        {
+            ExternalCsrOptions options;
+            options.memoryBudget = memoryBudget;
+            options.temporaryDirectory = temporaryDirectory;
+            options.dropSelfLoops = dropSelfLoops;
+            return ExternalCsrBuilder(options).build(edgesFile, csrFile);
+        },
+        py::arg("edgesFile"), py::arg("csrFile"), py::arg("memoryBudget") = ExternalCsrOptions().memoryBudget,
+        py::arg("temporaryDirectory") = "", py::arg("dropSelfLoops") = false,
+        "converts an edge file into a CSR file usable as edgesFile of Graph, with bounded memory");
 
     py::class_<StrategyRunner<AttributedDeepwalk>>(m, "AttributedDeepwalk")
         .def(py::init<shared_ptr<Graph>>(), py::arg("graph"))
@@ -24,7 +79,9 @@ PYBIND11_MODULE(semProject, m)
         .def("extract_results", &StrategyRunner<AttributedDeepwalk>::extractResults, "extracts results")
         .def("configure", &StrategyRunner<AttributedDeepwalk>::configure, "configure parameters")
         .def("reset", &StrategyRunner<AttributedDeepwalk>::reset, "resets all configurations")
-        .def("save_features", &StrategyRunner<AttributedDeepwalk>::saveFeatures, "saves features as in original format");
+        .def("save_features", &StrategyRunner<AttributedDeepwalk>::saveFeatures, py::arg("graph"), py::arg("filename"), py::arg("fixedPrecision") = -1, "saves features as in original format")
+        .def("save_npy", &StrategyRunner<AttributedDeepwalk>::saveNpy, py::arg("graph"), py::arg("prefix"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npy files")
+        .def("save_npz", &StrategyRunner<AttributedDeepwalk>::saveNpz, py::arg("graph"), py::arg("filename"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npz archive");
 
     py::class_<StrategyRunner<KNN>>(m, "KNN")
         .def(py::init<shared_ptr<Graph>>(), py::arg("graph"))
@@ -32,7 +89,19 @@ PYBIND11_MODULE(semProject, m)
         .def("extract_results", &StrategyRunner<KNN>::extractResults, "extracts results")
         .def("configure", &StrategyRunner<KNN>::configure, "configure kNN-parameters")
         .def("reset", &StrategyRunner<KNN>::reset, "resets all configurations")
-        .def("save_features", &StrategyRunner<KNN>::saveFeatures, "saves features as in original format");
+        .def("save_features", &StrategyRunner<KNN>::saveFeatures, py::arg("graph"), py::arg("filename"), py::arg("fixedPrecision") = -1, "saves features as in original format")
+        .def("save_npy", &StrategyRunner<KNN>::saveNpy, py::arg("graph"), py::arg("prefix"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npy files")
+        .def("save_npz", &StrategyRunner<KNN>::saveNpz, py::arg("graph"), py::arg("filename"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npz archive");
+
+    py::class_<StrategyRunner<FeatureKNN>>(m, "FeatureKNN")
+        .def(py::init<shared_ptr<Graph>>(), py::arg("graph"))
+        .def("run", &StrategyRunner<FeatureKNN>::run, "runs kNN over the observed features")
+        .def("extract_results", &StrategyRunner<FeatureKNN>::extractResults, "extracts results")
+        .def("configure", &StrategyRunner<FeatureKNN>::configure, "configure parameters: k, cosine, threads, partitions, probes")
+        .def("reset", &StrategyRunner<FeatureKNN>::reset, "resets all configurations")
+        .def("save_features", &StrategyRunner<FeatureKNN>::saveFeatures, py::arg("graph"), py::arg("filename"), py::arg("fixedPrecision") = -1, "saves features as in original format")
+        .def("save_npy", &StrategyRunner<FeatureKNN>::saveNpy, py::arg("graph"), py::arg("prefix"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npy files")
+        .def("save_npz", &StrategyRunner<FeatureKNN>::saveNpz, py::arg("graph"), py::arg("filename"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npz archive");
 
     py::class_<StrategyRunner<Topo2Vec>>(m, "Topo2Vec")
         .def(py::init<shared_ptr<Graph>>(), py::arg("graph"))
@@ -40,5 +109,7 @@ PYBIND11_MODULE(semProject, m)
         .def("extract_results", &StrategyRunner<Topo2Vec>::extractResults, "extracts results")
         .def("configure", &StrategyRunner<Topo2Vec>::configure, "configure parameters")
         .def("reset", &StrategyRunner<Topo2Vec>::reset, "resets all configurations")
-        .def("save_features", &StrategyRunner<Topo2Vec>::saveFeatures, "saves features as in original format");
+        .def("save_features", &StrategyRunner<Topo2Vec>::saveFeatures, py::arg("graph"), py::arg("filename"), py::arg("fixedPrecision") = -1, "saves features as in original format")
+        .def("save_npy", &StrategyRunner<Topo2Vec>::saveNpy, py::arg("graph"), py::arg("prefix"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npy files")
+        .def("save_npz", &StrategyRunner<Topo2Vec>::saveNpz, py::arg("graph"), py::arg("filename"), py::arg("withEmbeddings") = false, "saves node IDs, features and labels as .npz archive");
 }
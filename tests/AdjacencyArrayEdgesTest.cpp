@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <cmath>
 
 #include "AdjacencyArrayEdges.hpp"
 #include "Graph.hpp"
@@ -36,6 +37,22 @@ TEST_F(AdjacencyArrayEdgesTest, GetNeighbors)
     }
 }
 
+// Test: neighbor views point into the adjacency array and match the copying API
+TEST_F(AdjacencyArrayEdgesTest, NeighborsView)
+{
+    for (int node : graph.getNodes())
+    {
+        Span<const int> view = edges.neighbors(node);
+        EXPECT_TRUE(view == edges.getNeighbors(node));
+        EXPECT_TRUE(std::is_sorted(view.begin(), view.end()));
+    }
+
+    // repeated calls view the same storage instead of copying
+    EXPECT_EQ(edges.neighbors(1).data(), edges.neighbors(1).data());
+    EXPECT_TRUE(edges.neighbors(-1).empty());
+    EXPECT_TRUE(edges.neighbors(5000).empty());
+}
+
 // Test: Check edge existence
 TEST_F(AdjacencyArrayEdgesTest, IsEdge)
 {
@@ -51,6 +68,42 @@ TEST_F(AdjacencyArrayEdgesTest, IsEdge)
     EXPECT_FALSE(edges.isEdge(500, 600));
 }
 
+// Test: batched queries and hub bitmaps answer like single lookups
+TEST_F(AdjacencyArrayEdgesTest, AreEdges)
+{
+    // every pair of the first nodes, in descending order so the batch has to be grouped first
+    std::vector<std::pair<int, int>> queries;
+    for (int source = 60; source >= -1; source--)
+    {
+        for (int destination = 183; destination >= -1; destination--)
+        {
+            queries.emplace_back(source, destination);
+        }
+    }
+
+    std::vector<bool> expected;
+    for (auto [source, destination] : queries)
+    {
+        expected.push_back(edges.isEdge(source, destination));
+    }
+    EXPECT_EQ(edges.areEdges(queries), expected);
+    EXPECT_TRUE(edges.areEdges(Span<const std::pair<int, int>>()).empty());
+
+    // every node with an edge becomes a hub
+    edges.enableHubBitmaps(1);
+    EXPECT_EQ(edges.areEdges(queries), expected);
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        EXPECT_EQ(edges.isEdge(queries[i].first, queries[i].second), expected[i]);
+    }
+
+    // bitmaps follow added edges
+    edges.addEdge(35, 87);
+    EXPECT_TRUE(edges.isEdge(87, 35));
+    edges.enableHubBitmaps(0);
+    EXPECT_TRUE(edges.isEdge(35, 87));
+}
+
 // Test: Retrieve all edges
 TEST_F(AdjacencyArrayEdgesTest, GetEdges)
 {
@@ -61,6 +114,66 @@ TEST_F(AdjacencyArrayEdgesTest, GetEdges)
     EXPECT_EQ(actualEdges, graphEdges);
 }
 
+// Test: weights are stored for both directions, aligned with the neighbors
+TEST_F(AdjacencyArrayEdgesTest, WeightsAlignedWithNeighbors)
+{
+    auto [node1, node2] = graph.getEdges()[0];
+    EXPECT_TRUE(std::isnan(edges.getWeight(node1, node2))); // unset weights are NaN
+
+    edges.setWeight(node1, node2, 0.25);
+    EXPECT_EQ(edges.getWeight(node1, node2), 0.25);
+    EXPECT_EQ(edges.getWeight(node2, node1), 0.25);
+
+    Span<const int> neighbors = edges.neighbors(node2);
+    Span<const double> weights = edges.weights(node2);
+    ASSERT_EQ(neighbors.size(), weights.size());
+    size_t position = std::find(neighbors.begin(), neighbors.end(), node1) - neighbors.begin();
+    EXPECT_EQ(weights[position], 0.25);
+
+    // weights of non-existing edges are not stored
+    edges.setWeight(10, 20, 1.0);
+    EXPECT_TRUE(std::isnan(edges.getWeight(10, 20)));
+}
+
+// Test: building drops duplicate edges and, if configured, self-loops, independent of the thread count
+TEST_F(AdjacencyArrayEdgesTest, BuildDeduplicatesAndDropsSelfLoops)
+{
+    std::vector<std::pair<int, int>> edgeList = {{0, 1}, {1, 0}, {0, 1}, {2, 2}, {3, 1}, {-1, 2}};
+
+    AdjacencyArrayEdges keepLoops(edgeList, CsrBuildOptions{1, false});
+    EXPECT_TRUE(keepLoops.neighbors(0) == std::vector<int>({1}));
+    EXPECT_TRUE(keepLoops.neighbors(1) == std::vector<int>({0, 3}));
+    EXPECT_TRUE(keepLoops.neighbors(2) == std::vector<int>({2}));
+    EXPECT_EQ(keepLoops.getBuildStats().removedDuplicates, 4u);
+    EXPECT_EQ(keepLoops.getBuildStats().skippedInvalidEdges, 1u);
+    EXPECT_EQ(keepLoops.size(), 3u); // the self-loop counts as an edge, but getEdges leaves it out
+    EXPECT_EQ(keepLoops.getEdges().size(), 2u);
+    EXPECT_EQ(AdjacencyArrayEdges(keepLoops.csrOffsets().toVector(), keepLoops.csrAdjacency().toVector(), {}).size(), 3u);
+
+    AdjacencyArrayEdges dropLoops(edgeList, CsrBuildOptions{4, true});
+    EXPECT_TRUE(dropLoops.neighbors(2).empty());
+    EXPECT_EQ(dropLoops.size(), 2u);
+    EXPECT_EQ(dropLoops.getBuildStats().droppedSelfLoops, 1u);
+    EXPECT_GT(dropLoops.getBuildStats().peakBytes, 0u);
+
+    // the result doesn't depend on the number of threads
+    AdjacencyArrayEdges singleThreaded(graph.getEdges(), CsrBuildOptions{1, false});
+    AdjacencyArrayEdges multiThreaded(graph.getEdges(), CsrBuildOptions{8, false});
+    EXPECT_EQ(singleThreaded.getEdges(), multiThreaded.getEdges());
+}
+
+// Test: offsets are 64 bits wide and have to end at the number of adjacency entries
+TEST_F(AdjacencyArrayEdgesTest, WideOffsets)
+{
+    static_assert(sizeof(EdgeOffset) == 8, "offsets have to address more than 2^31 adjacency entries");
+    EXPECT_EQ(edges.csrOffsets().back(), edges.csrAdjacency().size());
+    EXPECT_EQ(edges.size(), edges.csrAdjacency().size() / 2);
+
+    AdjacencyArrayEdges prebuilt({0, 1, 2}, {1, 0}, {});
+    EXPECT_TRUE(prebuilt.isEdge(1, 0));
+    EXPECT_THROW(AdjacencyArrayEdges({0, 1, 3}, {1, 0}, {}), std::invalid_argument);
+}
+
 // Test case: Test adding an edge to the BasicEdges object
 TEST_F(AdjacencyArrayEdgesTest, AddEdge)
 {
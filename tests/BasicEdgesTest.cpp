@@ -40,6 +40,15 @@ TEST_F(BasicEdgesTest, GetNeighbors)
    EXPECT_EQ(neighbors, expectedNeighbors);
 }
 
+// Test: neighbor views match the copying API
+TEST_F(BasicEdgesTest, NeighborsView)
+{
+    int testNode = 1;
+    vector<int> expectedNeighbors = graph->getNeighbors(testNode);
+    EXPECT_TRUE(edges->neighbors(testNode) == expectedNeighbors);
+    EXPECT_TRUE(graph->neighbors(testNode) == expectedNeighbors);
+}
+
 // Test: Check edge existence
 TEST_F(BasicEdgesTest, IsEdge)
 {
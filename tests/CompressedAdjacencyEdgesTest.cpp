@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+
+#include "CompressedAdjacencyEdges.hpp"
+#include "Graph.hpp"
+#include "GraphParser.hpp"
+#include "InputFile.hpp"
+
+const std::string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const std::string EDGE_FILE = "../input/cornell/cornell_edges.txt";
+
+// Test fixture for CompressedAdjacencyEdges, compressed from the edge file of the cornell graph
+class CompressedAdjacencyEdgesTest : public ::testing::Test
+{
+protected:
+    Graph graph;
+    CompressedAdjacencyEdges edges;
+
+    // built from the file rather than graph.getEdges(), which leaves out self-loops
+    CompressedAdjacencyEdgesTest() : graph(NODES_FILE, EDGE_FILE), edges(GraphParser().parseEdges(InputFile(EDGE_FILE).contents()).edges) {}
+};
+
+// Test: decoding reproduces the edges and neighbor lists of the graph
+TEST_F(CompressedAdjacencyEdgesTest, GetEdges)
+{
+    EXPECT_EQ(edges.getEdges(), graph.getEdges());
+    EXPECT_EQ(edges.size(), graph.getEdgeCount());
+
+    for (int node : graph.getNodes())
+    {
+        EXPECT_TRUE(edges.neighbors(node) == graph.getNeighbors(node)) << "Node " << node;
+        EXPECT_EQ(edges.getNeighbors(node), graph.getNeighbors(node)) << "Node " << node;
+    }
+}
+
+// Test: self-loops are stored once and counted, but not listed, like in AdjacencyArrayEdges
+TEST_F(CompressedAdjacencyEdgesTest, SelfLoops)
+{
+    std::vector<std::pair<int, int>> edgeList = {{0, 1}, {2, 2}};
+    CompressedAdjacencyEdges compressed(edgeList);
+    AdjacencyArrayEdges uncompressed(edgeList);
+
+    EXPECT_EQ(compressed.getEdges(), uncompressed.getEdges());
+    EXPECT_EQ(compressed.size(), uncompressed.size());
+    EXPECT_TRUE(compressed.neighbors(2) == std::vector<int>({2}));
+
+    compressed.addEdge(3, 3);
+    EXPECT_EQ(compressed.size(), uncompressed.size() + 1);
+    EXPECT_EQ(compressed.getEdges().size(), 1u);
+}
+
+// Test: lists spanning several blocks are found through the skip table
+TEST_F(CompressedAdjacencyEdgesTest, IsEdgeAcrossBlocks)
+{
+    std::vector<std::pair<int, int>> star;
+    for (int leaf = 1; leaf <= 1000; leaf++)
+    {
+        star.emplace_back(0, leaf * 3);
+    }
+    CompressedAdjacencyEdges hub(star);
+
+    EXPECT_EQ(hub.neighbors(0).size(), 1000u);
+    for (int leaf = 1; leaf <= 1000; leaf++)
+    {
+        EXPECT_TRUE(hub.isEdge(0, leaf * 3));
+        EXPECT_TRUE(hub.isEdge(leaf * 3, 0));
+        EXPECT_FALSE(hub.isEdge(0, leaf * 3 + 1));
+    }
+    EXPECT_FALSE(hub.isEdge(0, 3001));
+    EXPECT_FALSE(hub.isEdge(-1, 0));
+
+    for (auto [source, destination] : graph.getEdges())
+    {
+        EXPECT_TRUE(edges.isEdge(source, destination));
+        EXPECT_TRUE(edges.isEdge(destination, source));
+    }
+}
+
+// Test: added edges are re-encoded into both lists
+TEST_F(CompressedAdjacencyEdgesTest, AddEdge)
+{
+    int initialSize = edges.size();
+    auto [node1, node2] = graph.getEdges()[0];
+    edges.addEdge(node2, node1);
+    EXPECT_EQ(edges.size(), initialSize);
+
+    edges.addEdge(35, 87);
+    EXPECT_EQ(edges.size(), initialSize + 1);
+    EXPECT_TRUE(edges.isEdge(35, 87));
+    EXPECT_TRUE(edges.isEdge(87, 35));
+    EXPECT_TRUE(std::is_sorted(edges.neighbors(35).begin(), edges.neighbors(35).end()));
+    EXPECT_EQ(edges.getEdges().size(), static_cast<size_t>(edges.size()));
+
+    // nodes beyond the current lists, the ones in between get empty lists
+    edges.addEdge(5000, 1);
+    EXPECT_TRUE(edges.isEdge(1, 5000));
+    EXPECT_EQ(edges.neighbors(5000).size(), 1u);
+    EXPECT_TRUE(edges.neighbors(4999).empty());
+    EXPECT_TRUE(edges.weights(4999).empty());
+    EXPECT_FALSE(edges.isEdge(4000, 1));
+}
+
+// Test: edges added to an empty backend leave empty lists for the nodes below them
+TEST_F(CompressedAdjacencyEdgesTest, AddEdgeToEmpty)
+{
+    CompressedAdjacencyEdges empty;
+    empty.addEdge(0, 3);
+    EXPECT_TRUE(empty.neighbors(0) == std::vector<int>({3}));
+    EXPECT_TRUE(empty.neighbors(3) == std::vector<int>({0}));
+    for (int node : {1, 2})
+    {
+        EXPECT_TRUE(empty.neighbors(node).empty()) << "Node " << node;
+        EXPECT_FALSE(empty.isEdge(node, 0)) << "Node " << node;
+    }
+    EXPECT_EQ(empty.size(), 1u);
+
+    empty.setWeight(3, 0, 0.5);
+    empty.addEdge(6, 6);
+    EXPECT_EQ(empty.getWeight(0, 3), 0.5);
+    EXPECT_TRUE(empty.neighbors(5).empty());
+    EXPECT_TRUE(empty.weights(5).empty());
+    EXPECT_TRUE(empty.neighbors(6) == std::vector<int>({6}));
+    EXPECT_EQ(empty.size(), 2u);
+    EXPECT_EQ(empty.getEdges(), (std::vector<std::pair<int, int>>{{0, 3}}));
+}
+
+// Test: weights stay aligned with the decoded neighbors
+TEST_F(CompressedAdjacencyEdgesTest, Weights)
+{
+    EXPECT_TRUE(std::isnan(edges.getWeight(57, 96)));
+    EXPECT_EQ(edges.weights(57).size(), edges.neighbors(57).size());
+
+    edges.setWeight(57, 96, 2.5);
+    EXPECT_DOUBLE_EQ(edges.getWeight(96, 57), 2.5);
+
+    Span<const int> neighborList = edges.neighbors(57);
+    Span<const double> weightList = edges.weights(57);
+    ASSERT_EQ(neighborList.size(), weightList.size());
+    size_t position = std::find(neighborList.begin(), neighborList.end(), 96) - neighborList.begin();
+    EXPECT_DOUBLE_EQ(weightList[position], 2.5);
+
+    // compressing keeps the weights of the source
+    AdjacencyArrayEdges uncompressed(graph.getEdges());
+    uncompressed.setWeight(1, 2, 0.5);
+    CompressedAdjacencyEdges compressed(uncompressed);
+    EXPECT_DOUBLE_EQ(compressed.getWeight(2, 1), 0.5);
+}
+
+// Test: unweighted lists take less memory than the adjacency array
+TEST_F(CompressedAdjacencyEdgesTest, MemoryUsage)
+{
+    AdjacencyArrayEdges uncompressed(graph.getEdges());
+    EXPECT_LT(edges.memoryUsage(), uncompressed.memoryUsage());
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+
+#include "DeltaAdjacencyEdges.hpp"
+#include "Graph.hpp"
+#include "GraphParser.hpp"
+#include "InputFile.hpp"
+
+const std::string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const std::string EDGE_FILE = "../input/cornell/cornell_edges.txt";
+
+// Test fixture for DeltaAdjacencyEdges, filled edge by edge with a small merge threshold
+class DeltaAdjacencyEdgesTest : public ::testing::Test
+{
+protected:
+    Graph graph;
+    DeltaAdjacencyEdges edges;
+
+    DeltaAdjacencyEdgesTest() : graph(NODES_FILE, EDGE_FILE), edges({}, 64)
+    {
+        // added from the file rather than graph.getEdges(), which leaves out self-loops
+        for (auto [source, destination] : GraphParser().parseEdges(InputFile(EDGE_FILE).contents()).edges)
+        {
+            edges.addEdge(source, destination);
+        }
+    }
+};
+
+// Test: incrementally added edges match the edges of the graph, before and after merging
+TEST_F(DeltaAdjacencyEdgesTest, GetEdges)
+{
+    EXPECT_EQ(edges.getEdges(), graph.getEdges());
+    EXPECT_EQ(edges.size(), graph.getEdgeCount());
+
+    edges.compact();
+    EXPECT_EQ(edges.getDeltaSize(), 0u);
+    EXPECT_FALSE(edges.isMerging());
+    EXPECT_EQ(edges.getEdges(), graph.getEdges());
+}
+
+// Test: neighbors combine base and delta in sorted order
+TEST_F(DeltaAdjacencyEdgesTest, Neighbors)
+{
+    for (int node : graph.getNodes())
+    {
+        EXPECT_TRUE(edges.neighbors(node) == graph.getNeighbors(node)) << "Node " << node;
+        EXPECT_EQ(edges.baseNeighbors(node).size() + edges.appendedNeighbors(node).size(), graph.neighbors(node).size());
+    }
+
+    // after compacting, everything is viewed in the base
+    edges.compact();
+    EXPECT_TRUE(edges.appendedNeighbors(1).empty());
+    EXPECT_EQ(edges.neighbors(1).data(), edges.baseNeighbors(1).data());
+}
+
+// Test: duplicates are ignored, new edges are found
+TEST_F(DeltaAdjacencyEdgesTest, AddEdge)
+{
+    int initialSize = edges.size();
+    auto [node1, node2] = graph.getEdges()[0];
+    edges.addEdge(node2, node1);
+    EXPECT_EQ(edges.size(), initialSize);
+
+    EXPECT_FALSE(edges.isEdge(10, 20));
+    edges.addEdge(10, 20);
+    EXPECT_TRUE(edges.isEdge(10, 20));
+    EXPECT_TRUE(edges.isEdge(20, 10));
+    EXPECT_EQ(edges.size(), initialSize + 1);
+
+    // nodes beyond the base get lists, too
+    edges.addEdge(500, 600);
+    EXPECT_TRUE(edges.isEdge(600, 500));
+    EXPECT_TRUE(edges.neighbors(600) == std::vector<int>({500}));
+}
+
+// Test: a finished merge is installed by reading through a non-const method
+TEST_F(DeltaAdjacencyEdgesTest, InstallsFinishedMerge)
+{
+    edges.compact();
+    for (int node = 0; node < 40; node++)
+    {
+        edges.addEdge(1000, 1001 + node);
+    }
+    edges.addEdge(1000, 1000);
+    EXPECT_EQ(edges.size(), graph.getEdgeCount() + 41);
+
+    // the merge started by the adds above is installed once it is done
+    while (edges.isMerging())
+    {
+        EXPECT_TRUE(edges.isEdge(1000, 1040));
+    }
+    EXPECT_LT(edges.getDeltaSize(), 64u);
+    EXPECT_EQ(edges.size(), graph.getEdgeCount() + 41);
+    EXPECT_TRUE(edges.getNeighbors(1000).front() == 1000);
+}
+
+// Test: weights survive merges and stay aligned with neighbors
+TEST_F(DeltaAdjacencyEdgesTest, Weights)
+{
+    edges.addEdge(10, 20);
+    edges.setWeight(20, 10, 0.75);
+    EXPECT_EQ(edges.getWeight(10, 20), 0.75);
+
+    edges.compact();
+    EXPECT_EQ(edges.getWeight(10, 20), 0.75);
+
+    Span<const int> neighbors = edges.neighbors(10);
+    Span<const double> weights = edges.weights(10);
+    ASSERT_EQ(neighbors.size(), weights.size());
+    size_t position = std::find(neighbors.begin(), neighbors.end(), 20) - neighbors.begin();
+    EXPECT_EQ(weights[position], 0.75);
+    EXPECT_TRUE(std::isnan(edges.getWeight(10, 21)));
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+#include "ExternalCsrBuilder.hpp"
+#include "AdjacencyArrayEdges.hpp"
+#include "Graph.hpp"
+
+using namespace std;
+
+const string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const string EDGE_FILE = "../input/cornell/cornell_edges.txt";
+const string CSR_FILE = "external_csr_test.graph";
+
+// Fixture class for ExternalCsrBuilder testing
+class ExternalCsrBuilderTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        remove(CSR_FILE.c_str());
+    }
+
+    static bool fileExists(const string &path)
+    {
+        return ifstream(path).good();
+    }
+};
+
+// Test: a budget far below the edge list spills several runs and still yields the in-memory adjacency array
+TEST_F(ExternalCsrBuilderTest, MatchesInMemoryBuild)
+{
+    ExternalCsrOptions options;
+    options.memoryBudget = 4096;
+    ExternalCsrStats stats = ExternalCsrBuilder(options).build(EDGE_FILE, CSR_FILE);
+    EXPECT_GT(stats.runs, 2u);
+    EXPECT_GT(stats.mergePasses, 0u); // the budget has read buffers for two runs only
+    EXPECT_EQ(stats.edgesRead, 298u);
+
+    Graph graph(NODES_FILE, EDGE_FILE);
+    AdjacencyArrayEdges expected(graph.getEdges());
+    EXPECT_EQ(stats.adjacencyEntries, expected.csrAdjacency().size());
+
+    // Graph takes the CSR file in place of the edge file
+    Graph fromCsr(NODES_FILE, CSR_FILE);
+    EXPECT_EQ(fromCsr.getEdges(), graph.getEdges());
+    EXPECT_EQ(fromCsr.getEdgeCount(), graph.getEdgeCount());
+    EXPECT_EQ(fromCsr.getNodeCount(), graph.getNodeCount());
+
+    // temporary files are gone
+    for (size_t run = 0; run < stats.runs + stats.mergePasses * stats.runs; run++)
+    {
+        EXPECT_FALSE(fileExists(CSR_FILE + ".run" + to_string(run) + ".tmp"));
+    }
+    EXPECT_FALSE(fileExists(CSR_FILE + ".offsets.tmp"));
+
+    // reordering works on prebuilt edges too
+    Graph reordered(NODES_FILE, CSR_FILE, NodeOrder::Degree);
+    EXPECT_EQ(reordered.getEdgeCount(), graph.getEdgeCount());
+}
+
+// Test: duplicates across runs, self-loops and invalid lines are handled like the in-memory build
+TEST_F(ExternalCsrBuilderTest, DuplicatesAndSelfLoops)
+{
+    const string edgesFile = "external_csr_test_edges.txt";
+    {
+        ofstream file(edgesFile);
+        file << "0 1\n1 0\n2 2\n3 1\n-1 2\nbroken\n";
+        for (int i = 0; i < 200; i++)
+        {
+            file << "0 1\n"; // spread over several runs
+        }
+        file << "5 4\n";
+    }
+
+    ExternalCsrOptions options;
+    options.memoryBudget = 1024;
+    ExternalCsrStats keepLoops = ExternalCsrBuilder(options).build(edgesFile, CSR_FILE);
+    EXPECT_GT(keepLoops.runs, 1u);
+    EXPECT_EQ(keepLoops.skippedInvalidEdges, 1u);
+    EXPECT_EQ(keepLoops.malformedLines, 1u);
+    EXPECT_EQ(keepLoops.listCount, 6u);
+    EXPECT_EQ(keepLoops.adjacencyEntries, 7u); // 0-1, 1-3 and 4-5 twice, the self-loop once
+
+    Graph graph(NODES_FILE, CSR_FILE);
+    EXPECT_TRUE(graph.neighbors(0) == vector<int>({1}));
+    EXPECT_TRUE(graph.neighbors(1) == vector<int>({0, 3}));
+    EXPECT_TRUE(graph.neighbors(2) == vector<int>({2}));
+    EXPECT_TRUE(graph.neighbors(5) == vector<int>({4}));
+
+    // reordering keeps the self-loop
+    Graph reordered(NODES_FILE, CSR_FILE, NodeOrder::Degree);
+    EXPECT_EQ(reordered.getEdgeCount(), graph.getEdgeCount());
+    int loopNode = reordered.getInternalId(2);
+    EXPECT_TRUE(reordered.neighbors(loopNode) == vector<int>({loopNode}));
+
+    options.dropSelfLoops = true;
+    ExternalCsrStats dropLoops = ExternalCsrBuilder(options).build(edgesFile, CSR_FILE);
+    EXPECT_EQ(dropLoops.droppedSelfLoops, 1u);
+    EXPECT_EQ(dropLoops.adjacencyEntries, 6u);
+
+    remove(edgesFile.c_str());
+}
+
+// Test: missing input is reported and leaves no output behind
+TEST_F(ExternalCsrBuilderTest, MissingInput)
+{
+    EXPECT_THROW(ExternalCsrBuilder().build("does_not_exist.txt", CSR_FILE), runtime_error);
+    EXPECT_FALSE(fileExists(CSR_FILE));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include "Graph.hpp"
+#include "FeatureKNN.hpp"
+
+using namespace std;
+
+const string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const string EDGE_FILE = "../input/cornell/cornell_edges.txt";
+
+// Fixture class for FeatureKNN testing
+class FeatureKNNTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        graph = make_shared<Graph>(NODES_FILE, EDGE_FILE);
+    }
+
+    // Runs FeatureKNN with the given parameters on a fresh copy of the graph
+    static shared_ptr<Graph> runOnCopy(const map<string, double> &params)
+    {
+        auto copy = make_shared<Graph>(NODES_FILE, EDGE_FILE);
+        FeatureKNN featureKnn(copy);
+        featureKnn.configure(params);
+        featureKnn.run();
+        return copy;
+    }
+
+    // Checks that two graphs hold bit-identical features
+    static void expectSameFeatures(const Graph &expected, const Graph &actual)
+    {
+        for (int node : expected.getNodes())
+        {
+            Span<const double> expectedRow = expected.featureRowById(node);
+            Span<const double> actualRow = actual.featureRowById(node);
+            for (size_t i = 0; i < expectedRow.size(); i++)
+            {
+                EXPECT_TRUE(actualRow[i] == expectedRow[i] || (isnan(actualRow[i]) && isnan(expectedRow[i])));
+            }
+        }
+    }
+
+    shared_ptr<Graph> graph;
+};
+
+// Test: every missing feature is filled with Euclidean and cosine distances
+TEST_F(FeatureKNNTest, FillsMissingValues)
+{
+    for (double cosine : {0.0, 1.0})
+    {
+        shared_ptr<Graph> filled = runOnCopy({{"k", 15}, {"cosine", cosine}});
+        for (int node : filled->getNodes())
+        {
+            for (double feature : filled->featureRowById(node))
+            {
+                EXPECT_FALSE(isnan(feature)) << "node " << node << ", cosine " << cosine;
+            }
+        }
+    }
+}
+
+// Test: a node whose observed features equal those of another node far away is filled from that node
+TEST_F(FeatureKNNTest, FindsNodeWithSameObservedFeatures)
+{
+    // a path 0 - ... - 5 where only node 0 has the observed features of node 5, up to scale for none of the others
+    const string nodesFile = "feature_knn_test_nodes.txt";
+    const string edgesFile = "feature_knn_test_edges.txt";
+    {
+        ofstream nodes(nodesFile);
+        nodes << "0\t1.0, 2.0, 3.0, 4.0\t0\n"
+              << "1\t9.0, 1.0, 7.0, 2.0\t0\n"
+              << "2\t5.0, 5.0, 5.0, 5.0\t0\n"
+              << "3\t2.0, 8.0, 1.0, 6.0\t0\n"
+              << "4\t7.0, 3.0, 9.0, 1.0\t0\n"
+              << "5\t1.0, #, 3.0, #\t0\n";
+        ofstream edges(edgesFile);
+        edges << "0 1\n1 2\n2 3\n3 4\n4 5\n";
+    }
+
+    for (double cosine : {0.0, 1.0})
+    {
+        auto small = make_shared<Graph>(nodesFile, edgesFile);
+        FeatureKNN featureKnn(small);
+        featureKnn.configure({{"k", 1}, {"cosine", cosine}});
+        featureKnn.run();
+        EXPECT_EQ(small->getFeatureById(5), vector<double>({1.0, 2.0, 3.0, 4.0})) << "cosine " << cosine;
+    }
+    remove(nodesFile.c_str());
+    remove(edgesFile.c_str());
+}
+
+// Test: the result is the same for any thread count, and probing all partitions is exact
+TEST_F(FeatureKNNTest, Deterministic)
+{
+    shared_ptr<Graph> expected = runOnCopy({{"k", 5}, {"threads", 1}});
+    expectSameFeatures(*expected, *runOnCopy({{"k", 5}, {"threads", 4}}));
+    expectSameFeatures(*expected, *runOnCopy({{"k", 5}, {"partitions", 6}, {"probes", 6}, {"threads", 3}}));
+
+    // probing fewer partitions still fills the nodes
+    shared_ptr<Graph> approximate = runOnCopy({{"k", 5}, {"partitions", 6}, {"probes", 2}});
+    EXPECT_FALSE(isnan(approximate->featureRowById(1)[0]));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
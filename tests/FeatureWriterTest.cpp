@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "FeatureWriter.hpp"
+#include "Graph.hpp"
+
+using namespace std;
+
+const string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const string EDGE_FILE = "../input/cornell/cornell_edges.txt";
+const string OUTPUT_FILE = "feature_writer_test.txt";
+
+// Fixture class for FeatureWriter testing
+class FeatureWriterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        graph = make_unique<Graph>(NODES_FILE, EDGE_FILE);
+    }
+
+    void TearDown() override
+    {
+        remove(OUTPUT_FILE.c_str());
+    }
+
+    // the lines as ostream writes them
+    static string streamFormat(const Graph &graph)
+    {
+        ostringstream out;
+        for (int nodeId : graph.getNodes())
+        {
+            out << graph.getOriginalId(nodeId) << "\t";
+            vector<double> features = graph.getFeatureById(nodeId);
+            for (size_t i = 0; i < features.size(); ++i)
+            {
+                if (isnan(features[i]))
+                {
+                    out << "0.0";
+                }
+                else
+                {
+                    out << features[i];
+                }
+                if (i != features.size() - 1)
+                {
+                    out << ", ";
+                }
+            }
+            out << "\t" << graph.getLabelById(nodeId) << endl;
+        }
+        return out.str();
+    }
+
+    static string readFile(const string &fileName)
+    {
+        ifstream file(fileName, ios::binary);
+        return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+
+    unique_ptr<Graph> graph;
+};
+
+// Test: the output is byte for byte what ostream writes, independent of threads and chunk size
+TEST_F(FeatureWriterTest, MatchesStreamOutput)
+{
+    // values that need every notation of the default format
+    vector<double> features = graph->getFeatureById(1);
+    features[0] = 1.0 / 3.0;
+    features[1] = -1234567.0;
+    features[2] = 1e-7;
+    features[3] = 100.0;
+    features[4] = numeric_limits<double>::quiet_NaN();
+    features[5] = -0.0;
+    graph->updateFeatureById(1, features);
+
+    string expected = streamFormat(*graph);
+    for (unsigned threads : {1u, 3u})
+    {
+        for (size_t chunkRows : {1u, 7u, 4096u})
+        {
+            FeatureWriterOptions options;
+            options.threads = threads;
+            options.chunkRows = chunkRows;
+            ASSERT_TRUE(FeatureWriter(options).write(*graph, OUTPUT_FILE));
+            EXPECT_EQ(readFile(OUTPUT_FILE), expected) << threads << " threads, " << chunkRows << " rows per chunk";
+        }
+    }
+}
+
+// Test: fixed precision writes the given number of digits after the point
+TEST_F(FeatureWriterTest, FixedPrecision)
+{
+    vector<double> features(graph->getFeatureCount(), 0.5);
+    features[0] = 1.0 / 3.0;
+    features[1] = numeric_limits<double>::quiet_NaN();
+    graph->updateFeatureById(graph->getIdBySlot(0), features);
+
+    FeatureWriterOptions options;
+    options.fixedPrecision = 3;
+    string line;
+    FeatureWriter(options).formatRows(*graph, 0, 1, line);
+    EXPECT_EQ(line.substr(0, line.find(", 0.500", line.find("0.0"))), to_string(graph->getIdBySlot(0)) + "\t0.333, 0.0");
+
+    options.fixedPrecision = 101;
+    EXPECT_THROW(FeatureWriter{options}, invalid_argument);
+    EXPECT_FALSE(FeatureWriter().write(*graph, "missing_directory/features.txt"));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+
+#include "GraphParser.hpp"
+
+using namespace std;
+
+Span<const char> textOf(const string &text)
+{
+    return Span<const char>(text.data(), text.size());
+}
+
+// Test: edge lines are split on any whitespace, trailing columns are ignored
+TEST(GraphParserTest, ParseEdges)
+{
+    string text = "1 2\n3\t4\r\n\n  5 6 0.5\n";
+    ParsedEdges parsed = GraphParser(1).parseEdges(textOf(text));
+
+    vector<pair<int, int>> expected = {{1, 2}, {3, 4}, {5, 6}};
+    EXPECT_EQ(parsed.edges, expected);
+    EXPECT_TRUE(parsed.errors.empty());
+}
+
+// Test: malformed edge lines are skipped and reported with their line number
+TEST(GraphParserTest, EdgeErrors)
+{
+    string text = "1 2\n1,2\nabc\n3\n4 5";
+    ParsedEdges parsed = GraphParser(1).parseEdges(textOf(text));
+
+    vector<pair<int, int>> expected = {{1, 2}, {4, 5}};
+    EXPECT_EQ(parsed.edges, expected);
+    ASSERT_EQ(parsed.errors.size(), 3u);
+    EXPECT_EQ(parsed.errors[0].line, 2u);
+    EXPECT_EQ(parsed.errors[1].line, 3u);
+    EXPECT_EQ(parsed.errors[2].line, 4u);
+}
+
+// Test: IDs beyond the int range are reported instead of wrapped around
+TEST(GraphParserTest, EdgeIdOutOfRange)
+{
+    string text = "3000000000 1\n1 2\n2 -3000000000\n";
+    ParsedEdges parsed = GraphParser(1).parseEdges(textOf(text));
+
+    vector<pair<int, int>> expected = {{1, 2}};
+    EXPECT_EQ(parsed.edges, expected);
+    EXPECT_EQ(parsed.errors.size(), 2u);
+}
+
+// Test: features, missing markers and labels follow the conventions of the node files
+TEST(GraphParserTest, ParseNodes)
+{
+    string text = "0\t#, 0.5, '#', 1e-3\t2\n"
+                  "7\t1, 2, 3, 4\r\n"
+                  "\n"
+                  "3\t-0.25,#,+5,0\t1\n";
+    ParsedNodes parsed = GraphParser(1).parseNodes(textOf(text));
+
+    EXPECT_TRUE(parsed.errors.empty());
+    ASSERT_EQ(parsed.featureCount, 4u);
+    EXPECT_EQ(parsed.nodeIds, vector<int>({0, 7, 3}));
+    EXPECT_EQ(parsed.labels, vector<int>({2, 0, 1}));
+    ASSERT_EQ(parsed.featureMatrix.size(), 12u);
+
+    EXPECT_TRUE(isnan(parsed.featureMatrix[0]));
+    EXPECT_DOUBLE_EQ(parsed.featureMatrix[1], 0.5);
+    EXPECT_TRUE(isnan(parsed.featureMatrix[2]));
+    EXPECT_DOUBLE_EQ(parsed.featureMatrix[3], 0.001);
+    EXPECT_DOUBLE_EQ(parsed.featureMatrix[7], 4.0);
+    EXPECT_DOUBLE_EQ(parsed.featureMatrix[8], -0.25);
+    EXPECT_TRUE(isnan(parsed.featureMatrix[9]));
+    EXPECT_DOUBLE_EQ(parsed.featureMatrix[10], 5.0);
+}
+
+// Test: broken lines are skipped, ragged rows are padded, both are reported
+TEST(GraphParserTest, NodeErrors)
+{
+    string text = "0\t1, 2, 3\t0\n"
+                  "1\t1, x, 3\t0\n"
+                  "2\t1, 2\t1\n"
+                  "node\t1, 2, 3\t0\n"
+                  "4\t1, 2, 3, 4\tlabel\n"
+                  "5\t1, 2, 3, 4\t1\n";
+    ParsedNodes parsed = GraphParser(1).parseNodes(textOf(text));
+
+    EXPECT_EQ(parsed.nodeIds, vector<int>({0, 2, 5}));
+    ASSERT_EQ(parsed.featureMatrix.size(), 9u);
+    EXPECT_TRUE(isnan(parsed.featureMatrix[5]));  // padded row of node 2
+    EXPECT_DOUBLE_EQ(parsed.featureMatrix[8], 3); // cut row of node 5
+
+    ASSERT_EQ(parsed.errors.size(), 5u);
+    vector<size_t> lines;
+    for (const ParseError &error : parsed.errors)
+    {
+        lines.push_back(error.line);
+    }
+    EXPECT_EQ(lines, vector<size_t>({2, 3, 4, 5, 6}));
+}
+
+// Test: parsing in several chunks gives the same result and line numbers as a single chunk
+TEST(GraphParserTest, ChunksMatchSequential)
+{
+    string nodes, edges;
+    for (int node = 0; node < 40000; node++)
+    {
+        nodes += to_string(node) + "\t" + to_string(node % 7) + ".5, #, " + to_string(node) + "\t" + to_string(node % 3) + "\n";
+        edges += to_string(node) + " " + to_string((node * 31) % 40000) + "\n";
+        if (node % 9999 == 0)
+        {
+            nodes += "broken line\n";
+            edges += "broken line\n";
+        }
+    }
+
+    ParsedNodes sequentialNodes = GraphParser(1).parseNodes(textOf(nodes));
+    ParsedNodes parallelNodes = GraphParser(4).parseNodes(textOf(nodes));
+    EXPECT_EQ(parallelNodes.nodeIds, sequentialNodes.nodeIds);
+    EXPECT_EQ(parallelNodes.labels, sequentialNodes.labels);
+    ASSERT_EQ(parallelNodes.featureMatrix.size(), sequentialNodes.featureMatrix.size());
+    for (size_t i = 0; i < sequentialNodes.featureMatrix.size(); i++)
+    {
+        double expected = sequentialNodes.featureMatrix[i];
+        EXPECT_TRUE(parallelNodes.featureMatrix[i] == expected || (isnan(expected) && isnan(parallelNodes.featureMatrix[i])));
+    }
+
+    ParsedEdges sequentialEdges = GraphParser(1).parseEdges(textOf(edges));
+    ParsedEdges parallelEdges = GraphParser(4).parseEdges(textOf(edges));
+    EXPECT_EQ(parallelEdges.edges, sequentialEdges.edges);
+    EXPECT_EQ(sequentialEdges.edges.size(), 40000u);
+
+    ASSERT_EQ(parallelNodes.errors.size(), 5u);
+    ASSERT_EQ(parallelEdges.errors.size(), 5u);
+    for (size_t i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(parallelNodes.errors[i].line, sequentialNodes.errors[i].line);
+        EXPECT_EQ(parallelEdges.errors[i].line, sequentialEdges.errors[i].line);
+    }
+    EXPECT_EQ(sequentialEdges.errors[1].line, 10002u); // after node 9999 and the broken line behind node 0
+}
@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Checksum.hpp"
+#include "DeltaAdjacencyEdges.hpp"
+#include "Graph.hpp"
+#include "GraphSnapshot.hpp"
+
+using namespace std;
+
+const string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const string EDGE_FILE = "../input/cornell/cornell_edges.txt";
+const string SNAPSHOT_FILE = "GraphSnapshotTest.graph";
+
+// Fixture writing a snapshot of the cornell graph, removed after each test
+class GraphSnapshotTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        remove(SNAPSHOT_FILE.c_str());
+    }
+
+    // Checks that two graphs hold the same nodes, features, labels and edges
+    void expectSameGraph(const Graph &expected, const Graph &actual)
+    {
+        EXPECT_EQ(actual.getNodes(), expected.getNodes());
+        EXPECT_EQ(actual.getEdges(), expected.getEdges());
+        ASSERT_EQ(actual.getFeatureCount(), expected.getFeatureCount());
+
+        for (int nodeId : expected.getNodes())
+        {
+            EXPECT_EQ(actual.getLabelById(nodeId), expected.getLabelById(nodeId));
+            EXPECT_EQ(actual.getOriginalId(nodeId), expected.getOriginalId(nodeId));
+
+            Span<const double> expectedRow = expected.featureRowById(nodeId);
+            Span<const double> actualRow = actual.featureRowById(nodeId);
+            for (size_t i = 0; i < expectedRow.size(); i++)
+            {
+                EXPECT_TRUE(actualRow[i] == expectedRow[i] || (isnan(actualRow[i]) && isnan(expectedRow[i])));
+            }
+        }
+    }
+};
+
+// Test: the checksum matches the standard CRC-32 check value, also when computed in pieces
+TEST_F(GraphSnapshotTest, Checksum)
+{
+    string text = "123456789";
+    EXPECT_EQ(crc32(text.data(), text.size()), 0xCBF43926u);
+    EXPECT_EQ(crc32(text.data() + 4, 5, crc32(text.data(), 4)), 0xCBF43926u);
+    EXPECT_EQ(crc32(nullptr, 0), 0u);
+}
+
+// Test: a saved graph loads back with the same data, including edge weights
+TEST_F(GraphSnapshotTest, RoundTrip)
+{
+    Graph graph(NODES_FILE, EDGE_FILE);
+    graph.setEdgeWeight(57, 96, 0.25);
+    graph.save(SNAPSHOT_FILE);
+
+    EXPECT_TRUE(SnapshotReader::isSnapshot(SNAPSHOT_FILE));
+    EXPECT_FALSE(SnapshotReader::isSnapshot(NODES_FILE));
+
+    Graph loaded(SNAPSHOT_FILE);
+    expectSameGraph(graph, loaded);
+    EXPECT_DOUBLE_EQ(loaded.getEdgeWeight(96, 57), 0.25);
+    EXPECT_TRUE(isnan(loaded.getEdgeWeight(1, 2)));
+}
+
+// Test: the permutation of a reordered graph is restored
+TEST_F(GraphSnapshotTest, ReorderedRoundTrip)
+{
+    Graph graph(NODES_FILE, EDGE_FILE, NodeOrder::RCM);
+    graph.save(SNAPSHOT_FILE);
+
+    Graph loaded(SNAPSHOT_FILE);
+    EXPECT_EQ(loaded.getNodeOrder(), NodeOrder::RCM);
+    expectSameGraph(graph, loaded);
+    EXPECT_EQ(loaded.getInternalId(57), graph.getInternalId(57));
+}
+
+// Test: reordering a snapshot used as edge file keeps its weights
+TEST_F(GraphSnapshotTest, ReorderedSnapshotEdges)
+{
+    Graph graph(NODES_FILE, EDGE_FILE);
+    graph.setEdgeWeight(57, 96, 0.5);
+    graph.save(SNAPSHOT_FILE);
+
+    Graph reordered(NODES_FILE, SNAPSHOT_FILE, NodeOrder::Degree);
+    EXPECT_EQ(reordered.getEdgeCount(), graph.getEdgeCount());
+    EXPECT_DOUBLE_EQ(reordered.getEdgeWeight(reordered.getInternalId(96), reordered.getInternalId(57)), 0.5);
+}
+
+// Test: damaged or foreign files are rejected
+TEST_F(GraphSnapshotTest, CorruptSnapshot)
+{
+    EXPECT_THROW(Graph{"does_not_exist.graph"}, runtime_error);
+    EXPECT_THROW(Graph{NODES_FILE}, runtime_error);
+
+    Graph graph(NODES_FILE, EDGE_FILE);
+    graph.save(SNAPSHOT_FILE);
+
+    // flip a byte in the first section
+    fstream file(SNAPSHOT_FILE, ios::in | ios::out | ios::binary);
+    file.seekg(SNAPSHOT_PAGE_SIZE);
+    char byte = 0;
+    file.read(&byte, 1);
+    byte ^= 0x5A;
+    file.seekp(SNAPSHOT_PAGE_SIZE);
+    file.write(&byte, 1);
+    file.close();
+
+    EXPECT_THROW(Graph{SNAPSHOT_FILE}, runtime_error);
+}
+
+// Test: snapshots of version 2 with int32 offsets still load, read and mapped
+TEST_F(GraphSnapshotTest, NarrowOffsets)
+{
+    Graph graph(NODES_FILE, EDGE_FILE);
+    AdjacencyArrayEdges csr(graph.getEdges());
+    vector<int> narrowOffsets(csr.csrOffsets().begin(), csr.csrOffsets().end());
+    vector<int> nodeIds = graph.getNodes();
+    vector<int> labels;
+    for (int nodeId : nodeIds)
+    {
+        labels.push_back(graph.getLabelById(nodeId));
+    }
+    Span<const double> features(graph.featureRow(0).data(), nodeIds.size() * graph.getFeatureCount());
+    vector<uint64_t> missingMask((features.size() + 63) / 64, 0);
+    for (size_t i = 0; i < features.size(); i++)
+    {
+        if (isnan(features[i]))
+        {
+            missingMask[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+
+    {
+        SnapshotWriter writer(SNAPSHOT_FILE, nodeIds.size(), graph.getFeatureCount(), 0);
+        writer.writeSection(SnapshotSection::NodeIds, nodeIds.data(), nodeIds.size() * sizeof(int));
+        writer.writeSection(SnapshotSection::Labels, labels.data(), labels.size() * sizeof(int));
+        writer.writeSection(SnapshotSection::Features, features.data(), features.size() * sizeof(double));
+        writer.writeSection(SnapshotSection::MissingMask, missingMask.data(), missingMask.size() * sizeof(uint64_t));
+        writer.writeSection(SnapshotSection::Offsets, narrowOffsets.data(), narrowOffsets.size() * sizeof(int));
+        writer.writeSection(SnapshotSection::Adjacency, csr.csrAdjacency().data(), csr.csrAdjacency().size() * sizeof(int));
+        writer.finish();
+    }
+    uint32_t version = 2;
+    fstream file(SNAPSHOT_FILE, ios::in | ios::out | ios::binary);
+    file.seekp(offsetof(SnapshotHeader, version));
+    file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    file.close();
+
+    Graph loaded(SNAPSHOT_FILE);
+    expectSameGraph(graph, loaded);
+    Graph mapped(SNAPSHOT_FILE, SnapshotAccess::Map);
+    expectSameGraph(graph, mapped);
+    EXPECT_TRUE(mapped.neighbors(57) == graph.getNeighbors(57));
+}
+
+// Test: a memory-mapped snapshot serves the same data, writes stay private to the graph
+TEST_F(GraphSnapshotTest, MemoryMapped)
+{
+    Graph graph(NODES_FILE, EDGE_FILE);
+    graph.save(SNAPSHOT_FILE);
+
+    Graph mapped(SNAPSHOT_FILE, SnapshotAccess::Map);
+    EXPECT_TRUE(mapped.isMemoryMapped());
+    EXPECT_FALSE(graph.isMemoryMapped());
+    expectSameGraph(graph, mapped);
+    EXPECT_EQ(mapped.getEdgeCount(), graph.getEdgeCount());
+    EXPECT_TRUE(mapped.neighbors(57) == graph.getNeighbors(57));
+    EXPECT_TRUE(mapped.isEdge(96, 57));
+
+    // feature and weight updates go to private pages of this graph only
+    vector<double> newFeatures(graph.getFeatureCount(), 1.5);
+    mapped.updateFeatureById(1, newFeatures);
+    mapped.setEdgeWeight(57, 96, 2.0);
+    EXPECT_EQ(mapped.getFeatureById(1), newFeatures);
+    EXPECT_DOUBLE_EQ(mapped.getEdgeWeight(96, 57), 2.0);
+
+    Graph other(SNAPSHOT_FILE, SnapshotAccess::Map);
+    expectSameGraph(graph, other);
+    EXPECT_TRUE(isnan(other.getEdgeWeight(57, 96)));
+
+    // saving a mapped graph writes its current state
+    mapped.save("GraphSnapshotTest.copy.graph");
+    Graph copy("GraphSnapshotTest.copy.graph");
+    remove("GraphSnapshotTest.copy.graph");
+    expectSameGraph(mapped, copy);
+    EXPECT_DOUBLE_EQ(copy.getEdgeWeight(57, 96), 2.0);
+
+    // self-loops are listed like in the loaded graph
+    const string nodesFile = "graph_snapshot_test_loop_nodes.txt";
+    const string edgesFile = "graph_snapshot_test_loop_edges.txt";
+    {
+        ofstream nodes(nodesFile);
+        nodes << "5\t0.5\t1\n9\t1.5\t2\n";
+        ofstream edges(edgesFile);
+        edges << "5 5\n9 9\n5 9\n";
+    }
+    Graph loops(nodesFile, edgesFile);
+    remove(nodesFile.c_str());
+    remove(edgesFile.c_str());
+    loops.save(SNAPSHOT_FILE);
+
+    Graph mappedLoops(SNAPSHOT_FILE, SnapshotAccess::Map);
+    expectSameGraph(loops, mappedLoops);
+    EXPECT_EQ(mappedLoops.getEdges().size(), 1u);
+    EXPECT_EQ(mappedLoops.getEdgeCount(), 3u);
+    EXPECT_EQ(loops.getEdgeCount(), 3u);
+    EXPECT_TRUE(mappedLoops.neighbors(0) == loops.getNeighbors(0));
+}
+
+// Test: weights stored in the snapshot are mapped copy-on-write as well
+TEST_F(GraphSnapshotTest, MemoryMappedWeights)
+{
+    Graph graph(NODES_FILE, EDGE_FILE);
+    graph.setEdgeWeight(1, 2, 0.5);
+    graph.save(SNAPSHOT_FILE);
+
+    Graph mapped(SNAPSHOT_FILE, SnapshotAccess::Map);
+    EXPECT_DOUBLE_EQ(mapped.getEdgeWeight(2, 1), 0.5);
+    mapped.setEdgeWeight(1, 2, 0.75);
+    EXPECT_DOUBLE_EQ(mapped.getEdgeWeight(2, 1), 0.75);
+
+    Graph reloaded(SNAPSHOT_FILE);
+    EXPECT_DOUBLE_EQ(reloaded.getEdgeWeight(2, 1), 0.5);
+}
+
+// Tests that a graph on another edge backend keeps its self-loops and weights in the snapshot
+TEST_F(GraphSnapshotTest, DeltaEdgesSelfLoop)
+{
+    Graph graph(NODES_FILE, EDGE_FILE);
+    auto delta = make_unique<DeltaAdjacencyEdges>(graph.getEdges());
+    delta->addEdge(5, 5);
+    delta->addEdge(3, 7);
+    delta->setWeight(5, 5, 0.25);
+    graph.setEdges(move(delta));
+    graph.save(SNAPSHOT_FILE);
+
+    Graph loaded(SNAPSHOT_FILE);
+    expectSameGraph(graph, loaded);
+    EXPECT_EQ(loaded.neighbors(5).toVector(), graph.neighbors(5).toVector());
+    EXPECT_TRUE(loaded.isEdge(5, 5));
+    EXPECT_TRUE(loaded.isEdge(3, 7));
+    EXPECT_DOUBLE_EQ(loaded.getEdgeWeight(5, 5), 0.25);
+    EXPECT_EQ(loaded.getEdgeCount(), graph.getEdgeCount());
+}
+
+// Test: CsrGraph copies a snapshot into its adjacency array, mapped edges are only served by Graph
+TEST_F(GraphSnapshotTest, CsrGraph)
+{
+    Graph graph(NODES_FILE, EDGE_FILE);
+    graph.save(SNAPSHOT_FILE);
+
+    CsrGraph loaded(SNAPSHOT_FILE);
+    EXPECT_EQ(loaded.getEdges(), graph.getEdges());
+    EXPECT_THROW(CsrGraph(SNAPSHOT_FILE, SnapshotAccess::Map), logic_error);
+
+    // visitEdges passes the mapped backend as IEdges
+    Graph mapped(SNAPSHOT_FILE, SnapshotAccess::Map);
+    bool isInterface = false;
+    mapped.visitEdges([&](const auto &edges)
+    {
+        isInterface = is_same_v<decay_t<decltype(edges)>, IEdges>;
+        EXPECT_TRUE(edges.neighbors(57) == graph.getNeighbors(57));
+    });
+    EXPECT_TRUE(isInterface);
+}
@@ -2,6 +2,8 @@
 #include <fstream>
 #include <cstdio>
 #include <numeric>
+#include <cmath>
+#include <cstdint>
 
 #include "Graph.hpp"
 #include "Node.hpp"
@@ -70,6 +72,165 @@ TEST_F(GraphTest, NodeEdgeCount)
     EXPECT_EQ(graph->getEdgeCount(), 298); // undirected graph
 }
 
+// Test: batched edge lookups agree with isEdge
+TEST_F(GraphTest, AreEdges)
+{
+    auto [node1, node2] = graph->getEdges()[0];
+    EXPECT_TRUE(graph->isEdge(node1, node2));
+    EXPECT_TRUE(graph->isEdge(node2, node1));
+
+    std::vector<std::pair<int, int>> queries = {{node2, node1}, {node1, node1}, {node1, node2}, {-1, node1}};
+    std::vector<bool> expected = {true, graph->isEdge(node1, node1), true, false};
+    EXPECT_EQ(graph->areEdges(queries), expected);
+}
+
+// Test: reordered graphs hold the same nodes, edges and features under translated IDs
+TEST_F(GraphTest, NodeOrder)
+{
+    for (NodeOrder order : {NodeOrder::Degree, NodeOrder::RCM, NodeOrder::BFS})
+    {
+        Graph reordered(NODES_FILE, EDGE_FILE, order);
+        EXPECT_EQ(reordered.getNodeOrder(), order);
+        ASSERT_EQ(reordered.getNodeCount(), graph->getNodeCount());
+        EXPECT_EQ(reordered.getEdgeCount(), graph->getEdgeCount());
+
+        // internal IDs are dense and slots follow them
+        vector<int> internalIds = reordered.getNodes();
+        EXPECT_TRUE(is_sorted(internalIds.begin(), internalIds.end()));
+
+        for (int originalId : graph->getNodes())
+        {
+            int internalId = reordered.getInternalId(originalId);
+            ASSERT_GE(internalId, 0);
+            EXPECT_EQ(reordered.getOriginalId(internalId), originalId);
+            EXPECT_EQ(reordered.getLabelById(internalId), graph->getLabelById(originalId));
+
+            vector<double> expected = graph->getFeatureById(originalId);
+            vector<double> actual = reordered.getFeatureById(internalId);
+            ASSERT_EQ(actual.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); i++)
+            {
+                EXPECT_TRUE(actual[i] == expected[i] || (isnan(actual[i]) && isnan(expected[i])));
+            }
+        }
+
+        for (auto [source, destination] : graph->getEdges())
+        {
+            EXPECT_TRUE(reordered.isEdge(reordered.getInternalId(source), reordered.getInternalId(destination)));
+        }
+    }
+
+    EXPECT_EQ(graph->getOriginalId(57), 57);
+    EXPECT_EQ(graph->getInternalId(57), 57);
+    EXPECT_EQ(parseNodeOrder("RCM"), NodeOrder::RCM);
+    EXPECT_THROW(parseNodeOrder("random"), invalid_argument);
+}
+
+// Test: Degree order puts the node of highest degree first
+TEST_F(GraphTest, DegreeOrder)
+{
+    Graph reordered(NODES_FILE, EDGE_FILE, NodeOrder::Degree);
+    size_t previousDegree = reordered.neighbors(0).size();
+    for (int nodeId = 1; nodeId < reordered.getNodeCount(); nodeId++)
+    {
+        EXPECT_LE(reordered.neighbors(nodeId).size(), previousDegree);
+        previousDegree = reordered.neighbors(nodeId).size();
+    }
+}
+
+// Test: huge IDs are numbered densely, the IDs of the files still find the nodes
+TEST_F(GraphTest, SparseIds)
+{
+    const string nodesFile = "graph_test_sparse_nodes.txt";
+    const string edgesFile = "graph_test_sparse_edges.txt";
+    const string snapshotFile = "graph_test_sparse.graph";
+    {
+        ofstream nodes(nodesFile);
+        nodes << "7\t0.5, #\t1\n1500000000\t1.5, 2.5\t2\n42\t#, 3.5\t3\n";
+        ofstream edges(edgesFile);
+        edges << "1500000000 7\n7 42\n42 2000000000\n";
+    }
+
+    Graph sparse(nodesFile, edgesFile);
+    EXPECT_EQ(sparse.getNodeOrder(), NodeOrder::Input);
+    EXPECT_EQ(sparse.getNodes(), vector<int>({0, 1, 2}));
+    EXPECT_EQ(sparse.getEdgeCount(), 3);
+    EXPECT_GT(sparse.getLoadTimings().reorderSeconds, 0.0);
+
+    // node file order first, then the nodes only found in the edge file
+    EXPECT_EQ(sparse.getOriginalId(1), 1500000000);
+    EXPECT_EQ(sparse.getInternalId(2000000000), 3);
+    EXPECT_EQ(sparse.getInternalId(8), -1);
+
+    EXPECT_TRUE(sparse.isEdge(ExternalId(7), ExternalId(1500000000)));
+    EXPECT_FALSE(sparse.isEdge(ExternalId(7), ExternalId(2000000000)));
+    EXPECT_TRUE(sparse.neighbors(ExternalId(42)) == vector<int>({0, 3}));
+    EXPECT_EQ(sparse.getLabelById(ExternalId(42)), 3);
+    EXPECT_EQ(sparse.getFeatureById(ExternalId(1500000000)), vector<double>({1.5, 2.5}));
+    EXPECT_EQ(sparse.getSlotById(ExternalId(2000000000)), -1);
+
+    sparse.updateFeatureById(ExternalId(7), {4.5, 5.5});
+    EXPECT_EQ(sparse.getFeatureById(0), vector<double>({4.5, 5.5}));
+    sparse.setEdgeWeight(ExternalId(42), ExternalId(7), 0.25);
+    EXPECT_EQ(sparse.getEdgeWeight(0, 2), 0.25);
+
+    // the external IDs survive snapshots and reordering
+    sparse.save(snapshotFile);
+    Graph loaded(snapshotFile);
+    EXPECT_EQ(loaded.getOriginalId(3), 2000000000);
+    EXPECT_TRUE(loaded.isEdge(ExternalId(42), ExternalId(2000000000)));
+
+    Graph reordered(nodesFile, edgesFile, NodeOrder::Degree);
+    EXPECT_EQ(reordered.getOriginalId(0), 7); // 7 and 42 have the highest degree
+    EXPECT_TRUE(reordered.isEdge(ExternalId(42), ExternalId(2000000000)));
+    EXPECT_EQ(reordered.getLabelById(ExternalId(1500000000)), 2);
+
+    // IDs of the files are kept if they are dense
+    EXPECT_EQ(graph->featureRowById(ExternalId(57)).data(), graph->featureRowById(57).data());
+
+    remove(nodesFile.c_str());
+    remove(edgesFile.c_str());
+    remove(snapshotFile.c_str());
+}
+
+// Test: CsrGraph holds the same edges as Graph, and visitEdges passes the adjacency array as such
+TEST_F(GraphTest, CsrGraph)
+{
+    CsrGraph csrGraph(NODES_FILE, EDGE_FILE);
+    EXPECT_EQ(csrGraph.getEdgeCount(), graph->getEdgeCount());
+    EXPECT_EQ(csrGraph.getEdges(), graph->getEdges());
+    EXPECT_TRUE(csrGraph.neighbors(57) == graph->getNeighbors(57));
+    EXPECT_TRUE(csrGraph.isEdge(96, 57));
+
+    bool isAdjacencyArray = false;
+    size_t neighborCount = 0;
+    graph->visitEdges([&](const auto &edges)
+    {
+        isAdjacencyArray = is_same_v<decay_t<decltype(edges)>, AdjacencyArrayEdges>;
+        neighborCount = edges.neighbors(57).size();
+    });
+    EXPECT_TRUE(isAdjacencyArray);
+    EXPECT_EQ(neighborCount, graph->neighbors(57).size());
+}
+
+// Test: the phases of loading are timed, edges and nodes are loaded concurrently
+TEST_F(GraphTest, LoadTimings)
+{
+    const LoadTimings &timings = graph->getLoadTimings();
+    EXPECT_GT(timings.edgeParseSeconds, 0.0);
+    EXPECT_GT(timings.csrBuildSeconds, 0.0);
+    EXPECT_GT(timings.nodeParseSeconds, 0.0);
+    EXPECT_EQ(timings.reorderSeconds, 0.0);
+    EXPECT_GE(timings.totalSeconds, max(timings.edgeSeconds(), timings.nodeSeconds()));
+
+    Graph reordered(NODES_FILE, EDGE_FILE, NodeOrder::RCM);
+    EXPECT_GT(reordered.getLoadTimings().reorderSeconds, 0.0);
+
+    // a missing file leaves an empty graph, as before
+    Graph missingEdges(NODES_FILE, "missing_edges.txt");
+    EXPECT_EQ(missingEdges.getNodeCount(), 0);
+}
+
 // Test Getting Features by Node ID
 TEST_F(GraphTest, GetFeatureById)
 {
@@ -96,6 +257,48 @@ TEST_F(GraphTest, UpdateFeatureById)
     EXPECT_EQ(graph->getFeatureById(testNodeId), newFeatures);
 }
 
+// Test O(1) slot lookup by Node ID
+TEST_F(GraphTest, GetSlotById)
+{
+    vector<int> nodeIds = graph->getNodes();
+    for (size_t slot = 0; slot < nodeIds.size(); slot++)
+    {
+        EXPECT_EQ(graph->getSlotById(nodeIds[slot]), static_cast<long>(slot));
+    }
+
+    // unknown IDs have no slot and fall back to the default values
+    EXPECT_EQ(graph->getSlotById(-1), -1);
+    EXPECT_EQ(graph->getSlotById(999999), -1);
+    EXPECT_TRUE(graph->getFeatureById(999999).empty());
+    EXPECT_EQ(graph->getLabelById(999999), 0);
+}
+
+// Test viewing features in the feature matrix without copies
+TEST_F(GraphTest, FeatureRow)
+{
+    int testNodeId = 1;
+    long slot = graph->getSlotById(testNodeId);
+    ASSERT_GE(slot, 0);
+
+    Span<double> row = graph->featureRow(slot);
+    EXPECT_EQ(row.size(), graph->getFeatureCount());
+    EXPECT_EQ(graph->featureRowById(testNodeId).data(), row.data()); // both view the same storage
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(graph->featureRow(0).data()) % 64, 0); // matrix is cache line aligned
+
+    // rows compare equal to the copying API, including missing values
+    vector<double> copied = graph->getFeatureById(testNodeId);
+    ASSERT_EQ(copied.size(), row.size());
+    for (size_t i = 0; i < row.size(); i++)
+    {
+        EXPECT_TRUE(row[i] == copied[i] || (isnan(row[i]) && isnan(copied[i])));
+    }
+
+    // writing through the row updates the graph
+    row[0] = 42.0;
+    EXPECT_EQ(graph->getFeatureById(testNodeId)[0], 42.0);
+    EXPECT_TRUE(graph->featureRowById(999999).empty());
+}
+
 // Test Updating Features for Invalid Node ID
 TEST_F(GraphTest, UpdateFeatureInvalidId)
 {
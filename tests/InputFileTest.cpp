@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+#include "InputFile.hpp"
+#include "Checksum.hpp"
+#include "Graph.hpp"
+#include "Inflate.hpp"
+
+using namespace std;
+
+const string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const string ZIP_FILE = "input_file_test.zip";
+const string GZIP_FILE = "input_file_test_edges.txt.gz";
+const string EDGES_FILE = "input_file_test_edges.txt";
+
+// "0 0\n1 7\n...9 13\n" compressed by zlib with a dynamic Huffman block
+const vector<unsigned char> DYNAMIC_STREAM = {
+    0x05, 0xc1, 0x47, 0x01, 0x00, 0x20, 0x10, 0xc0, 0xb0, 0x7f, 0x55, 0x54, 0x02, 0xb7, 0x18, 0xfe, 0x8d, 0x91, 0x2c, 0x17,
+    0xe1, 0x21, 0x8d, 0xa6, 0xcc, 0xa0, 0xcd, 0xcb, 0x58, 0xc3, 0xb6, 0x93, 0x63, 0x3f, 0xae, 0x9b, 0x67, 0x14, 0x1f};
+
+// "abcabcabcabc hello hello\n" compressed by zlib with fixed Huffman codes
+const vector<unsigned char> FIXED_STREAM = {0x4b, 0x4c, 0x4a, 0x4e, 0x84, 0x21, 0x85, 0x8c, 0xd4, 0x9c, 0x9c, 0x7c, 0x08, 0xc9, 0x05, 0x00};
+
+// Fixture class for InputFile testing
+class InputFileTest : public ::testing::Test
+{
+protected:
+    struct ZipEntry
+    {
+        string name;
+        uint16_t method;
+        string data;     ///< as stored in the archive
+        string contents; ///< after decompression
+    };
+
+    void SetUp() override
+    {
+        for (int i = 0; i < 10; i++)
+        {
+            edgesText += to_string(i) + " " + to_string(i * 7 % 50) + "\n";
+        }
+        ifstream nodes(NODES_FILE, ios::binary);
+        nodesText.assign(istreambuf_iterator<char>(nodes), istreambuf_iterator<char>());
+    }
+
+    void TearDown() override
+    {
+        remove(ZIP_FILE.c_str());
+        remove(GZIP_FILE.c_str());
+        remove(EDGES_FILE.c_str());
+    }
+
+    static string bytes(const vector<unsigned char> &data)
+    {
+        return string(data.begin(), data.end());
+    }
+
+    static void appendLittleEndian(string &out, uint32_t value, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    static void writeFile(const string &fileName, const string &contents)
+    {
+        ofstream file(fileName, ios::binary);
+        file << contents;
+    }
+
+    static void writeZip(const string &fileName, const vector<ZipEntry> &entries)
+    {
+        string archive, centralDirectory;
+        for (const ZipEntry &entry : entries)
+        {
+            string fields;
+            appendLittleEndian(fields, 20, 2);
+            appendLittleEndian(fields, 0, 2);
+            appendLittleEndian(fields, entry.method, 2);
+            appendLittleEndian(fields, 0, 4); // time and date
+            appendLittleEndian(fields, crc32(entry.contents.data(), entry.contents.size()), 4);
+            appendLittleEndian(fields, entry.data.size(), 4);
+            appendLittleEndian(fields, entry.contents.size(), 4);
+            appendLittleEndian(fields, entry.name.size(), 2);
+            appendLittleEndian(fields, 0, 2);
+
+            appendLittleEndian(centralDirectory, 0x02014b50, 4);
+            appendLittleEndian(centralDirectory, 20, 2);
+            centralDirectory += fields + string(10, '\0'); // comment length, disk, attributes
+            appendLittleEndian(centralDirectory, archive.size(), 4);
+            centralDirectory += entry.name;
+
+            appendLittleEndian(archive, 0x04034b50, 4);
+            archive += fields + entry.name + entry.data;
+        }
+
+        size_t directoryStart = archive.size();
+        archive += centralDirectory;
+        appendLittleEndian(archive, 0x06054b50, 4);
+        appendLittleEndian(archive, 0, 4);
+        appendLittleEndian(archive, entries.size(), 2);
+        appendLittleEndian(archive, entries.size(), 2);
+        appendLittleEndian(archive, centralDirectory.size(), 4);
+        appendLittleEndian(archive, directoryStart, 4);
+        appendLittleEndian(archive, 0, 2);
+        writeFile(fileName, archive);
+    }
+
+    static string gzipMember(const string &deflated, const string &contents)
+    {
+        string member("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03", 10);
+        member += deflated;
+        appendLittleEndian(member, crc32(contents.data(), contents.size()), 4);
+        appendLittleEndian(member, contents.size(), 4);
+        return member;
+    }
+
+    string edgesText;
+    string nodesText;
+};
+
+// Test: stored, fixed and dynamic blocks decompress to the original text
+TEST_F(InputFileTest, Inflate)
+{
+    vector<char> out;
+    string dynamicStream = bytes(DYNAMIC_STREAM);
+    EXPECT_EQ(inflate(Span<const char>(dynamicStream.data(), dynamicStream.size()), out), dynamicStream.size());
+    EXPECT_EQ(string(out.begin(), out.end()), edgesText);
+
+    out.clear();
+    string fixedStream = bytes(FIXED_STREAM);
+    inflate(Span<const char>(fixedStream.data(), fixedStream.size()), out);
+    EXPECT_EQ(string(out.begin(), out.end()), "abcabcabcabc hello hello\n");
+
+    out.clear();
+    string storedStream = string("\x01\x05\x00\xfa\xff", 5) + "hello";
+    inflate(Span<const char>(storedStream.data(), storedStream.size()), out);
+    EXPECT_EQ(string(out.begin(), out.end()), "hello");
+
+    // truncated and corrupt streams are rejected
+    EXPECT_THROW(inflate(Span<const char>(dynamicStream.data(), dynamicStream.size() - 3), out), runtime_error);
+    storedStream[3] = 0;
+    EXPECT_THROW(inflate(Span<const char>(storedStream.data(), storedStream.size()), out), runtime_error);
+}
+
+// Test: graphs load straight from stored and deflated zip entries
+TEST_F(InputFileTest, ZipEntries)
+{
+    writeZip(ZIP_FILE, {{"edges.txt", 8, bytes(DYNAMIC_STREAM), edgesText}, {"cornell/nodes.txt", 0, nodesText, nodesText}});
+
+    ZipArchive archive(ZIP_FILE);
+    EXPECT_EQ(archive.entryNames(), vector<string>({"edges.txt", "cornell/nodes.txt"}));
+    InputFile entry(ZIP_FILE + "!/edges.txt");
+    ASSERT_TRUE(entry.isOpen());
+    EXPECT_EQ(string(entry.contents().begin(), entry.contents().end()), edgesText);
+
+    EXPECT_FALSE(InputFile(ZIP_FILE + "!/missing.txt").isOpen());
+    EXPECT_FALSE(InputFile("missing.zip!/edges.txt").isOpen());
+
+    writeFile(EDGES_FILE, edgesText);
+    Graph expected(NODES_FILE, EDGES_FILE);
+    Graph fromZip(ZIP_FILE + "!/cornell/nodes.txt", ZIP_FILE + "!/edges.txt");
+    EXPECT_EQ(fromZip.getEdges(), expected.getEdges());
+    EXPECT_EQ(fromZip.getNodes(), expected.getNodes());
+    EXPECT_EQ(fromZip.getFeatureCount(), expected.getFeatureCount());
+
+    // entries are checked against their checksum
+    writeZip(ZIP_FILE, {{"edges.txt", 0, "0 1\n", "0 2\n"}});
+    EXPECT_THROW(InputFile(ZIP_FILE + "!/edges.txt"), runtime_error);
+}
+
+// Test: gzip files, also of several members, are decompressed
+TEST_F(InputFileTest, Gzip)
+{
+    string fixedText = "abcabcabcabc hello hello\n";
+    writeFile(GZIP_FILE, gzipMember(bytes(DYNAMIC_STREAM), edgesText) + gzipMember(bytes(FIXED_STREAM), fixedText));
+
+    InputFile input(GZIP_FILE);
+    ASSERT_TRUE(input.isOpen());
+    EXPECT_EQ(string(input.contents().begin(), input.contents().end()), edgesText + fixedText);
+
+    writeFile(GZIP_FILE, gzipMember(bytes(DYNAMIC_STREAM), edgesText));
+    Graph graph(NODES_FILE, GZIP_FILE);
+    EXPECT_TRUE(graph.isEdge(3, 21));
+
+    writeFile(GZIP_FILE, gzipMember(bytes(DYNAMIC_STREAM), edgesText + "x"));
+    EXPECT_THROW(InputFile{GZIP_FILE}, runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -26,6 +26,42 @@ protected:
         graph.reset();
     }
 
+    // Runs KNN with the given parameters on a fresh copy of the graph
+    static shared_ptr<Graph> runOnCopy(const map<string, double> &params)
+    {
+        auto copy = make_shared<Graph>(NODES_FILE, EDGE_FILE);
+        KNN knn(copy);
+        knn.configure(params);
+        knn.run();
+        return copy;
+    }
+
+    // Checks that two graphs hold bit-identical features, missing in the same places
+    static void expectSameFeatures(const Graph &expected, const Graph &actual)
+    {
+        for (int node : expected.getNodes())
+        {
+            Span<const double> expectedRow = expected.featureRowById(node);
+            Span<const double> actualRow = actual.featureRowById(node);
+            for (size_t i = 0; i < expectedRow.size(); i++)
+            {
+                EXPECT_TRUE(actualRow[i] == expectedRow[i] || (isnan(actualRow[i]) && isnan(expectedRow[i]))) << "node " << node << ", column " << i;
+            }
+        }
+    }
+
+    // Checks that every feature of a graph is filled
+    static void expectNoMissingFeatures(const Graph &filled)
+    {
+        for (int node : filled.getNodes())
+        {
+            for (double feature : filled.featureRowById(node))
+            {
+                EXPECT_FALSE(isnan(feature)) << "node " << node;
+            }
+        }
+    }
+
     shared_ptr<Graph> graph;
 };
 
@@ -58,6 +94,53 @@ TEST_F(KNNTest, EstimateFeaturesFillsMissingValuesThroughRun)
     }
 }
 
+// Test if the parallel BFS fills the same features regardless of the thread count
+TEST_F(KNNTest, SameResultForAnyThreadCount)
+{
+    expectSameFeatures(*runOnCopy({{"k", 5}, {"threads", 1}}), *runOnCopy({{"k", 5}, {"threads", 3}}));
+}
+
+// Test if columns without any known value stay missing while the other columns are still filled
+TEST_F(KNNTest, UnknownColumnStaysMissing)
+{
+    for (int node : graph->getNodes())
+    {
+        vector<double> features = graph->getFeatureById(node);
+        features[0] = NAN;
+        graph->updateFeatureById(node, features);
+    }
+
+    KNN knn(graph);
+    knn.configure({{"k", 3}, {"maxIterations", 1000}});
+    knn.run();
+
+    for (int node : graph->getNodes())
+    {
+        Span<const double> features = graph->featureRowById(node);
+        EXPECT_TRUE(isnan(features[0]));
+        for (size_t i = 1; i < features.size(); i++)
+        {
+            EXPECT_FALSE(isnan(features[i]));
+        }
+    }
+}
+
+// Test if the Jacobi mode fills all missing values bit-identically for any thread count
+TEST_F(KNNTest, JacobiIsDeterministic)
+{
+    shared_ptr<Graph> expected = runOnCopy({{"k", 3}, {"jacobi", 1}, {"threads", 1}});
+    expectNoMissingFeatures(*expected);
+    expectSameFeatures(*expected, *runOnCopy({{"k", 3}, {"jacobi", 1}, {"threads", 4}}));
+}
+
+// Test if the fused mode fills all missing values, independent of the thread count
+TEST_F(KNNTest, FusedFillsMissingValues)
+{
+    shared_ptr<Graph> expected = runOnCopy({{"k", 3}, {"fused", 1}, {"threads", 1}});
+    expectNoMissingFeatures(*expected);
+    expectSameFeatures(*expected, *runOnCopy({{"k", 3}, {"fused", 1}, {"threads", 4}}));
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
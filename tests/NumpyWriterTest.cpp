@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "NumpyWriter.hpp"
+#include "Checksum.hpp"
+#include "Graph.hpp"
+#include "KNN.hpp"
+#include "StrategyRunner.hpp"
+
+using namespace std;
+
+const string NODES_FILE = "../input/cornell/cornell_mcar_0.5.txt";
+const string EDGE_FILE = "../input/cornell/cornell_edges.txt";
+
+// Fixture class for NumpyWriter testing
+class NumpyWriterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        graph = make_shared<Graph>(NODES_FILE, EDGE_FILE);
+
+        // a directory of its own per test, so an aborted test leaves nothing in the working directory
+        outputDirectory = filesystem::temp_directory_path() / ("numpy_writer_test_" + string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        filesystem::remove_all(outputDirectory);
+        filesystem::create_directories(outputDirectory);
+        prefix = (outputDirectory / "numpy_writer_test").string();
+    }
+
+    void TearDown() override
+    {
+        filesystem::remove_all(outputDirectory);
+    }
+
+    static string readFile(const string &fileName)
+    {
+        ifstream file(fileName, ios::binary);
+        return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+
+    static uint32_t readUint32(const string &bytes, size_t position)
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < 4; i++)
+        {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[position + i])) << (8 * i);
+        }
+        return value;
+    }
+
+    // checks the header of an .npy file and returns where its data starts
+    static size_t checkNpyHeader(const string &bytes, const string &descr, const string &shape)
+    {
+        EXPECT_EQ(bytes.substr(0, 8), string("\x93NUMPY\x01\x00", 8));
+        size_t headerSize = static_cast<unsigned char>(bytes[8]) | static_cast<unsigned char>(bytes[9]) << 8;
+        size_t dataStart = 10 + headerSize;
+        EXPECT_EQ(dataStart % 64, 0u);
+        EXPECT_EQ(bytes[dataStart - 1], '\n');
+        string dictionary = bytes.substr(10, headerSize);
+        EXPECT_NE(dictionary.find("'descr': '" + descr + "'"), string::npos) << dictionary;
+        EXPECT_NE(dictionary.find("'fortran_order': False"), string::npos) << dictionary;
+        EXPECT_NE(dictionary.find("'shape': " + shape), string::npos) << dictionary;
+        return dataStart;
+    }
+
+    shared_ptr<Graph> graph;
+    filesystem::path outputDirectory;
+    string prefix; ///< path prefix of the written files inside outputDirectory
+};
+
+// Test: .npy files hold the raw arrays in slot order, including NaN for missing features
+TEST_F(NumpyWriterTest, SaveNpy)
+{
+    StrategyRunner<KNN> runner(graph);
+    runner.saveNpy(graph, prefix);
+
+    size_t nodeCount = graph->getNodeCount();
+    size_t featureCount = graph->getFeatureCount();
+
+    string features = readFile(prefix + "_features.npy");
+    size_t dataStart = checkNpyHeader(features, "<f8", "(" + to_string(nodeCount) + ", " + to_string(featureCount) + ")");
+    ASSERT_EQ(features.size() - dataStart, nodeCount * featureCount * sizeof(double));
+    EXPECT_EQ(memcmp(features.data() + dataStart, graph->featureRow(0).data(), features.size() - dataStart), 0);
+
+    string nodeIds = readFile(prefix + "_node_ids.npy");
+    dataStart = checkNpyHeader(nodeIds, "<i4", "(" + to_string(nodeCount) + ",)");
+    ASSERT_EQ(nodeIds.size() - dataStart, nodeCount * sizeof(int32_t));
+    EXPECT_EQ(readUint32(nodeIds, dataStart + 5 * sizeof(int32_t)), static_cast<uint32_t>(graph->getIdBySlot(5)));
+
+    string labels = readFile(prefix + "_labels.npy");
+    dataStart = checkNpyHeader(labels, "<i4", "(" + to_string(nodeCount) + ",)");
+    EXPECT_EQ(readUint32(labels, dataStart + 5 * sizeof(int32_t)), static_cast<uint32_t>(graph->getLabelById(graph->getIdBySlot(5))));
+
+    // kNN doesn't learn embeddings
+    EXPECT_THROW(runner.saveNpy(graph, prefix, true), logic_error);
+}
+
+// Test: embeddings are aligned with the node IDs and NaN for nodes without one
+TEST_F(NumpyWriterTest, Embeddings)
+{
+    unordered_map<int, vector<double>> embeddings = {{graph->getIdBySlot(0), {1.0, 2.0}}, {graph->getIdBySlot(2), {3.0, 4.0}}};
+    NumpyGraphExport numpyExport(*graph);
+    numpyExport.addEmbeddings(embeddings);
+
+    vector<NumpyArray> arrays = numpyExport.arrays();
+    ASSERT_EQ(arrays.size(), 4u);
+    EXPECT_EQ(arrays[3].name, "embeddings");
+    EXPECT_EQ(arrays[3].shape, vector<size_t>({static_cast<size_t>(graph->getNodeCount()), 2}));
+
+    const double *values = static_cast<const double *>(arrays[3].data);
+    EXPECT_EQ(values[0], 1.0);
+    EXPECT_EQ(values[5], 4.0);
+    EXPECT_TRUE(isnan(values[2]) && isnan(values[3]));
+}
+
+// Test: the .npz archive is a valid stored zip with one checksummed .npy per array
+TEST_F(NumpyWriterTest, SaveNpz)
+{
+    StrategyRunner<KNN> runner(graph);
+    runner.saveNpz(graph, prefix + ".npz");
+    runner.saveNpy(graph, prefix);
+    string archive = readFile(prefix + ".npz");
+
+    // end of central directory
+    size_t end = archive.size() - 22;
+    ASSERT_EQ(readUint32(archive, end), 0x06054b50u);
+    EXPECT_EQ(readUint32(archive, end + 8) & 0xFFFF, 3u);
+
+    size_t position = 0;
+    for (const char *name : {"node_ids", "features", "labels"})
+    {
+        ASSERT_EQ(readUint32(archive, position), 0x04034b50u);
+        uint32_t crc = readUint32(archive, position + 14);
+        uint32_t size = readUint32(archive, position + 18);
+        size_t nameSize = readUint32(archive, position + 26) & 0xFFFF;
+        EXPECT_EQ(archive.substr(position + 30, nameSize), string(name) + ".npy");
+
+        // entries are the same bytes as the single .npy files
+        string entry = archive.substr(position + 30 + nameSize, size);
+        EXPECT_EQ(entry, readFile(prefix + "_" + name + ".npy"));
+        EXPECT_EQ(crc32(entry.data(), entry.size()), crc);
+        position += 30 + nameSize + size;
+    }
+    EXPECT_EQ(readUint32(archive, position), 0x02014b50u); // central directory follows the entries
+    EXPECT_EQ(readUint32(archive, end + 16), position);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}